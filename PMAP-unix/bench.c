@@ -0,0 +1,437 @@
+#define _XOPEN_SOURCE 700
+#define _DEFAULT_SOURCE
+
+#include <errno.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <termios.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <signal.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+#include "../base/platform.h"
+#include "../base/mecha.h"
+#include "../base/eeprom.h"
+#include "../base/updates.h"
+#include "../base/elect.h"
+
+/*  Benchmarks for the host-side overhead of PMAP.
+    Microbenchmarks run in-process. The end-to-end flows run against a MECHACON stand-in on a pseudo-terminal,
+    which replies like a console would over a 57600 baud link (8N1), but without any processing time of its own.
+    So the time beyond the line time of a flow is spent by PMAP (and the pseudo-terminal). The ELECT flow also includes
+    its fixed waits, which are the same in every revision.
+
+    Syntax: pmap-bench [<results file> [<revision>]]
+    The results are appended to the results file (default: bench_results.jsonl), one JSON object per benchmark.
+    Messages from PMAP itself go to pmap-bench.log. */
+
+#define BENCH_BAUD        57600
+#define BENCH_BYTE_NS     (10 * 1000000000ull / BENCH_BAUD)
+#define BENCH_MICRO_NS    200000000ull // Minimum duration of a microbenchmark
+#define BENCH_INIT_RUNS   5
+#define BENCH_RESTORE_OFF 32 // Words that differ from the image, for the differential restore.
+#define BENCH_PROMPTS     1024
+#define BENCH_LINE_MAX    64
+
+extern unsigned char ElectConIsT10K;
+
+// Shared with the stand-in process.
+static struct BenchStandIn
+{
+    unsigned char paced;
+    u32 commands;
+    unsigned long long bytes; // Sent in both directions
+    u16 eeprom[0x200];
+} *StandIn;
+
+static FILE *results, *summary;
+static const char *revision;
+static char StartTime[24];
+static pid_t StandInPid;
+
+static unsigned long long BenchNow(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static void BenchSleep(unsigned long long ns)
+{
+    struct timespec ts;
+
+    ts.tv_sec  = ns / 1000000000ull;
+    ts.tv_nsec = ns % 1000000000ull;
+    while (nanosleep(&ts, &ts) != 0 && errno == EINTR)
+        ;
+}
+
+static const char *BenchStandInReply(char *reply, int size, unsigned short int command, const char *args)
+{
+    unsigned int word, data;
+
+    switch (command)
+    {
+        case MECHA_CMD_EEPROM_READ:
+            word = strtoul(args, NULL, 16) & 0x1FF;
+            snprintf(reply, size, "0%.4s%04x", args, StandIn->eeprom[word]);
+            return reply;
+        case MECHA_CMD_EEPROM_WRITE:
+            if (sscanf(args, "%4x%4x", &word, &data) == 2)
+                StandIn->eeprom[word & 0x1FF] = (u16)data;
+            snprintf(reply, size, "0%s", args);
+            return reply;
+        case 0xcfd:
+            return "000c10024";
+        case 0xcfc:
+            return "000080304";
+        case 0xc9a:
+            return "000";
+        case 0xce4:
+            return "0000102030405060708";
+        case 0xcd3:
+            return "020";
+        case 0xce9:
+            return "00100";
+        case 0xcdf:
+            return "00000";
+        case 0xc16:
+            return "015";
+        default:
+            return "0";
+    }
+}
+
+static void BenchStandInRun(int master)
+{
+    // A reply echoes at most a whole line after its status digit, and then gets CR/LF.
+    char line[BENCH_LINE_MAX], reply[1 + BENCH_LINE_MAX], out[1 + BENCH_LINE_MAX + 2];
+    const char *text;
+    unsigned short int command;
+    int length, size;
+
+    length = 0;
+    while (read(master, &line[length], 1) == 1)
+    {
+        if (length < BENCH_LINE_MAX - 1)
+            length++;
+        if (length < 2 || line[length - 2] != '\r' || line[length - 1] != '\n')
+            continue;
+
+        line[length - 2] = '\0';
+        command          = (unsigned short int)strtoul((char[4]){line[0], line[1], line[2], '\0'}, NULL, 16);
+        text             = BenchStandInReply(reply, sizeof(reply), command, length > 5 ? &line[3] : "");
+        size             = snprintf(out, sizeof(out), "%s\r\n", text);
+
+        StandIn->commands++;
+        StandIn->bytes += length + size;
+        if (StandIn->paced)
+            BenchSleep((unsigned long long)(length + size) * BENCH_BYTE_NS);
+        if (write(master, out, size) != size)
+            break;
+        length = 0;
+    }
+    _exit(0);
+}
+
+// Starts the stand-in, returning the name of the pseudo-terminal for PlatOpenCOMPort().
+static const char *BenchStandInStart(void)
+{
+    static char device[64];
+    struct termios options;
+    int master, slave, i;
+
+    StandIn = mmap(NULL, sizeof(*StandIn), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (StandIn == MAP_FAILED)
+        return NULL;
+    for (i = 0; i < 0x200; i++)
+        StandIn->eeprom[i] = 0x0300;
+
+    if ((master = posix_openpt(O_RDWR | O_NOCTTY)) < 0 || grantpt(master) != 0 || unlockpt(master) != 0)
+        return NULL;
+    strncpy(device, ptsname(master), sizeof(device) - 1);
+
+    // Raw from the start, or the line discipline would translate the CR of each reply.
+    if ((slave = open(device, O_RDWR | O_NOCTTY)) < 0 || tcgetattr(slave, &options) != 0)
+        return NULL;
+    cfmakeraw(&options);
+    tcsetattr(slave, TCSANOW, &options);
+
+    fflush(NULL);
+    if ((StandInPid = fork()) == 0)
+    {
+        close(slave);
+        BenchStandInRun(master);
+    }
+    close(master);
+
+    return StandInPid > 0 ? device : NULL;
+}
+
+static void BenchResultStart(const char *name, const char *kind)
+{
+    fprintf(results, "{\"revision\":\"%s\",\"time\":\"%s\",\"bench\":\"%s\",\"kind\":\"%s\",", revision, StartTime, name, kind);
+}
+
+static void BenchMicroReport(const char *name, unsigned long long ops, unsigned long long ns)
+{
+    BenchResultStart(name, "micro");
+    fprintf(results, "\"ops\":%llu,\"ns_per_op\":%.2f}\n", ops, (double)ns / ops);
+    fprintf(summary, "%-28s %12.2f ns/op   (%llu ops)\n", name, (double)ns / ops, ops);
+}
+
+static void BenchFlowReport(const char *name, unsigned int runs, unsigned long long ns, u32 commands, unsigned long long bytes, int result)
+{
+    double wall, line, host;
+
+    wall = (double)ns / runs / 1e6;
+    line = (double)(bytes * BENCH_BYTE_NS) / runs / 1e6;
+    host = wall - line;
+    BenchResultStart(name, "e2e");
+    fprintf(results, "\"runs\":%u,\"result\":%d,\"commands\":%u,\"wall_ms\":%.3f,\"line_ms\":%.3f,\"host_ms\":%.3f,\"host_us_per_command\":%.2f}\n",
+            runs, result, commands / runs, wall, line, host, commands > 0 ? host * 1000 * runs / commands : 0.0);
+    fprintf(summary, "%-28s %12.1f ms wall, %9.1f ms line, %8.1f ms host (%u commands, result %d)\n", name, wall, line, host, commands / runs, result);
+}
+
+static void BenchCommandAdd(void)
+{
+    unsigned long long start, ns, ops;
+    int i;
+
+    start = BenchNow();
+    ops   = 0;
+    do
+    {
+        for (i = 0; i < MAX_MECHA_TASKS; i++)
+            MechaCommandAdd(MECHA_CMD_EEPROM_READ, "0010", i + 1, 0, MECHA_TASK_NORMAL_TO, "EEPROM READ");
+        MechaCommandListClear();
+        ops += MAX_MECHA_TASKS;
+    } while ((ns = BenchNow() - start) < BENCH_MICRO_NS);
+
+    BenchMicroReport("mecha_command_add", ops, ns);
+}
+
+static void BenchEEPMap(void)
+{
+    volatile u16 sink;
+    unsigned long long start, ns, ops;
+    u16 word;
+
+    start = BenchNow();
+    ops   = 0;
+    do
+    {
+        for (word = 0; word < 0x200; word++)
+            EEPMapWrite(word, word);
+        ops += 0x200;
+    } while ((ns = BenchNow() - start) < BENCH_MICRO_NS);
+    BenchMicroReport("eepmap_write", ops, ns);
+
+    start = BenchNow();
+    ops   = 0;
+    do
+    {
+        for (word = 0; word < 0x200; word++)
+            sink = EEPMapRead(word);
+        ops += 0x200;
+    } while ((ns = BenchNow() - start) < BENCH_MICRO_NS);
+    (void)sink;
+    BenchMicroReport("eepmap_read", ops, ns);
+}
+
+// Builds the update command list from the EEPROM map of the stand-in, which MechaInitModel() has read.
+static void BenchUpdateDiff(const char *name, int chassis)
+{
+    unsigned long long start, ns, ops;
+
+    start = BenchNow();
+    ops   = 0;
+    do
+    {
+        MechaUpdateChassis(chassis, 0, 0, MechaGetLens(), MechaGetOP());
+        MechaCommandListClear();
+        ops++;
+    } while ((ns = BenchNow() - start) < BENCH_MICRO_NS);
+
+    BenchMicroReport(name, ops, ns);
+}
+
+// Send, receive and decode, with a stand-in that answers at once.
+static void BenchRoundTrip(void)
+{
+    unsigned long long start, ns, ops;
+    u16 data;
+
+    StandIn->paced = 0;
+    start          = BenchNow();
+    ops            = 0;
+    do
+    {
+        EEPROMReadWord((u16)(ops & 0x1FF), &data);
+        ops++;
+    } while ((ns = BenchNow() - start) < BENCH_MICRO_NS);
+    StandIn->paced = 1;
+
+    BenchMicroReport("eeprom_read_unpaced", ops, ns);
+}
+
+static u32 BenchCommands;
+static unsigned long long BenchBytes, BenchStart;
+
+static void BenchFlowStart(void)
+{
+    BenchCommands = StandIn->commands;
+    BenchBytes    = StandIn->bytes;
+    BenchStart    = BenchNow();
+}
+
+static void BenchFlowEnd(const char *name, unsigned int runs, int result)
+{
+    unsigned long long ns;
+
+    ns = BenchNow() - BenchStart;
+    BenchFlowReport(name, runs, ns, StandIn->commands - BenchCommands, StandIn->bytes - BenchBytes, result);
+}
+
+static void BenchInitModel(void)
+{
+    int i, result;
+
+    BenchFlowStart();
+    for (i = 0, result = 0; i < BENCH_INIT_RUNS && result == 0; i++)
+    {
+        MechaInvalidateModel();
+        result = MechaInitModel();
+    }
+    BenchFlowEnd("init_model", BENCH_INIT_RUNS, result);
+}
+
+static void BenchDump(u16 *image)
+{
+    int result;
+    u16 word;
+
+    BenchFlowStart();
+    for (word = 0, result = 0; word < 0x200 && result == 0; word++)
+        result = EEPROMReadWord(word, &image[word]);
+    BenchFlowEnd("eeprom_dump", 1, result);
+}
+
+// Restores an image by only writing the words that differ, after reading the whole EEPROM.
+static void BenchDiffRestore(const u16 *image)
+{
+    int result, i;
+    u16 word, data;
+
+    for (i = 0; i < BENCH_RESTORE_OFF; i++)
+        StandIn->eeprom[(i * 37) & 0x1FF] ^= 0x5A5A;
+
+    BenchFlowStart();
+    for (word = 0, result = 0; word < 0x200 && result == 0; word++)
+    {
+        if ((result = EEPROMReadWord(word, &data)) == 0 && data != image[word])
+            result = EEPROMWriteWord(word, image[word]);
+    }
+    BenchFlowEnd("eeprom_restore_diff", 1, result);
+}
+
+// Operator prompts are answered at once, from a pipe full of ENTERs.
+static void BenchElect(void)
+{
+    char prompts[BENCH_PROMPTS];
+    int fds[2], result;
+
+    memset(prompts, '\n', sizeof(prompts));
+    if (pipe(fds) != 0 || write(fds[1], prompts, sizeof(prompts)) != sizeof(prompts))
+        return;
+    dup2(fds[0], STDIN_FILENO);
+    close(fds[0]);
+    setvbuf(stdin, NULL, _IONBF, 0); // select() on the prompts must see what is left.
+
+    ElectConIsT10K = 0;
+    BenchFlowStart();
+    result = ElectAutoAdjust(ELECT_STAGE_CD);
+    BenchFlowEnd("elect", 1, result);
+    close(fds[1]);
+}
+
+// ELECT leaves its records and checkpoints in the working directory, so the flows run in a scratch directory.
+static void BenchRemoveDir(const char *path)
+{
+    char name[512];
+    struct dirent *entry;
+    DIR *dir;
+
+    if ((dir = opendir(path)) != NULL)
+    {
+        while ((entry = readdir(dir)) != NULL)
+        {
+            if (strcmp(entry->d_name, ".") && strcmp(entry->d_name, ".."))
+            {
+                snprintf(name, sizeof(name), "%s/%s", path, entry->d_name);
+                remove(name);
+            }
+        }
+        closedir(dir);
+    }
+    rmdir(path);
+}
+
+int main(int argc, char *argv[])
+{
+    char scratch[] = "/tmp/pmap-bench.XXXXXX", home[512];
+    const char *device;
+    u16 image[0x200];
+    time_t now;
+
+    revision = argc >= 3 ? argv[2] : "unknown";
+    if ((results = fopen(argc >= 2 ? argv[1] : "bench_results.jsonl", "a")) == NULL || (summary = fdopen(dup(STDERR_FILENO), "w")) == NULL)
+    {
+        fprintf(stderr, "Cannot open the results file.\n");
+        return EIO;
+    }
+    setvbuf(summary, NULL, _IONBF, 0);
+    time(&now);
+    strftime(StartTime, sizeof(StartTime), "%Y-%m-%dT%H:%M:%S", localtime(&now));
+
+    if (freopen("pmap-bench.log", "w", stdout) == NULL || dup2(STDOUT_FILENO, STDERR_FILENO) < 0)
+        return EIO;
+    if (getcwd(home, sizeof(home)) == NULL || mkdtemp(scratch) == NULL || chdir(scratch) != 0)
+        return EIO;
+
+    fprintf(summary, "PMAP benchmark (revision %s)\n", revision);
+    BenchCommandAdd();
+    BenchEEPMap();
+
+    if ((device = BenchStandInStart()) == NULL || PlatOpenCOMPort(device) != 0)
+    {
+        fprintf(summary, "Cannot start the MECHACON stand-in.\n");
+        return ENODEV;
+    }
+    StandIn->paced = 1;
+
+    BenchInitModel();
+    BenchUpdateDiff("update_diff_b", MECHA_CHASSIS_MODEL_B);
+    BenchUpdateDiff("update_diff_h", MECHA_CHASSIS_MODEL_H);
+    BenchRoundTrip();
+    BenchDump(image);
+    BenchDiffRestore(image);
+    BenchElect();
+
+    PlatCloseCOMPort();
+    kill(StandInPid, SIGTERM);
+    waitpid(StandInPid, NULL, 0);
+
+    if (chdir(home) != 0)
+        return EIO;
+    BenchRemoveDir(scratch);
+    fclose(results);
+
+    return 0;
+}
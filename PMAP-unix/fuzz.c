@@ -0,0 +1,417 @@
+#define _DEFAULT_SOURCE
+
+#include <errno.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include <dirent.h>
+#include <unistd.h>
+
+#include "../base/platform.h"
+#include "../base/mecha.h"
+#include "../base/eeprom.h"
+#include "../base/elect.h"
+#include "../base/main.h"
+
+/*  Fuzzing harness for the reply handlers and parsers.
+    This replaces the platform layer with an in-memory transport: every command that is sent is answered with the next line
+    of the input (a CR/LF is appended), and once the input is used up, commands time out. The first byte of the input selects
+    the flow that is run, so that each set of Rx handlers is reached through MechaCommandExecuteList() as in a real session.
+    Operator prompts are acknowledged immediately and waits take no time.
+
+    Built for libFuzzer by default. With -DFUZZ_STANDALONE, each file given (or stdin) is run once instead, e.g. for AFL
+    or to reproduce a crash. Files written by a flow (ELECT results and checkpoints) go to a scratch directory.
+    Inputs that found a crash are kept in fuzz-corpus, which "make fuzz" starts from. */
+
+#define FUZZ_LINE_MAX 64
+#define FUZZ_TEXT_MAX 512
+
+extern unsigned char ElectConIsT10K;
+
+enum FUZZ_FLOW
+{
+    FUZZ_FLOW_PROBE = 0, // Identification, EEPROM map and RTC (InitRxHandler)
+    FUZZ_FLOW_EEPROM,    // Serial number, model name and EEPROM status, then direct EEPROM reads and writes
+    FUZZ_FLOW_ELECT,     // Automatic ELECT adjustment (the judges)
+    FUZZ_FLOW_MECHA,     // MECHA diagnostics, from a script (MechaAdjRxHandler() and the scan, tilt and jitter handlers)
+
+    FUZZ_FLOW_COUNT
+};
+
+static struct FuzzTransport
+{
+    const unsigned char *input;
+    size_t size, pos;
+    char reply[FUZZ_LINE_MAX + 2];
+    int length, read;
+    u32 ticks;
+} transport;
+
+static char ScratchDir[] = "/tmp/pmap-fuzz-XXXXXX";
+
+/*  Scripts for FUZZ_FLOW_MECHA, chosen by the rest of the first byte. A script stops at the first command that fails,
+    so each one is kept short. The last one uses the MECHA test commands. */
+static const char *const FuzzScripts[] = {
+    "INIT CD\nPLAY 1\nERROR CD\nJITTER 256\nSTOP\n",
+    "INIT DVD-SL\nPLAY 1\nTILT SEARCH 8\nERROR DVD\nSTOP\n",
+    "INIT CD\nPLAY 1\nSLED SCAN 4 2 scan.csv\nSTOP\n",
+    "INIT DVD-DL\nPLAY FJ\nJITTER 16 STREAM jitter.csv\nPAUSE\nSTOP\n",
+    "SLED HOME\nTRAY OPEN\nTRAY IN-SW\nTRAY OUT-SW\nSLED IN-SW\nENDURANCE 2 50 endurance.csv\n",
+    "DISC CD\nLASER ON\nSERVO AUTO\nPLAY 1x\nPLAY FWD\nSPIND KICK\nLASER OFF\nDISC AUTO\n",
+};
+
+#define FUZZ_SCRIPTS (sizeof(FuzzScripts) / sizeof(FuzzScripts[0]))
+
+int PlatOpenCOMPort(const char *device)
+{
+    (void)device;
+    return 0;
+}
+
+// The next line of the input becomes the reply to the command that was just sent.
+int PlatWriteCOMPort(const char *data)
+{
+    transport.length = 0;
+    transport.read   = 0;
+    if (transport.pos < transport.size)
+    {
+        while (transport.pos < transport.size && transport.input[transport.pos] != '\n' && transport.length < FUZZ_LINE_MAX)
+            transport.reply[transport.length++] = (char)transport.input[transport.pos++];
+        while (transport.pos < transport.size && transport.input[transport.pos++] != '\n') // Longer lines are cut.
+            ;
+        transport.reply[transport.length++] = '\r';
+        transport.reply[transport.length++] = '\n';
+    }
+    transport.ticks++;
+
+    return (int)strlen(data);
+}
+
+int PlatReadCOMPort(char *data, int n, unsigned short timeout)
+{
+    int count;
+
+    if (transport.read >= transport.length)
+    { // Nothing left of the reply, so this read times out.
+        transport.ticks += timeout;
+        return 0;
+    }
+
+    count = transport.length - transport.read < n ? transport.length - transport.read : n;
+    memcpy(data, &transport.reply[transport.read], count);
+    transport.read += count;
+
+    return count;
+}
+
+void PlatCloseCOMPort(void)
+{
+}
+
+void PlatSleep(unsigned short int msec)
+{
+    transport.ticks += msec;
+}
+
+u32 PlatGetTicks(void)
+{
+    return transport.ticks;
+}
+
+// Messages are formatted, as their arguments come from the replies too, but not shown.
+static void FuzzFormat(const char *format, va_list args)
+{
+    char text[FUZZ_TEXT_MAX];
+
+    vsnprintf(text, sizeof(text), format, args);
+}
+
+void PlatShowEMessage(const char *format, ...)
+{
+    va_list args;
+
+    va_start(args, format);
+    FuzzFormat(format, args);
+    va_end(args);
+}
+
+void PlatShowMessage(const char *format, ...)
+{
+    va_list args;
+
+    va_start(args, format);
+    FuzzFormat(format, args);
+    va_end(args);
+}
+
+void PlatShowMessageB(const char *format, ...)
+{
+    va_list args;
+
+    va_start(args, format);
+    FuzzFormat(format, args);
+    va_end(args);
+}
+
+int PlatShowMessageBPoll(int (*poll)(void), unsigned short int interval, const char *format, ...)
+{
+    va_list args;
+
+    (void)interval;
+
+    va_start(args, format);
+    FuzzFormat(format, args);
+    va_end(args);
+
+    return poll(); // Polled once, then the operator acknowledges.
+}
+
+int PlatRunStations(int count, char *const devices[], int (*run)(int station, const char *device))
+{
+    (void)count;
+    (void)devices;
+    (void)run;
+    return EINVAL;
+}
+
+int PlatBackgroundPost(int (*work)(const void *data), const void *data, int size)
+{
+    (void)size;
+    return work(data);
+}
+
+int PlatBackgroundFlush(void)
+{
+    return 0;
+}
+
+void PlatDebugInit(void)
+{
+}
+
+void PlatDebugDeinit(void)
+{
+}
+
+void PlatDPrintf(const char *format, ...)
+{
+    va_list args;
+
+    va_start(args, format);
+    FuzzFormat(format, args);
+    va_end(args);
+}
+
+void PlatDLogFrame(int level, unsigned char id, unsigned short int command, const char *frame, int length)
+{
+    (void)level;
+    (void)id;
+    (void)command;
+    (void)frame;
+    (void)length;
+}
+
+int pstricmp(const char *s1, const char *s2)
+{
+    char s1char, s2char;
+
+    for (s1char = *s1, s2char = *s2; *s1 != '\0' && *s2 != '\0'; s1++, s2++, s1char = *s1, s2char = *s2)
+    {
+        if (isalpha(s1char))
+            s1char = toupper(s1char);
+        if (isalpha(s2char))
+            s2char = toupper(s2char);
+        if (s1char != s2char)
+            break;
+    }
+
+    return (s1char - s2char);
+}
+
+int pstrincmp(const char *s1, const char *s2, int len)
+{
+    char s1char, s2char;
+
+    for (s1char = *s1, s2char = *s2; *s1 != '\0' && *s2 != '\0' && len > 0; s1++, s2++, s1char = *s1, s2char = *s2, len--)
+    {
+        if (isalpha(s1char))
+            s1char = toupper(s1char);
+        if (isalpha(s2char))
+            s2char = toupper(s2char);
+        if (s1char != s2char)
+            break;
+    }
+
+    return ((len == 0) ? 0 : s1char - s2char);
+}
+
+// From main.c, for the MECHA diagnostics.
+void DisplayConnHelp(void)
+{
+}
+
+int ProbeConsole(int level)
+{
+    return MechaProbe(level);
+}
+
+static void FuzzCleanScratch(void)
+{
+    const struct dirent *entry;
+    DIR *dir;
+
+    if ((dir = opendir(".")) != NULL)
+    {
+        while ((entry = readdir(dir)) != NULL)
+        {
+            if (entry->d_name[0] != '.')
+                remove(entry->d_name);
+        }
+        closedir(dir);
+    }
+}
+
+static void FuzzRemoveScratch(void)
+{
+    FuzzCleanScratch();
+    if (chdir("/") == 0)
+        rmdir(ScratchDir);
+}
+
+int LLVMFuzzerInitialize(int *argc, char ***argv)
+{
+    (void)argc;
+    (void)argv;
+
+    if (mkdtemp(ScratchDir) == NULL || chdir(ScratchDir) != 0)
+    {
+        perror("pmap-fuzz: cannot create a scratch directory");
+        exit(1);
+    }
+    atexit(&FuzzRemoveScratch);
+
+    return 0;
+}
+
+static void FuzzRunScript(int script)
+{
+    FILE *file;
+
+    if ((file = fopen("fuzz.txt", "w")) == NULL)
+        return;
+    fputs(FuzzScripts[script], file);
+    fclose(file);
+
+    MechaRunScript(script == FUZZ_SCRIPTS - 1, "fuzz.txt");
+}
+
+int LLVMFuzzerTestOneInput(const unsigned char *data, size_t size)
+{
+    u16 word;
+
+    if (size < 1)
+        return 0;
+
+    memset(&transport, 0, sizeof(transport));
+    transport.input = data + 1;
+    transport.size  = size - 1;
+
+    MechaInvalidateModel();
+    MechaCommandListClear();
+
+    switch (data[0] % FUZZ_FLOW_COUNT)
+    {
+        case FUZZ_FLOW_PROBE:
+            MechaProbe(MECHA_PROBE_FULL);
+            break;
+        case FUZZ_FLOW_EEPROM:
+            if (EEPROMInitSerial() == 0 && EEPROMInitModelName() == 0)
+            {
+                EEPROMGetEEPROMStatus();
+                EEPROMGetModelID();
+                EEPROMGetTVSystem();
+            }
+            if (EEPROMReadWord(EEPROM_MAP_CON, &word) == 0)
+                EEPROMWriteWord(EEPROM_MAP_CON, word);
+            break;
+        case FUZZ_FLOW_ELECT:
+            if (MechaInitModel() == 0)
+            {
+                ElectConIsT10K = 0;
+                ElectAutoAdjust(ELECT_STAGE_CD);
+            }
+            FuzzCleanScratch();
+            break;
+        case FUZZ_FLOW_MECHA:
+            FuzzRunScript(data[0] / FUZZ_FLOW_COUNT % FUZZ_SCRIPTS);
+            FuzzCleanScratch();
+            break;
+    }
+
+    MechaCommandListClear();
+
+    return 0;
+}
+
+#ifdef FUZZ_STANDALONE
+static int FuzzRunFile(FILE *file)
+{
+    unsigned char *data = NULL, *grown;
+    size_t size = 0, capacity = 0, count;
+
+    do
+    {
+        if (size == capacity)
+        {
+            capacity = capacity ? capacity * 2 : 4096;
+            if ((grown = realloc(data, capacity)) == NULL)
+            {
+                free(data);
+                return ENOMEM;
+            }
+            data = grown;
+        }
+        count = fread(data + size, 1, capacity - size, file);
+        size += count;
+    } while (count > 0);
+
+    LLVMFuzzerTestOneInput(data, size);
+    free(data);
+
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    char cwd[256], path[512];
+    FILE *file;
+    int i, result;
+
+    // Relative paths are from where the harness was started, not from the scratch directory.
+    if (getcwd(cwd, sizeof(cwd)) == NULL)
+        cwd[0] = '\0';
+    LLVMFuzzerInitialize(&argc, &argv);
+
+    if (argc < 2)
+        return FuzzRunFile(stdin);
+
+    for (i = 1, result = 0; i < argc && result == 0; i++)
+    {
+        if (argv[i][0] == '/')
+            snprintf(path, sizeof(path), "%s", argv[i]);
+        else
+            snprintf(path, sizeof(path), "%s/%s", cwd, argv[i]);
+        if ((file = fopen(path, "rb")) == NULL)
+        {
+            fprintf(stderr, "pmap-fuzz: cannot open %s\n", argv[i]);
+            return ENOENT;
+        }
+        result = FuzzRunFile(file);
+        fclose(file);
+    }
+
+    return result;
+}
+#endif
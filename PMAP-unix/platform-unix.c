@@ -3,47 +3,148 @@
 #include <stdio.h>
 #include <stdarg.h>
 #include <stdlib.h>
+#include <limits.h>
 #include <fcntl.h>
 #include <termios.h>
-#include <dirent.h>
+#include <glob.h>
 #include <unistd.h>
+#include <sys/inotify.h>
 #include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <signal.h>
 #include <time.h>
 #include <ctype.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#ifdef __linux__
+#include <linux/serial.h>
+#endif
 
 #include "../base/platform.h"
 #include "../base/mecha.h"
 
 static int ComPortHandle = -1;
+static char ComPortDevice[PLAT_DEVICE_MAX];
 static unsigned short RxTimeout;
 static FILE *DebugOutputFile = NULL;
+static int StationSocket     = -1; // Connection to the station runner, in a station process.
+static int StationNumber     = 0;
+static struct PlatHandlers Handlers; // Set by an embedding application.
+static int DaemonListener    = -1;
+static int DaemonClient      = -1; // Client of the current job, in a daemon station.
+static volatile sig_atomic_t DaemonStopping;
 
-int PlatOpenCOMPort(const char *device)
+#define STATION_WITHDRAW       '\x04' // Sent by a station whose prompt completed without the operator.
+#define PLAT_STATION_INPUT_MAX 64 // Operator input that has been read, but not answered yet.
+#define PLAT_DAEMON_REQUEST_TO 1000 // ms for a client to send its whole request line.
+
+/*  Debug log. Producers only copy fixed-size records into a ring, from which a background thread formats and writes them,
+    so that writing the log never holds up the serial link. Any thread may produce records: a slot is claimed by advancing head,
+    and becomes visible to the writer once its sequence number is set to one past its position.
+    If the ring is full, records are dropped and counted instead of waiting for the writer. */
+#define LOG_RING_SIZE   4096 // Records, must be a power of 2.
+#define LOG_RECORD_DATA 112
+#define LOG_TEXT_MAX    1024 // Longer messages are formatted into an allocated buffer.
+#define LOG_IDLE_SLEEP  20   // ms
+
+struct LogRecord
 {
-    struct termios options;
+    atomic_uint sequence;
+    u32 ticks;
+    unsigned char level, id;
+    unsigned short int command, length;
+    char data[LOG_RECORD_DATA];
+};
+
+static struct LogRing
+{
+    struct LogRecord records[LOG_RING_SIZE];
+    atomic_uint head, dropped;
+    atomic_int stop;
+    unsigned int tail; // Only used by the writer.
+    pid_t owner;       // The process that runs the writer, which is not inherited by forked processes.
+    pthread_t writer;
+    u32 start;
+} LogRing;
+
+static struct PlatBackground
+{
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    pthread_t thread;
+    pid_t owner; // As for the log ring, the thread is not inherited by forked processes.
+    int (*work)(const void *data);
+    unsigned char pending, stop;
     int result;
+    char data[PLAT_BACKGROUND_DATA_MAX];
+} Background;
 
-    if (ComPortHandle == -1)
+// The serial core lists every port it knows of, but those without a UART have type 0 (PORT_UNKNOWN) and cannot be used.
+static int PlatIsUARTMissing(const char *device)
+{
+    const char *name;
+    char path[PLAT_DEVICE_MAX + 32];
+    FILE *file;
+    int type;
+
+    name = strrchr(device, '/') != NULL ? strrchr(device, '/') + 1 : device;
+    snprintf(path, sizeof(path), "/sys/class/tty/%s/type", name);
+    if ((file = fopen(path, "r")) == NULL)
+        return 0; // Not a serial core port, e.g. a USB adapter.
+    if (fscanf(file, "%d", &type) != 1)
+        type = -1;
+    fclose(file);
+
+    return type == 0;
+}
+
+int PlatListCOMPorts(int count, char *const patterns[], char devices[][PLAT_DEVICE_MAX], int max)
+{
+    static char *const defaults[] = {"/dev/ttyUSB*", "/dev/ttyACM*", "/dev/ttyS*", "/dev/cu.*"};
+    glob_t matches;
+    size_t j;
+    int i, found;
+
+    if (count < 1)
     {
-        // List available serial devices
-        PlatShowMessage("Available serial devices in /dev/:\n");
-        DIR *dir;
-        const struct dirent *entry;
+        count    = sizeof(defaults) / sizeof(defaults[0]);
+        patterns = defaults;
+    }
 
-        dir = opendir("/dev");
-        if (dir != NULL)
+    for (i = 0, found = 0; i < count && found < max; i++)
+    {
+        if (glob(patterns[i], 0, NULL, &matches) != 0)
+            continue;
+        for (j = 0; j < matches.gl_pathc && found < max; j++)
         {
-            while ((entry = readdir(dir)))
-            {
-                if (strncmp(entry->d_name, "cu.", 3) == 0)
-                {
-                    PlatShowMessage("/dev/%s\n", entry->d_name);
-                }
-            }
-            closedir(dir);
+            if (strlen(matches.gl_pathv[j]) < PLAT_DEVICE_MAX && !PlatIsUARTMissing(matches.gl_pathv[j]))
+                strcpy(devices[found++], matches.gl_pathv[j]);
         }
+        globfree(&matches);
+    }
+
+    return found;
+}
+
+int PlatOpenCOMPort(const char *device)
+{
+    char devices[PLAT_MAX_PORTS][PLAT_DEVICE_MAX];
+    struct termios options;
+    int result, i, count;
+
+    if (ComPortHandle == -1)
+    {
+        // List available serial devices
+        PlatShowMessage("Available serial devices:\n");
+        for (i = 0, count = PlatListCOMPorts(0, NULL, devices, PLAT_MAX_PORTS); i < count; i++)
+            PlatShowMessage("%s\n", devices[i]);
 
         PlatShowMessage("Opening COM port: %s\n", device);
+        if (device != ComPortDevice)
+            snprintf(ComPortDevice, sizeof(ComPortDevice), "%s", device);
 
         ComPortHandle = open(device, O_RDWR | O_NOCTTY | O_NDELAY);
 
@@ -180,11 +281,184 @@ void PlatCloseCOMPort(void)
     }
 }
 
+// The device node was removed, or replaced by a new one that the port is not connected to.
+static int PlatIsCOMPortGone(void)
+{
+    struct stat device, port;
+
+    if (stat(ComPortDevice, &device) != 0 || fstat(ComPortHandle, &port) != 0)
+        return 1;
+
+    return device.st_ino != port.st_ino || device.st_rdev != port.st_rdev;
+}
+
+int PlatWatchCOMPort(unsigned short int msec)
+{
+    char directory[PLAT_DEVICE_MAX], events[1024];
+    struct timeval tv;
+    fd_set readfds;
+    int watch;
+
+    snprintf(directory, sizeof(directory), "%s", ComPortDevice);
+    if (strrchr(directory, '/') != NULL)
+        *strrchr(directory, '/') = '\0';
+    else
+        strcpy(directory, ".");
+
+    // Watched before the device is checked, so that nothing can change unnoticed in between.
+    if ((watch = inotify_init1(IN_CLOEXEC)) != -1 && inotify_add_watch(watch, directory, IN_CREATE | IN_DELETE | IN_ATTRIB | IN_MOVED_TO | IN_MOVED_FROM) == -1)
+    {
+        close(watch);
+        watch = -1;
+    }
+
+    if (ComPortHandle != -1 && PlatIsCOMPortGone())
+    {
+        PlatShowMessage("%s is gone.\n", ComPortDevice);
+        PlatCloseCOMPort();
+    }
+
+    if (watch != -1)
+    {
+        FD_ZERO(&readfds);
+        FD_SET(watch, &readfds);
+        tv.tv_sec  = msec / 1000;
+        tv.tv_usec = (msec % 1000) * 1000;
+        if (select(watch + 1, &readfds, NULL, NULL, &tv) > 0 && read(watch, events, sizeof(events)) < 0)
+            PlatDPrintf("PlatWatchCOMPort: cannot read the events.\n");
+        close(watch);
+    }
+    else
+        PlatSleep(msec);
+
+    if (ComPortHandle != -1 && PlatIsCOMPortGone())
+    {
+        PlatShowMessage("%s is gone.\n", ComPortDevice);
+        PlatCloseCOMPort();
+    }
+    if (ComPortHandle == -1 && access(ComPortDevice, F_OK) == 0)
+        PlatOpenCOMPort(ComPortDevice); // Fails while udev is still setting it up, but it is tried again next time.
+    if (ComPortHandle == -1)
+        return ENODEV;
+
+    tcflush(ComPortHandle, TCIFLUSH);
+
+    return 0;
+}
+
+int PlatGetCOMPortErrors(struct PlatCOMPortErrors *errors)
+{
+#ifdef TIOCGICOUNT
+    struct serial_icounter_struct counters;
+
+    if (ComPortHandle == -1)
+        return ENODEV;
+    if (ioctl(ComPortHandle, TIOCGICOUNT, &counters) != 0)
+        return ENOTSUP; // e.g. a USB adapter whose driver does not count them.
+
+    errors->frame   = counters.frame;
+    errors->overrun = counters.overrun + counters.buf_overrun;
+    errors->parity  = counters.parity;
+    errors->brk     = counters.brk;
+
+    return 0;
+#else
+    return ENOTSUP;
+#endif
+}
+
 void PlatSleep(unsigned short int msec)
 {
     usleep((useconds_t)msec * 1000);
 }
 
+u32 PlatGetTicks(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u32)(ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+
+// Text records are written as they are, and a message longer than a record continues in the next ones.
+static void PlatLogPut(unsigned char level, unsigned char id, unsigned short int command, const char *data, int length)
+{
+    struct LogRecord *record;
+    unsigned int pos, sequence;
+    u32 ticks;
+    int part;
+
+    ticks = PlatGetTicks() - LogRing.start;
+    do
+    {
+        part = length < LOG_RECORD_DATA ? length : LOG_RECORD_DATA;
+
+        pos  = atomic_load_explicit(&LogRing.head, memory_order_relaxed);
+        for (;;)
+        {
+            record   = &LogRing.records[pos & (LOG_RING_SIZE - 1)];
+            sequence = atomic_load_explicit(&record->sequence, memory_order_acquire);
+            if (sequence == pos)
+            {
+                if (atomic_compare_exchange_weak_explicit(&LogRing.head, &pos, pos + 1, memory_order_relaxed, memory_order_relaxed))
+                    break;
+            }
+            else if ((int)(sequence - pos) < 0)
+            { // Full: the writer has not taken the record from the previous round yet.
+                atomic_fetch_add_explicit(&LogRing.dropped, 1, memory_order_relaxed);
+                return;
+            }
+            else
+                pos = atomic_load_explicit(&LogRing.head, memory_order_relaxed);
+        }
+
+        record->ticks   = ticks;
+        record->level   = level;
+        record->id      = id;
+        record->command = command;
+        record->length  = (unsigned short int)part;
+        memcpy(record->data, data, part);
+        atomic_store_explicit(&record->sequence, pos + 1, memory_order_release);
+
+        data += part;
+        length -= part;
+    } while (length > 0);
+}
+
+// Formats a message once, for the console (unless console is NULL) and for the debug log.
+static void PlatPrint(FILE *console, unsigned char level, const char *format, va_list args)
+{
+    char buffer[LOG_TEXT_MAX], *text = buffer;
+    va_list copy;
+    int length;
+
+    va_copy(copy, args);
+    length = vsnprintf(buffer, sizeof(buffer), format, copy);
+    va_end(copy);
+    if (length < 0)
+        return;
+    if (length >= (int)sizeof(buffer))
+    {
+        if ((text = malloc(length + 1)) == NULL)
+            return;
+        vsnprintf(text, length + 1, format, args);
+    }
+
+    if (console != NULL && Handlers.message != NULL)
+        Handlers.message(level, text, Handlers.context);
+    else if (console != NULL)
+    {
+        fputs(text, console);
+        if (length > 0 && text[length - 1] != '\n') // e.g. a status line that is redrawn in place.
+            fflush(console);
+    }
+    if (DebugOutputFile != NULL)
+        PlatLogPut(level, 0, 0, text, length);
+
+    if (text != buffer)
+        free(text);
+}
+
 void PlatShowEMessage(const char *format, ...)
 {
     if (format == NULL)
@@ -195,18 +469,10 @@ void PlatShowEMessage(const char *format, ...)
 
     va_list args;
 
-    // Print to standard output
+    // Print to standard output and the debug log
     va_start(args, format);
-    vprintf(format, args);
+    PlatPrint(stdout, PLAT_LOG_ERROR, format, args);
     va_end(args);
-
-    // Print to debug output file, if specified
-    if (DebugOutputFile != NULL)
-    {
-        va_start(args, format);
-        vfprintf(DebugOutputFile, format, args);
-        va_end(args);
-    }
 }
 
 void PlatShowMessage(const char *format, ...)
@@ -219,18 +485,10 @@ void PlatShowMessage(const char *format, ...)
 
     va_list args;
 
-    // Print to standard output
+    // Print to standard output and the debug log
     va_start(args, format);
-    vprintf(format, args);
+    PlatPrint(stdout, PLAT_LOG_MESSAGE, format, args);
     va_end(args);
-
-    // Print to debug output file, if specified
-    if (DebugOutputFile != NULL)
-    {
-        va_start(args, format);
-        vfprintf(DebugOutputFile, format, args);
-        va_end(args);
-    }
 }
 
 void PlatShowMessageB(const char *format, ...)
@@ -243,18 +501,35 @@ void PlatShowMessageB(const char *format, ...)
 
     va_list args;
 
-    // Print to standard output
+    if (Handlers.prompt != NULL)
+    {
+        char prompt[PLAT_STATION_PROMPT_MAX];
+
+        va_start(args, format);
+        vsnprintf(prompt, sizeof(prompt), format, args);
+        va_end(args);
+        if (DebugOutputFile != NULL)
+            PlatLogPut(PLAT_LOG_MESSAGE, 0, 0, prompt, strlen(prompt));
+        Handlers.prompt(prompt, Handlers.context);
+        return;
+    }
+
+    // Print to standard output and the debug log
     va_start(args, format);
-    vprintf(format, args);
-    vprintf(format, args);
-    va_end(args); // Clean up after using args for vprintf
+    PlatPrint(stdout, PLAT_LOG_MESSAGE, format, args);
+    va_end(args);
 
-    // Print to debug output file, if specified
-    if (DebugOutputFile != NULL)
+    // A station has no terminal: the runner queues the prompt for the operator and replies once it was acknowledged.
+    if (StationSocket != -1)
     {
-        va_start(args, format); // Reinitialize args for vfprintf
-        vfprintf(DebugOutputFile, format, args);
-        va_end(args); // Clean up after using args for vfprintf
+        char prompt[PLAT_STATION_PROMPT_MAX], ack;
+
+        va_start(args, format);
+        vsnprintf(prompt, sizeof(prompt), format, args);
+        va_end(args);
+        if (write(StationSocket, prompt, strlen(prompt)) <= 0 || read(StationSocket, &ack, 1) <= 0)
+            exit(EPIPE); // The runner is gone, so nobody can swap discs anymore.
+        return;
     }
 
     // Block until the user presses ENTER
@@ -264,8 +539,232 @@ void PlatShowMessageB(const char *format, ...)
     }
 }
 
+int PlatShowMessageBPoll(int (*poll)(void), unsigned short int interval, const char *format, ...)
+{
+    char prompt[PLAT_STATION_PROMPT_MAX], ack, withdraw = STATION_WITHDRAW;
+    struct timeval tv;
+    fd_set readfds;
+    va_list args;
+    int fd, result;
+
+    va_start(args, format);
+    vsnprintf(prompt, sizeof(prompt), format, args);
+    va_end(args);
+
+    if (DebugOutputFile != NULL)
+        PlatLogPut(PLAT_LOG_MESSAGE, 0, 0, prompt, strlen(prompt));
+
+    // The application's prompt cannot be polled, so it has to be acknowledged.
+    if (Handlers.prompt != NULL)
+    {
+        Handlers.prompt(prompt, Handlers.context);
+        return 0;
+    }
+
+    if (StationSocket != -1)
+    {
+        if (write(StationSocket, prompt, strlen(prompt)) <= 0)
+            exit(EPIPE);
+        fd = StationSocket;
+    }
+    else
+    {
+        fputs(prompt, stdout);
+        fflush(stdout);
+        fd = STDIN_FILENO;
+    }
+
+    do
+    {
+        FD_ZERO(&readfds);
+        FD_SET(fd, &readfds);
+        tv.tv_sec  = interval / 1000;
+        tv.tv_usec = (interval % 1000) * 1000;
+
+        if ((result = select(fd + 1, &readfds, NULL, NULL, &tv)) > 0)
+        {
+            if (StationSocket != -1)
+            {
+                if (read(StationSocket, &ack, 1) <= 0)
+                    exit(EPIPE);
+            }
+            else
+            {
+                while ((result = getchar()) != '\n' && result != EOF)
+                {
+                    // Wait for newline character
+                }
+            }
+            return 0;
+        }
+
+        result = (result == 0) ? poll() : 0;
+    } while (result == 0);
+
+    // The runner answers every prompt exactly once, so wait for that even though the operator is no longer needed.
+    if (StationSocket != -1)
+    {
+        if (write(StationSocket, &withdraw, 1) <= 0 || read(StationSocket, &ack, 1) <= 0)
+            exit(EPIPE);
+    }
+    else
+        fputc('\n', stdout);
+
+    return result;
+}
+
+int PlatSetHandlers(const struct PlatHandlers *handlers)
+{
+    if (handlers != NULL)
+        Handlers = *handlers;
+    else
+        memset(&Handlers, 0, sizeof(Handlers));
+
+    return 0;
+}
+
+static void PlatLogWrite(const struct LogRecord *record)
+{
+    switch (record->level)
+    {
+        case PLAT_LOG_TX:
+        case PLAT_LOG_RX:
+            fprintf(DebugOutputFile, "[%5u.%03u] %s %02u %03x: %.*s\n", record->ticks / 1000, record->ticks % 1000, record->level == PLAT_LOG_TX ? "TX" : "RX",
+                    record->id, record->command, record->length, record->data);
+            break;
+        default:
+            fwrite(record->data, 1, record->length, DebugOutputFile);
+    }
+}
+
+static void *PlatLogWriter(void *arg)
+{
+    struct LogRecord *record;
+    unsigned int dropped, reported = 0;
+    int stop, written;
+
+    (void)arg;
+
+    do
+    {
+        // Read before draining, so that all records produced before stopping are still written.
+        stop = atomic_load_explicit(&LogRing.stop, memory_order_acquire);
+
+        for (written = 0;; written++, LogRing.tail++)
+        {
+            record = &LogRing.records[LogRing.tail & (LOG_RING_SIZE - 1)];
+            if (atomic_load_explicit(&record->sequence, memory_order_acquire) != LogRing.tail + 1)
+                break;
+            PlatLogWrite(record);
+            atomic_store_explicit(&record->sequence, LogRing.tail + LOG_RING_SIZE, memory_order_release);
+        }
+
+        if ((dropped = atomic_load_explicit(&LogRing.dropped, memory_order_relaxed)) != reported)
+        {
+            fprintf(DebugOutputFile, "*** %u log records dropped ***\n", dropped - reported);
+            reported = dropped;
+            written++;
+        }
+
+        if (written > 0)
+            fflush(DebugOutputFile);
+        else if (!stop)
+            PlatSleep(LOG_IDLE_SLEEP);
+    } while (!stop);
+
+    return NULL;
+}
+
+static void *PlatBackgroundThread(void *arg)
+{
+    char data[PLAT_BACKGROUND_DATA_MAX];
+    int (*work)(const void *data);
+    int result;
+
+    (void)arg;
+
+    pthread_mutex_lock(&Background.lock);
+    for (;;)
+    {
+        while (!Background.pending && !Background.stop)
+            pthread_cond_wait(&Background.wake, &Background.lock);
+        if (!Background.pending)
+            break; // Stopped, and everything that was posted is done.
+
+        work = Background.work;
+        memcpy(data, Background.data, sizeof(data));
+        Background.pending = 0;
+        pthread_mutex_unlock(&Background.lock);
+
+        result = work(data);
+
+        pthread_mutex_lock(&Background.lock);
+        Background.result = result;
+    }
+    pthread_mutex_unlock(&Background.lock);
+
+    return NULL;
+}
+
+int PlatBackgroundPost(int (*work)(const void *data), const void *data, int size)
+{
+    int result;
+
+    if (size > PLAT_BACKGROUND_DATA_MAX)
+        return EINVAL;
+
+    if (Background.owner != getpid())
+    { // Started on first use. A forked process starts a thread of its own, with a fresh lock.
+        pthread_mutex_init(&Background.lock, NULL);
+        pthread_cond_init(&Background.wake, NULL);
+        Background.pending = 0;
+        Background.stop    = 0;
+        Background.result  = 0;
+        if (pthread_create(&Background.thread, NULL, &PlatBackgroundThread, NULL) != 0)
+            return work(data);
+        Background.owner = getpid();
+    }
+
+    pthread_mutex_lock(&Background.lock);
+    Background.work = work;
+    memcpy(Background.data, data, size);
+    Background.pending = 1;
+    result             = Background.result;
+    pthread_cond_signal(&Background.wake);
+    pthread_mutex_unlock(&Background.lock);
+
+    return result;
+}
+
+int PlatBackgroundFlush(void)
+{
+    if (Background.owner != getpid())
+        return 0;
+
+    pthread_mutex_lock(&Background.lock);
+    Background.stop = 1;
+    pthread_cond_signal(&Background.wake);
+    pthread_mutex_unlock(&Background.lock);
+    pthread_join(Background.thread, NULL);
+
+    Background.owner = 0;
+    pthread_cond_destroy(&Background.wake);
+    pthread_mutex_destroy(&Background.lock);
+
+    return Background.result;
+}
+
+// Also called at exit, so that the log is complete when a station is ended by exit().
+static void PlatLogAtExit(void)
+{
+    PlatDebugDeinit();
+}
+
 void PlatDebugInit(void)
 {
+    static int registered = 0;
+    unsigned int i;
+
     // Get the current time
     time_t rawtime;
     struct tm *timeinfo;
@@ -279,15 +778,48 @@ void PlatDebugInit(void)
 
     // Create the filename with timestamp
     char filename[256]; // Adjust the size according to your needs
-    snprintf(filename, sizeof(filename), "pmap_%s.log", timestamp);
+    if (StationNumber > 0)
+        snprintf(filename, sizeof(filename), "pmap_%s_station%d.log", timestamp, StationNumber);
+    else
+        snprintf(filename, sizeof(filename), "pmap_%s.log", timestamp);
+
+    if ((DebugOutputFile = fopen(filename, "w")) == NULL)
+        return;
 
-    DebugOutputFile = fopen(filename, "w");
+    for (i = 0; i < LOG_RING_SIZE; i++)
+        atomic_init(&LogRing.records[i].sequence, i);
+    atomic_init(&LogRing.head, 0);
+    atomic_init(&LogRing.dropped, 0);
+    atomic_init(&LogRing.stop, 0);
+    LogRing.tail  = 0;
+    LogRing.owner = getpid();
+    LogRing.start = PlatGetTicks();
+
+    if (pthread_create(&LogRing.writer, NULL, &PlatLogWriter, NULL) != 0)
+    {
+        fclose(DebugOutputFile);
+        DebugOutputFile = NULL;
+        PlatShowEMessage("Cannot start the debug log writer, no log will be written.\n");
+        return;
+    }
+
+    if (!registered)
+    {
+        atexit(&PlatLogAtExit);
+        registered = 1;
+    }
 }
 
 void PlatDebugDeinit(void)
 {
     if (DebugOutputFile != NULL)
     {
+        // A forked process has a copy of the ring, but not the writer.
+        if (LogRing.owner == getpid())
+        {
+            atomic_store_explicit(&LogRing.stop, 1, memory_order_release);
+            pthread_join(LogRing.writer, NULL);
+        }
         fclose(DebugOutputFile);
         DebugOutputFile = NULL;
     }
@@ -303,13 +835,25 @@ void PlatDPrintf(const char *format, ...)
 
     va_list args;
 
-    // Print to standard output
+    // Print to the debug log only
     va_start(args, format);
     if (DebugOutputFile != NULL)
-        vfprintf(DebugOutputFile, format, args);
+        PlatPrint(NULL, PLAT_LOG_DEBUG, format, args);
     va_end(args);
 }
 
+void PlatDLogFrame(int level, unsigned char id, unsigned short int command, const char *frame, int length)
+{
+    // Line endings are left out, as every frame is written on its own line.
+    while (length > 0 && (frame[length - 1] == '\r' || frame[length - 1] == '\n'))
+        length--;
+    if (length > LOG_RECORD_DATA)
+        length = LOG_RECORD_DATA;
+
+    if (DebugOutputFile != NULL)
+        PlatLogPut((unsigned char)level, id, command, frame, length);
+}
+
 int pstricmp(const char *s1, const char *s2)
 {
     char s1char, s2char;
@@ -343,3 +887,657 @@ int pstrincmp(const char *s1, const char *s2, int len)
 
     return ((len == 0) ? 0 : s1char - s2char);
 }
+
+static struct PlatStation
+{
+    pid_t pid;
+    int socket, waiting; // waiting: position in the prompt queue (1 = first), 0 if not waiting.
+    const char *device;
+    char prompt[PLAT_STATION_PROMPT_MAX];
+} stations[PLAT_MAX_STATIONS];
+
+static void PlatStationStart(int i, const char *device, int (*run)(int station, const char *device))
+{
+    int sockets[2], result, null, j;
+    char log[32];
+
+    stations[i].device  = device;
+    stations[i].waiting = 0;
+    fflush(stdout); // Otherwise the child inherits and prints whatever is still buffered.
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) != 0 || (stations[i].pid = fork()) < 0)
+    {
+        PlatShowEMessage("Station %d (%s): cannot start, error %d.\n", i + 1, device, errno);
+        stations[i].socket = -1;
+        return;
+    }
+
+    if (stations[i].pid == 0)
+    {
+        // Only the runner talks to the operator; everything else the station prints goes to its own file.
+        close(sockets[0]);
+        for (j = 0; j < i; j++) // The runner's ends of the sockets of the stations started before.
+        {
+            if (stations[j].socket != -1)
+                close(stations[j].socket);
+        }
+        if (DaemonListener != -1)
+            close(DaemonListener);
+        StationSocket = sockets[1];
+        StationNumber = i + 1;
+        snprintf(log, sizeof(log), "pmap_station%d.txt", StationNumber);
+        if (freopen(log, "w", stdout) != NULL)
+            setvbuf(stdout, NULL, _IOLBF, 0);
+        if ((null = open("/dev/null", O_RDONLY)) != -1)
+        {
+            dup2(null, STDIN_FILENO);
+            close(null);
+        }
+
+        result = run(StationNumber, device);
+        fflush(stdout);
+        exit(result & 0xFF);
+    }
+
+    close(sockets[1]);
+    stations[i].socket = sockets[0];
+    PlatShowMessage("Station %d (%s): started.\n", i + 1, device);
+}
+
+// Returns 0 if the station completed its run.
+static int PlatStationFinish(int i)
+{
+    int status;
+
+    close(stations[i].socket);
+    stations[i].socket = -1;
+    waitpid(stations[i].pid, &status, 0);
+    if (WIFEXITED(status) && WEXITSTATUS(status) == 0)
+    {
+        PlatShowMessage("Station %d (%s): finished OK.\n", i + 1, stations[i].device);
+        return 0;
+    }
+
+    PlatShowMessage("Station %d (%s): finished NG (%d), see pmap_station%d.txt.\n", i + 1, stations[i].device,
+                    WIFEXITED(status) ? WEXITSTATUS(status) : -1, i + 1);
+    return 1;
+}
+
+// Removes the station from the prompt queue, moving up everyone behind it.
+static void PlatStationDequeue(int count, int i)
+{
+    int j;
+
+    for (j = 0; j < count; j++)
+    {
+        if (stations[j].waiting > stations[i].waiting)
+            stations[j].waiting--;
+    }
+    stations[i].waiting = 0;
+}
+
+/*  Takes the next line of operator input out of the buffer, if there is a complete one.
+    A line that does not fit is cut, so that it cannot hold up the ones after it. */
+static int PlatStationGetLine(char *input, int *length, char *line, int size)
+{
+    char *end;
+    int len;
+
+    if ((end = memchr(input, '\n', *length)) != NULL)
+        len = (int)(end - input) + 1;
+    else if (*length >= PLAT_STATION_INPUT_MAX - 1)
+        len = *length;
+    else
+        return 0;
+
+    snprintf(line, size, "%.*s", len, input);
+    *length -= len;
+    memmove(input, input + len, *length);
+
+    return 1;
+}
+
+int PlatRunStations(int count, char *const devices[], int (*run)(int station, const char *device))
+{
+    char line[16], input[PLAT_STATION_INPUT_MAX], ack = '\n';
+    int i, len, running, queued, shown, choice, fdmax, failed, buffered;
+    struct timeval poll;
+    fd_set readfds;
+
+    if (count < 1 || count > PLAT_MAX_STATIONS)
+        return EINVAL;
+
+    signal(SIGPIPE, SIG_IGN); // A station that exits while its prompt is being answered must not take the runner down.
+    for (i = 0, running = 0; i < count; i++)
+    {
+        PlatStationStart(i, devices[i], run);
+        if (stations[i].socket != -1)
+            running++;
+    }
+    failed   = count - running;
+    buffered = 0;
+
+    for (queued = 0, shown = 0; running > 0;)
+    {
+        // Always show the prompt that has waited the longest, as each one may hold up a station.
+        if (queued > 0 && !shown)
+        {
+            for (i = 0; stations[i].waiting != 1; i++)
+                ;
+            PlatShowMessage("\n[Station %d, %s] %s\n", i + 1, stations[i].device, stations[i].prompt);
+            if (queued > 1)
+            {
+                PlatShowMessage("(Also waiting:");
+                for (choice = 0; choice < count; choice++)
+                {
+                    if (stations[choice].waiting > 1)
+                        PlatShowMessage(" %d", choice + 1);
+                }
+                PlatShowMessage(". Enter a station number to serve it first.)\n");
+            }
+            shown = 1;
+        }
+
+        FD_ZERO(&readfds);
+        fdmax = -1;
+        if (queued > 0)
+        {
+            FD_SET(STDIN_FILENO, &readfds);
+            fdmax = STDIN_FILENO;
+        }
+        for (i = 0; i < count; i++)
+        {
+            if (stations[i].socket != -1)
+            {
+                FD_SET(stations[i].socket, &readfds);
+                if (stations[i].socket > fdmax)
+                    fdmax = stations[i].socket;
+            }
+        }
+
+        // Input is read with read() rather than stdio, so a line that was already read in is answered without waiting for more.
+        poll.tv_sec  = 0;
+        poll.tv_usec = 0;
+        if (select(fdmax + 1, &readfds, NULL, NULL, (queued > 0 && memchr(input, '\n', buffered) != NULL) ? &poll : NULL) < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            PlatShowEMessage("Select function error.\n");
+            break;
+        }
+
+        for (i = 0; i < count; i++)
+        {
+            if (stations[i].socket == -1 || !FD_ISSET(stations[i].socket, &readfds))
+                continue;
+
+            if ((len = read(stations[i].socket, stations[i].prompt, sizeof(stations[i].prompt) - 1)) > 0)
+            {
+                stations[i].prompt[len] = '\0';
+                if (stations[i].prompt[0] == STATION_WITHDRAW)
+                {
+                    // If the operator answered at the same time, the station already has its reply.
+                    if (stations[i].waiting > 0)
+                    {
+                        PlatShowMessage("[Station %d, %s] Tray switch changed, continuing.\n", i + 1, stations[i].device);
+                        if (stations[i].waiting == 1)
+                            shown = 0;
+                        if (write(stations[i].socket, &ack, 1) != 1)
+                            PlatShowEMessage("Station %d (%s): cannot reply.\n", i + 1, stations[i].device);
+                        PlatStationDequeue(count, i);
+                        queued--;
+                    }
+                    memmove(stations[i].prompt, &stations[i].prompt[1], len--);
+                }
+                if (len > 0)
+                    stations[i].waiting = ++queued;
+            }
+            else
+            {
+                failed += PlatStationFinish(i);
+                running--;
+            }
+        }
+
+        if (queued > 0 && FD_ISSET(STDIN_FILENO, &readfds))
+        {
+            if ((len = read(STDIN_FILENO, input + buffered, sizeof(input) - 1 - buffered)) > 0)
+                buffered += len;
+            else if ((len == 0 || errno != EINTR) && memchr(input, '\n', buffered) == NULL)
+                break; // Only once the lines that were read in are answered.
+        }
+
+        if (queued > 0 && PlatStationGetLine(input, &buffered, line, sizeof(line)))
+        {
+
+            // ENTER serves the first station in the queue, a number serves that station if it is waiting.
+            for (i = 0; stations[i].waiting != 1; i++)
+                ;
+            if (sscanf(line, "%d", &choice) == 1)
+            {
+                if (choice < 1 || choice > count || stations[choice - 1].waiting == 0)
+                {
+                    PlatShowMessage("Station %d is not waiting.\n", choice);
+                    continue;
+                }
+                i = choice - 1;
+            }
+
+            if (write(stations[i].socket, &ack, 1) != 1)
+                PlatShowEMessage("Station %d (%s): cannot reply.\n", i + 1, stations[i].device);
+            PlatStationDequeue(count, i);
+            queued--;
+            shown = 0;
+        }
+    }
+
+    // Only reached early if the operator input is gone: the stations cannot continue without it.
+    for (i = 0; i < count; i++)
+    {
+        if (stations[i].socket != -1)
+        {
+            kill(stations[i].pid, SIGTERM);
+            failed += PlatStationFinish(i);
+        }
+    }
+
+    return failed;
+}
+
+int PlatProbeCOMPorts(int count, char *const devices[], int (*probe)(const char *device, void *result), void *results, int size, int status[], unsigned short int timeout)
+{
+    pid_t pids[PLAT_MAX_PORTS];
+    int pipes[PLAT_MAX_PORTS][2], i, running, fdmax, null, result;
+    long long record[PIPE_BUF / sizeof(long long)]; // The result, then the status.
+    struct timeval tv;
+    fd_set readfds;
+    u32 start, elapsed;
+
+    if (count < 0 || count > PLAT_MAX_PORTS || size < 0 || sizeof(int) + size > sizeof(record))
+        return EINVAL;
+
+    fflush(stdout);
+    for (i = 0, running = 0; i < count; i++)
+    {
+        status[i] = ETIMEDOUT;
+        pids[i]   = -1;
+        if (pipe(pipes[i]) != 0)
+        {
+            status[i]   = errno;
+            pipes[i][0] = -1;
+            continue;
+        }
+        if ((pids[i] = fork()) < 0)
+        {
+            status[i] = errno;
+            close(pipes[i][0]);
+            close(pipes[i][1]);
+            pipes[i][0] = -1;
+            continue;
+        }
+
+        if (pids[i] == 0)
+        {
+            // The result is written at once (at most PIPE_BUF bytes), so it cannot be torn if the probe is stopped.
+            close(pipes[i][0]);
+            if (ComPortHandle != -1)
+                close(ComPortHandle);
+            ComPortHandle = -1;
+            memset(&Handlers, 0, sizeof(Handlers));
+            if ((null = open("/dev/null", O_RDWR)) != -1)
+            {
+                dup2(null, STDIN_FILENO);
+                dup2(null, STDOUT_FILENO);
+                dup2(null, STDERR_FILENO);
+                close(null);
+            }
+
+            memset(record, 0, sizeof(record));
+            result = probe(devices[i], record);
+            memcpy((char *)record + size, &result, sizeof(int));
+            PlatCloseCOMPort();
+            _exit(write(pipes[i][1], record, sizeof(int) + size) == (ssize_t)(sizeof(int) + size) ? 0 : 1);
+        }
+
+        close(pipes[i][1]);
+        running++;
+    }
+
+    for (start = PlatGetTicks(); running > 0 && (elapsed = PlatGetTicks() - start) < timeout;)
+    {
+        FD_ZERO(&readfds);
+        for (i = 0, fdmax = -1; i < count; i++)
+        {
+            if (pipes[i][0] != -1)
+            {
+                FD_SET(pipes[i][0], &readfds);
+                if (pipes[i][0] > fdmax)
+                    fdmax = pipes[i][0];
+            }
+        }
+
+        tv.tv_sec  = (timeout - elapsed) / 1000;
+        tv.tv_usec = ((timeout - elapsed) % 1000) * 1000;
+        if (select(fdmax + 1, &readfds, NULL, NULL, &tv) < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+
+        for (i = 0; i < count; i++)
+        {
+            if (pipes[i][0] == -1 || !FD_ISSET(pipes[i][0], &readfds))
+                continue;
+
+            if (read(pipes[i][0], record, sizeof(int) + size) == (ssize_t)(sizeof(int) + size))
+            {
+                memcpy((char *)results + i * size, record, size);
+                memcpy(&status[i], (char *)record + size, sizeof(int));
+            }
+            else
+                status[i] = EIO;
+            close(pipes[i][0]);
+            pipes[i][0] = -1;
+            running--;
+        }
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        if (pipes[i][0] != -1)
+        {
+            kill(pids[i], SIGKILL);
+            close(pipes[i][0]);
+        }
+        if (pids[i] > 0)
+            waitpid(pids[i], NULL, 0);
+    }
+
+    return 0;
+}
+
+static void PlatDaemonStop(int signal)
+{
+    (void)signal;
+    DaemonStopping = 1;
+}
+
+static int PlatDaemonListen(const char *path)
+{
+    struct sockaddr_un address;
+    struct stat status;
+    int fd;
+
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(address.sun_path))
+        return -1;
+    strcpy(address.sun_path, path);
+
+    if ((fd = socket(AF_UNIX, SOCK_STREAM, 0)) < 0)
+        return -1;
+    if (connect(fd, (struct sockaddr *)&address, sizeof(address)) == 0)
+    { // Another daemon is serving this socket.
+        close(fd);
+        errno = EADDRINUSE;
+        return -1;
+    }
+    close(fd);
+
+    // A socket may be left behind by a daemon that did not stop cleanly. Anything else at the path is not ours to remove.
+    if (lstat(path, &status) == 0)
+    {
+        if (!S_ISSOCK(status.st_mode))
+        {
+            errno = EEXIST;
+            return -1;
+        }
+        if (unlink(path) != 0)
+            return -1;
+    }
+    else if (errno != ENOENT)
+        return -1;
+    if ((fd = socket(AF_UNIX, SOCK_STREAM, 0)) < 0)
+        return -1;
+    if (bind(fd, (struct sockaddr *)&address, sizeof(address)) != 0 || listen(fd, 16) != 0)
+    {
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+/*  Reads the request line, but does not wait long for it: other clients are not served in the meantime.
+    The time is for the whole line, so that a client that sends it slowly cannot hold up the others. */
+static int PlatDaemonReadRequest(int fd, char *request, int size)
+{
+    struct timeval tv;
+    fd_set readfds;
+    int length;
+    u32 start, elapsed;
+
+    for (length = 0, start = PlatGetTicks(); length < size - 1;)
+    {
+        if ((elapsed = PlatGetTicks() - start) >= PLAT_DAEMON_REQUEST_TO)
+            return -1;
+        FD_ZERO(&readfds);
+        FD_SET(fd, &readfds);
+        tv.tv_sec  = (PLAT_DAEMON_REQUEST_TO - elapsed) / 1000;
+        tv.tv_usec = (PLAT_DAEMON_REQUEST_TO - elapsed) % 1000 * 1000;
+        if (select(fd + 1, &readfds, NULL, NULL, &tv) <= 0 || read(fd, &request[length], 1) != 1)
+            return -1;
+        if (request[length] == '\n')
+            break;
+        if (request[length] != '\r')
+            length++;
+    }
+    request[length] = '\0';
+
+    return length;
+}
+
+// Passes the client, with the request, to the station of the device that it names.
+static void PlatDaemonDispatch(int client, int count, char *const devices[])
+{
+    char request[PLAT_DAEMON_REQUEST_MAX], data[PLAT_DAEMON_REQUEST_MAX], control[CMSG_SPACE(sizeof(int))], *job;
+    const char *reply = NULL;
+    struct cmsghdr *cmsg;
+    struct msghdr msg;
+    struct iovec iov;
+    int i, length;
+
+    if (PlatDaemonReadRequest(client, request, sizeof(request)) < 0)
+        return;
+
+    for (job = request; *job != '\0' && !isspace((unsigned char)*job); job++)
+        ;
+    if (*job != '\0')
+        *job++ = '\0';
+    for (i = 0; i < count && strcmp(devices[i], request) && atoi(request) != i + 1; i++)
+        ;
+
+    if (i >= count)
+        reply = "! Unknown device.\n= 19\n"; // ENODEV
+    else if (stations[i].socket == -1)
+        reply = "! The station of this device has stopped.\n= 5\n"; // EIO
+    else
+    {
+        memset(data, 0, sizeof(data));
+        length = (int)strlen(job);
+        memcpy(data, job, length);
+        iov.iov_base = data;
+        iov.iov_len  = sizeof(data); // Always whole records, so that jobs queued for a station are not merged.
+
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov        = &iov;
+        msg.msg_iovlen     = 1;
+        msg.msg_control    = control;
+        msg.msg_controllen = sizeof(control);
+        cmsg               = CMSG_FIRSTHDR(&msg);
+        cmsg->cmsg_level   = SOL_SOCKET;
+        cmsg->cmsg_type    = SCM_RIGHTS;
+        cmsg->cmsg_len     = CMSG_LEN(sizeof(int));
+        memcpy(CMSG_DATA(cmsg), &client, sizeof(int));
+
+        if (sendmsg(stations[i].socket, &msg, 0) != (ssize_t)sizeof(data))
+            reply = "! Cannot pass the job to the station.\n= 5\n";
+    }
+
+    if (reply != NULL && write(client, reply, strlen(reply)) < 0)
+        PlatDPrintf("Daemon: cannot reply to a client.\n");
+}
+
+int PlatRunDaemon(const char *path, int count, char *const devices[], int (*serve)(int station, const char *device))
+{
+    struct sigaction action;
+    int i, client, running, fdmax, failed;
+    char discard[PLAT_DAEMON_REQUEST_MAX];
+    fd_set readfds;
+
+    if (count < 1 || count > PLAT_MAX_STATIONS)
+        return EINVAL;
+    if ((DaemonListener = PlatDaemonListen(path)) < 0)
+    {
+        PlatShowEMessage("Cannot listen on %s, error %d.\n", path, errno);
+        return errno;
+    }
+
+    signal(SIGPIPE, SIG_IGN); // Clients may leave at any time.
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = &PlatDaemonStop; // Without SA_RESTART, so that select() returns.
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+
+    for (i = 0, running = 0; i < count; i++)
+    {
+        PlatStationStart(i, devices[i], serve);
+        if (stations[i].socket != -1)
+            running++;
+    }
+    failed = count - running;
+    PlatShowMessage("Serving %d device%s on %s.\n", running, running != 1 ? "s" : "", path);
+
+    while (!DaemonStopping && running > 0)
+    {
+        FD_ZERO(&readfds);
+        FD_SET(DaemonListener, &readfds);
+        fdmax = DaemonListener;
+        for (i = 0; i < count; i++)
+        {
+            if (stations[i].socket != -1)
+            {
+                FD_SET(stations[i].socket, &readfds);
+                if (stations[i].socket > fdmax)
+                    fdmax = stations[i].socket;
+            }
+        }
+
+        if (select(fdmax + 1, &readfds, NULL, NULL, NULL) < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            PlatShowEMessage("Select function error.\n");
+            break;
+        }
+
+        // Stations only ever close their end, when they stop.
+        for (i = 0; i < count; i++)
+        {
+            if (stations[i].socket != -1 && FD_ISSET(stations[i].socket, &readfds) && read(stations[i].socket, discard, sizeof(discard)) <= 0)
+            {
+                failed += PlatStationFinish(i);
+                running--;
+            }
+        }
+
+        if (FD_ISSET(DaemonListener, &readfds) && (client = accept(DaemonListener, NULL, NULL)) >= 0)
+        {
+            PlatDaemonDispatch(client, count, devices);
+            close(client); // The station has its own copy.
+        }
+    }
+
+    // Stations see their end of the socket close, once they are done with the current job.
+    close(DaemonListener);
+    DaemonListener = -1;
+    unlink(path);
+    for (i = 0; i < count; i++)
+    {
+        if (stations[i].socket != -1)
+        {
+            shutdown(stations[i].socket, SHUT_WR);
+            failed += PlatStationFinish(i);
+        }
+    }
+
+    return failed;
+}
+
+static void PlatDaemonEndJob(void)
+{
+    if (DaemonClient != -1)
+    {
+        close(DaemonClient);
+        DaemonClient = -1;
+    }
+}
+
+int PlatDaemonNextJob(char *request, int size)
+{
+    char data[PLAT_DAEMON_REQUEST_MAX], control[CMSG_SPACE(sizeof(int))];
+    struct cmsghdr *cmsg;
+    struct msghdr msg;
+    struct iovec iov;
+
+    PlatDaemonEndJob();
+    while (DaemonClient == -1)
+    {
+        iov.iov_base = data;
+        iov.iov_len  = sizeof(data);
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov        = &iov;
+        msg.msg_iovlen     = 1;
+        msg.msg_control    = control;
+        msg.msg_controllen = sizeof(control);
+        if (recvmsg(StationSocket, &msg, MSG_WAITALL) != (ssize_t)sizeof(data))
+            return EPIPE; // The daemon is stopping.
+
+        if ((cmsg = CMSG_FIRSTHDR(&msg)) != NULL && cmsg->cmsg_type == SCM_RIGHTS)
+            memcpy(&DaemonClient, CMSG_DATA(cmsg), sizeof(int));
+    }
+
+    data[sizeof(data) - 1] = '\0';
+    snprintf(request, size, "%s", data);
+
+    return 0;
+}
+
+int PlatDaemonReply(const char *text)
+{
+    if (DaemonClient == -1 || write(DaemonClient, text, strlen(text)) < 0)
+        return EPIPE;
+
+    return 0;
+}
+
+int PlatDaemonAnswer(char *line, int size)
+{
+    int length;
+
+    if (DaemonClient == -1)
+        return EPIPE;
+
+    for (length = 0; length < size - 1;)
+    {
+        if (read(DaemonClient, &line[length], 1) != 1)
+            return EPIPE;
+        if (line[length] == '\n')
+            break;
+        if (line[length] != '\r')
+            length++;
+    }
+    line[length] = '\0';
+
+    return 0;
+}
@@ -0,0 +1,243 @@
+#include <errno.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <ctype.h>
+
+#include "../base/platform.h"
+#include "../base/mecha.h"
+#include "../base/eeprom.h"
+#include "../base/updates.h"
+
+/*  Test for the update engine (MechaUpdateChassis()), without a console.
+    The MECHACON state, the EEPROM map and the command list are replaced with stand-ins. Each chassis is updated for every
+    lens and OP, over a set of console states and EEPROM contents, with and without ReplacedMecha and ClearOSD2InitBit.
+    Every EEPROM state is updated twice: as it is, then again after applying the writes of the first update.
+
+    The EEPROM writes of an update are compared as a set (the final value of each word), as the engine writes each word
+    once and in address order. The other commands are compared in order, with their arguments, timeouts and labels,
+    together with the status that was returned. One line is printed for each chassis, lens and OP: the number of updates
+    that failed and that succeeded, the numbers of EEPROM writes and other commands, and a hash over all of it.
+
+    test-updates.expected was generated from the per-chassis update functions (v1.12) that the engine replaced,
+    so the engine must issue the same writes and commands as they did. The only difference is intended: for a MECHACON
+    that is not from a D-chassis, the D-chassis update returned EINVAL (taken for success) instead of -EINVAL. */
+
+#define TEST_MAX_TASKS 128
+
+// The MECHACON state that the update functions use.
+char MechaName[9], RTCData[19];
+unsigned char ConMD, ConType, ConTM, ConCEXDEX, ConOP, ConLens, ConRTC, ConRTCStat, ConECR, ConChecksumStat;
+
+static u16 EEPROMMap[0x200];
+
+static struct TestTask
+{
+    unsigned short int command, timeout;
+    char args[32];
+    const char *label;
+} tasks[TEST_MAX_TASKS];
+static int TaskCount, ListOverflow;
+
+struct TestConsole
+{
+    unsigned char MD, type, RTC, ECR, ChecksumStat, SameLens, SameOP;
+    const char *name, *rtc;
+};
+
+static const struct TestConsole consoles[] = {
+    {36, MECHA_TYPE_36, MECHA_RTC_RICOH, 0x19, 1, 1, 1, "00020600", "308C01151803258401"},
+    {38, MECHA_TYPE_38, MECHA_RTC_RICOH, 0x15, 1, 0, 1, "00020700", "30C801151803258401"},
+    {39, MECHA_TYPE_G, MECHA_RTC_ROHM, 0x00, 0, 1, 0, "00040500", "300001431800221001"},
+    {39, MECHA_TYPE_G2, MECHA_RTC_RICOH, 0x13, 1, 1, 1, "00030600", "308801151803258401"},
+    {40, MECHA_TYPE_40, MECHA_RTC_ROHM, 0x13, 1, 0, 0, "00050500", "123401431800221001"},
+    {39, MECHA_TYPE_F, MECHA_RTC_RICOH, 0x00, 1, 1, 1, "00010200", "300001431800221001"},
+};
+
+// Values that the chassis-specific checks look for.
+static const u16 Values026[] = {0x0c06, 0x0e06, 0x9a4d, 0x0c0a, 0x1234};
+static const u16 ValuesOPT13[] = {0x4f4f, 0x6f4f, 0x1111};
+
+#define TEST_EEPROM_STATES (sizeof(Values026) / sizeof(Values026[0]) + 1) // The last one is erased.
+
+int pstrincmp(const char *s1, const char *s2, int len)
+{
+    for (; len > 0 && *s1 != '\0' && *s2 != '\0'; s1++, s2++, len--)
+    {
+        if (toupper((unsigned char)*s1) != toupper((unsigned char)*s2))
+            break;
+    }
+
+    return (len == 0) ? 0 : toupper((unsigned char)*s1) - toupper((unsigned char)*s2);
+}
+
+void PlatShowEMessage(const char *format, ...)
+{
+    (void)format;
+}
+
+u16 EEPMapRead(unsigned short int word)
+{
+    return EEPROMMap[word];
+}
+
+int MechaCommandAdd(unsigned short int command, const char *args, unsigned char id, unsigned char tag, unsigned short int timeout, const char *label)
+{
+    (void)id;
+    (void)tag;
+
+    if (TaskCount >= TEST_MAX_TASKS)
+    {
+        ListOverflow = 1;
+        return -ENOMEM;
+    }
+    tasks[TaskCount].command = command;
+    tasks[TaskCount].timeout = timeout;
+    snprintf(tasks[TaskCount].args, sizeof(tasks[TaskCount].args), "%s", args != NULL ? args : "");
+    tasks[TaskCount].label = label;
+    TaskCount++;
+
+    return 0;
+}
+
+void MechaCommandListClear(void)
+{
+    TaskCount = 0;
+}
+
+// The post-update commands do not depend on the chassis, so only what is passed on is recorded.
+int MechaAddPostUpdateCmds(unsigned char ClearOSD2InitBit, unsigned char id)
+{
+    char args[4];
+
+    snprintf(args, sizeof(args), "%u", ClearOSD2InitBit);
+    return MechaCommandAdd(0xFFFF, args, id, 0, 0, "POST-UPDATE");
+}
+
+static void TestHash(u32 *hash, const char *text)
+{
+    for (; *text != '\0'; text++)
+        *hash = (*hash ^ (unsigned char)*text) * 16777619u; // FNV-1a
+}
+
+static void TestSetEEPROM(int state)
+{
+    int word;
+
+    for (word = 0; word < 0x200; word++)
+        EEPROMMap[word] = ((unsigned int)state < TEST_EEPROM_STATES - 1) ? (u16)((word * 0x0101) ^ 0x5a5a ^ (state << 4)) : 0xFFFF;
+    if ((unsigned int)state < TEST_EEPROM_STATES - 1)
+    {
+        EEPROMMap[0x026]              = Values026[state];
+        EEPROMMap[EEPROM_MAP_OPT_13] = ValuesOPT13[state % (sizeof(ValuesOPT13) / sizeof(ValuesOPT13[0]))];
+        EEPROMMap[0x00e]              = (state & 1) ? 0xFFFF : 0x0000;
+    }
+}
+
+/*  Runs one update and adds its outcome to the hash. If apply is set, the EEPROM writes are applied to the map.
+    Returns 1 if the update succeeded, 0 if it failed. */
+static int TestUpdate(int chassis, int lens, int op, int ClearOSD2InitBit, int ReplacedMecha, int apply, u32 *hash, int *writes, int *commands)
+{
+    static u16 value[0x200];
+    static unsigned char written[0x200];
+    unsigned int word, data;
+    char text[96];
+    int result, i;
+
+    TaskCount    = 0;
+    ListOverflow = 0;
+    memset(written, 0, sizeof(written));
+
+    result = MechaUpdateChassis(chassis, ClearOSD2InitBit, ReplacedMecha, lens, op);
+    snprintf(text, sizeof(text), "status %d%s\n", result, ListOverflow ? " overflow" : "");
+    TestHash(hash, text);
+    if (result < 0) // The caller clears the list.
+        return 0;
+
+    for (i = 0; i < TaskCount; i++)
+    {
+        if (tasks[i].command == MECHA_CMD_EEPROM_WRITE && sscanf(tasks[i].args, "%4x%4x", &word, &data) == 2 && word < 0x200)
+        {
+            value[word]   = (u16)data;
+            written[word] = 1;
+        }
+        else
+        {
+            snprintf(text, sizeof(text), "%03x %s %u %s\n", tasks[i].command, tasks[i].args, tasks[i].timeout, tasks[i].label != NULL ? tasks[i].label : "");
+            TestHash(hash, text);
+            (*commands)++;
+        }
+    }
+
+    for (word = 0; word < 0x200; word++)
+    {
+        if (written[word])
+        {
+            snprintf(text, sizeof(text), "%03x=%04x\n", word, value[word]);
+            TestHash(hash, text);
+            (*writes)++;
+            if (apply)
+                EEPROMMap[word] = value[word];
+        }
+    }
+
+    return 1;
+}
+
+int main(int argc, char *argv[])
+{
+    const struct TestConsole *console;
+    int chassis, lens, op, c, state, flags, pass, failed, succeeded, writes, commands;
+    u32 hash;
+
+    (void)argc;
+    (void)argv;
+
+    for (chassis = 0; chassis < MECHA_CHASSIS_MODEL_COUNT; chassis++)
+    {
+        for (lens = MECHA_LENS_T487; lens <= MECHA_LENS_T609K; lens++)
+        {
+            for (op = MECHA_OP_SONY; op <= MECHA_OP_SANYO; op++)
+            {
+                hash      = 2166136261u;
+                failed    = 0;
+                succeeded = 0;
+                writes    = 0;
+                commands  = 0;
+
+                for (c = 0; c < (int)(sizeof(consoles) / sizeof(consoles[0])); c++)
+                {
+                    console         = &consoles[c];
+                    ConMD           = console->MD;
+                    ConType         = console->type;
+                    ConRTC          = console->RTC;
+                    ConECR          = console->ECR;
+                    ConChecksumStat = console->ChecksumStat;
+                    ConLens         = console->SameLens ? lens : !lens;
+                    ConOP           = console->SameOP ? op : !op;
+                    strcpy(MechaName, console->name);
+
+                    for (state = 0; state < (int)TEST_EEPROM_STATES; state++)
+                    {
+                        for (flags = 0; flags < 4; flags++)
+                        {
+                            TestSetEEPROM(state);
+                            for (pass = 0; pass < 2; pass++)
+                            {
+                                strcpy(RTCData, console->rtc); // The update functions change it.
+                                if (TestUpdate(chassis, lens, op, flags & 1, (flags >> 1) & 1, pass == 0, &hash, &writes, &commands))
+                                    succeeded++;
+                                else
+                                    failed++;
+                            }
+                        }
+                    }
+                }
+
+                printf("chassis %2d lens %d op %d: failed %3d succeeded %3d writes %5d commands %5d hash %08x\n", chassis, lens, op, failed, succeeded, writes, commands, hash);
+            }
+        }
+    }
+
+    return 0;
+}
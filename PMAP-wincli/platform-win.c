@@ -3,6 +3,7 @@
 #include <stdio.h>
 #include <stdarg.h>
 #include <Windows.h>
+#include <conio.h>
 #include <time.h>
 #include <ctype.h>
 
@@ -31,6 +32,22 @@ void ListSerialDevices()
     }
 }
 
+// The patterns are not used: every COM port that exists is listed.
+int PlatListCOMPorts(int count, char *const patterns[], char devices[][PLAT_DEVICE_MAX], int max)
+{
+    char target[256];
+    int port, found;
+
+    for (port = 1, found = 0; port <= 256 && found < max; port++)
+    {
+        snprintf(devices[found], PLAT_DEVICE_MAX, "COM%d", port);
+        if (QueryDosDevice(devices[found], target, sizeof(target)) != 0)
+            found++;
+    }
+
+    return found;
+}
+
 int PlatOpenCOMPort(const char *device)
 {
     ListSerialDevices();
@@ -127,11 +144,29 @@ void PlatCloseCOMPort(void)
     }
 }
 
+// Devices that are removed or added are not watched for, so this only waits.
+int PlatWatchCOMPort(unsigned short int msec)
+{
+    Sleep(msec);
+    return ComPortHandle != INVALID_HANDLE_VALUE ? 0 : ENODEV;
+}
+
+// ClearCommError() only tells which errors occurred, not how many.
+int PlatGetCOMPortErrors(struct PlatCOMPortErrors *errors)
+{
+    return ENOTSUP;
+}
+
 void PlatSleep(unsigned short int msec)
 {
     Sleep(msec);
 }
 
+u32 PlatGetTicks(void)
+{
+    return (u32)GetTickCount();
+}
+
 void PlatShowEMessage(const char *format, ...)
 {
     if (format == NULL)
@@ -210,6 +245,112 @@ void PlatShowMessageB(const char *format, ...)
     }
 }
 
+int PlatShowMessageBPoll(int (*poll)(void), unsigned short int interval, const char *format, ...)
+{
+    unsigned short int elapsed;
+    va_list args;
+    int result;
+
+    va_start(args, format);
+    vprintf(format, args);
+    va_end(args);
+
+    if (DebugOutputFile != NULL)
+    {
+        va_start(args, format);
+        vfprintf(DebugOutputFile, format, args);
+        va_end(args);
+    }
+
+    do
+    {
+        // The keyboard is checked at least once, even with no interval at all.
+        for (elapsed = 0;; elapsed += 50)
+        {
+            if (_kbhit())
+            {
+                while (getchar() != '\n')
+                {
+                    // Wait for newline character
+                }
+                return 0;
+            }
+            if (elapsed >= interval)
+                break;
+            Sleep(50);
+        }
+    } while ((result = poll()) == 0);
+
+    printf("\n");
+
+    return result;
+}
+
+int PlatSetHandlers(const struct PlatHandlers *handlers)
+{
+    return handlers != NULL ? ENOSYS : 0; // Messages and prompts always go to the console.
+}
+
+int PlatRunStations(int count, char *const devices[], int (*run)(int station, const char *device))
+{
+    PlatShowMessage("Running several stations at once is not supported on Windows.\n");
+    return ENOSYS;
+}
+
+// Without fork(), the devices are probed one after another, and their messages are shown.
+int PlatProbeCOMPorts(int count, char *const devices[], int (*probe)(const char *device, void *result), void *results, int size, int status[], unsigned short int timeout)
+{
+    int i;
+
+    if (ComPortHandle != INVALID_HANDLE_VALUE)
+        return EBUSY;
+
+    for (i = 0; i < count; i++)
+    {
+        memset((char *)results + i * size, 0, size);
+        status[i] = probe(devices[i], (char *)results + i * size);
+        if (ComPortHandle != INVALID_HANDLE_VALUE)
+            PlatCloseCOMPort();
+    }
+
+    return 0;
+}
+
+int PlatRunDaemon(const char *path, int count, char *const devices[], int (*serve)(int station, const char *device))
+{
+    PlatShowMessage("The daemon is not supported on Windows.\n");
+    return ENOSYS;
+}
+
+int PlatDaemonNextJob(char *request, int size)
+{
+    return ENOSYS;
+}
+
+int PlatDaemonReply(const char *text)
+{
+    return ENOSYS;
+}
+
+int PlatDaemonAnswer(char *line, int size)
+{
+    return ENOSYS;
+}
+
+// There is no background thread, so the work is done right away.
+int PlatBackgroundPost(int (*work)(const void *data), const void *data, int size)
+{
+    if (size > PLAT_BACKGROUND_DATA_MAX)
+        return EINVAL;
+
+    return work(data);
+}
+
+int PlatBackgroundFlush(void)
+{
+    return 0;
+}
+
 void PlatDebugInit(void)
 {
     // Get the current time
@@ -256,6 +397,16 @@ void PlatDPrintf(const char *format, ...)
     va_end(args);
 }
 
+// Written directly, as this platform has no background log writer.
+void PlatDLogFrame(int level, unsigned char id, unsigned short int command, const char *frame, int length)
+{
+    while (length > 0 && (frame[length - 1] == '\r' || frame[length - 1] == '\n'))
+        length--;
+
+    if (DebugOutputFile != NULL)
+        fprintf(DebugOutputFile, "%s %02u %03x: %.*s\n", level == PLAT_LOG_TX ? "TX" : "RX", id, command, length, frame);
+}
+
 int pstricmp(const char *s1, const char *s2)
 {
     char s1char, s2char;
@@ -67,30 +67,25 @@ static void InitWindow(HWND hwnd)
 
 static int UpdateEEPROM(HWND hwndDlg)
 {
-    struct UpdateData
-    {
-        int (*update)(int ClearOSD2InitBit, int ReplacedMecha, int lens, int opt);
-        unsigned int flags;
-    };
     int ClearOSD2InitBit = 0, ReplacedMecha, OpticalBlock, ObjectLens, result, chassis;
+    unsigned int flags;
     char choice;
-    struct UpdateData *selected;
-    struct UpdateData data[MECHA_CHASSIS_MODEL_COUNT] = {
-        {&MechaUpdateChassisCex10000, 0},
-        {&MechaUpdateChassisA, 0},
-        {&MechaUpdateChassisAB, 0},
-        {&MechaUpdateChassisB, 0},
-        {&MechaUpdateChassisC, 0},
-        {&MechaUpdateChassisD, 0},
-        {&MechaUpdateChassisF, EEPROM_UPDATE_FLAG_SANYO},
-        {&MechaUpdateChassisG, EEPROM_UPDATE_FLAG_SANYO | EEPROM_UPDATE_FLAG_NEW_SONY},
-        {&MechaUpdateChassisH, EEPROM_UPDATE_FLAG_SANYO | EEPROM_UPDATE_FLAG_NEW_SONY},
-        {&MechaUpdateChassisDexA, 0},
-        {&MechaUpdateChassisDexA2, 0},
-        {&MechaUpdateChassisDexA3, 0},
-        {&MechaUpdateChassisDexB, 0},
-        {&MechaUpdateChassisDexD, 0},
-        {&MechaUpdateChassisDexH, EEPROM_UPDATE_FLAG_SANYO | EEPROM_UPDATE_FLAG_NEW_SONY},
+    const unsigned char ChassisFlags[MECHA_CHASSIS_MODEL_COUNT] = {
+        0,                                                      // SCPH-10000
+        0,                                                      // A
+        0,                                                      // AB
+        0,                                                      // B
+        0,                                                      // C
+        0,                                                      // D
+        EEPROM_UPDATE_FLAG_SANYO,                               // F
+        EEPROM_UPDATE_FLAG_SANYO | EEPROM_UPDATE_FLAG_NEW_SONY, // G
+        EEPROM_UPDATE_FLAG_SANYO | EEPROM_UPDATE_FLAG_NEW_SONY, // H
+        0,                                                      // DEX A
+        0,                                                      // DEX A2
+        0,                                                      // DEX A3
+        0,                                                      // DEX B
+        0,                                                      // DEX D
+        EEPROM_UPDATE_FLAG_SANYO | EEPROM_UPDATE_FLAG_NEW_SONY, // DEX H
     };
 
     if ((chassis = SendMessage(GetDlgItem(hwndDlg, IDC_CMB_CHASSIS), CB_GETCURSEL, 0, 0)) == CB_ERR)
@@ -98,10 +93,10 @@ static int UpdateEEPROM(HWND hwndDlg)
 
     if (chassis >= 0)
     {
-        selected      = &data[chassis];
+        flags         = ChassisFlags[chassis];
         ReplacedMecha = IsDlgButtonChecked(hwndDlg, IDC_CB_REPLACED_MECHACON) == BST_CHECKED;
 
-        if (selected->flags & EEPROM_UPDATE_FLAG_SANYO)
+        if (flags & EEPROM_UPDATE_FLAG_SANYO)
         {
             do
             {
@@ -120,7 +115,7 @@ static int UpdateEEPROM(HWND hwndDlg)
         else
             OpticalBlock = MECHA_OP_SONY;
 
-        if (!(selected->flags & EEPROM_UPDATE_FLAG_NEW_SONY) && (OpticalBlock != MECHA_OP_SANYO))
+        if (!(flags & EEPROM_UPDATE_FLAG_NEW_SONY) && (OpticalBlock != MECHA_OP_SANYO))
         {
             do
             {
@@ -152,7 +147,7 @@ static int UpdateEEPROM(HWND hwndDlg)
             ClearOSD2InitBit = choice == 'y';
         }
 
-        if ((result = selected->update(ClearOSD2InitBit, ReplacedMecha, ObjectLens, OpticalBlock)) > 0)
+        if ((result = MechaUpdateChassis(chassis, ClearOSD2InitBit, ReplacedMecha, ObjectLens, OpticalBlock)) > 0)
         {
             PlatShowMessage("Actions available:\n");
             if (result & UPDATE_REGION_EEP_ECR)
@@ -180,6 +175,9 @@ static int UpdateEEPROM(HWND hwndDlg)
             if (result & UPDATE_REGION_DEFAULTS)
                 PlatShowMessage("\tMechacon defaults\n");
 
+            PlatShowMessage("\n");
+            MechaCommandSimulateList(NULL);
+
             do
             {
                 PlatShowMessage("Proceed with updates? (y/n) ");
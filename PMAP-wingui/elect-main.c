@@ -88,7 +88,7 @@ static INT_PTR CALLBACK ElectDlg(HWND hwndDlg, UINT uMsg, WPARAM wParam, LPARAM
                     else
                         ElectConIsT10K = 0;
                     ToggleMainDialogControls(hwndDlg, FALSE);
-                    ElectAutoAdjust();
+                    ElectAutoAdjust(ELECT_STAGE_CD);
                     ToggleMainDialogControls(hwndDlg, TRUE);
                     break;
                 case IDOK:
@@ -134,6 +134,11 @@ void PlatSleep(unsigned short int msec)
     Sleep(msec);
 }
 
+u32 PlatGetTicks(void)
+{
+    return (u32)GetTickCount();
+}
+
 void PlatShowEMessage(const char *format, ...)
 {
     char buffer[256];
@@ -212,6 +217,43 @@ void PlatShowMessageB(const char *format, ...)
     MessageBoxA(g_mainWin, buffer, "Information", MB_OK | MB_ICONINFORMATION);
 }
 
+// A message box cannot be dismissed from here, so the operator always has to confirm.
+int PlatShowMessageBPoll(int (*poll)(void), unsigned short int interval, const char *format, ...)
+{
+    char buffer[256];
+    va_list args;
+
+    va_start(args, format);
+    vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+
+    if (DebugOutputFile != NULL)
+        fputs(buffer, DebugOutputFile);
+
+    MessageBoxA(g_mainWin, buffer, "Information", MB_OK | MB_ICONINFORMATION);
+
+    return 0;
+}
+
+int PlatSetHandlers(const struct PlatHandlers *handlers)
+{
+    return handlers != NULL ? ENOSYS : 0; // Messages and prompts always go to the window.
+}
+
+// There is no background thread, so the work is done right away.
+int PlatBackgroundPost(int (*work)(const void *data), const void *data, int size)
+{
+    if (size > PLAT_BACKGROUND_DATA_MAX)
+        return EINVAL;
+
+    return work(data);
+}
+
+int PlatBackgroundFlush(void)
+{
+    return 0;
+}
+
 void PlatDebugInit(void)
 {
     // Get the current time
@@ -258,6 +300,16 @@ void PlatDPrintf(const char *format, ...)
     va_end(args);
 }
 
+// Written directly, as this platform has no background log writer.
+void PlatDLogFrame(int level, unsigned char id, unsigned short int command, const char *frame, int length)
+{
+    while (length > 0 && (frame[length - 1] == '\r' || frame[length - 1] == '\n'))
+        length--;
+
+    if (DebugOutputFile != NULL)
+        fprintf(DebugOutputFile, "%s %02u %03x: %.*s\n", level == PLAT_LOG_TX ? "TX" : "RX", id, command, length, frame);
+}
+
 int pstricmp(const char *s1, const char *s2)
 {
     char s1char, s2char;
@@ -210,6 +210,7 @@ static INT_PTR CALLBACK MainDlg(HWND hwndDlg, UINT uMsg, WPARAM wParam, LPARAM l
                 case IDC_BUTTON_CONNECT:
                     if (ConnectToConsole(hwndDlg) == 0)
                     {
+                        MechaInvalidateModel(); // May be a different console.
                         if (MechaInitModel() == 0)
                         {
                             IsConnected = TRUE;
@@ -0,0 +1,308 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <errno.h>
+
+#include "platform.h"
+#include "mecha.h"
+#include "eeprom.h"
+#include "elect.h"
+#include "main.h"
+#include "pmap.h"
+
+/*  Daemon jobs. Each station keeps its console open, so its ident data and EEPROM map stay cached from one job to the next.
+    Replies are lines that start with:
+        "- " a message, "! " an error message,
+        "? " a prompt, which the client must answer with a line,
+        "+ " data,
+        "= " the result of the job (0 or an error code), after which the connection is closed.
+    Requests:
+        ident                               Console information.
+        read <word>                         EEPROM word (hexadecimal, as are the values).
+        write <word> <value>
+        dump [<region>]                     EEPROM region (number as in the EEPROM menu, 1 = whole EEPROM), 8 words per line.
+        plan <chassis> [<option> ...]       Update plan. chassis is the number as in the EEPROM menu.
+        update <chassis> [<option> ...]     Options: replaced, sanyo, t609k, osd2 (clear the OSD2 init bit).
+        elect [<stage>|resume] [t10k] [profile]
+        mecha <command>[<arguments>]        Raw MECHACON command, e.g. "mecha ce10010". */
+
+#define DAEMON_LINE_MAX 512
+
+static struct PmapSession *DaemonSession;
+static unsigned char LineStarted; // The last message did not end its line.
+
+// Prefixes every line of text, which may also end without a newline.
+static void DaemonSend(const char *prefix, const char *text)
+{
+    char line[DAEMON_LINE_MAX];
+    const char *end;
+    int length;
+
+    while (*text != '\0')
+    {
+        length = (end = strchr(text, '\n')) != NULL ? (int)(end - text) + 1 : (int)strlen(text);
+        snprintf(line, sizeof(line), "%s%.*s", LineStarted ? "" : prefix, length, text);
+        PlatDaemonReply(line);
+        LineStarted = end == NULL;
+        text += length;
+    }
+}
+
+static void DaemonEndLine(void)
+{
+    if (LineStarted)
+        PlatDaemonReply("\n");
+    LineStarted = 0;
+}
+
+static void DaemonMessage(int level, const char *text, void *context)
+{
+    (void)context;
+    DaemonSend(level == PLAT_LOG_ERROR ? "! " : "- ", text);
+}
+
+static void DaemonPrompt(const char *text, void *context)
+{
+    char answer[16];
+
+    (void)context;
+    DaemonEndLine();
+    DaemonSend("? ", text);
+    DaemonEndLine();
+    if (PlatDaemonAnswer(answer, sizeof(answer)) != 0) // The client is gone, so nobody can do what was asked.
+        PmapElectAbort(DaemonSession);
+}
+
+static void DaemonData(const char *format, ...)
+{
+    char line[DAEMON_LINE_MAX];
+    va_list args;
+
+    DaemonEndLine();
+    strcpy(line, "+ ");
+    va_start(args, format);
+    vsnprintf(line + 2, sizeof(line) - 2, format, args);
+    va_end(args);
+    PlatDaemonReply(line);
+}
+
+static int DaemonIdent(void)
+{
+    struct PmapIdent ident;
+    int result;
+
+    if ((result = PmapGetIdent(DaemonSession, MECHA_PROBE_FULL, &ident)) != 0)
+        return result;
+
+    DaemonData("mode %d %d\n", ident.TestMode, ident.MD);
+    DaemonData("cfd %s\n", ident.cfd);
+    DaemonData("cfc %08x\n", ident.cfc);
+    DaemonData("version %04x\n", ident.VersionID);
+    DaemonData("mecha %s (%s)\n", ident.mecha, ident.cex ? "CEX" : "DEX");
+    DaemonData("checksum %s\n", ident.ChecksumOK ? "OK" : "NG");
+    if (ident.HasSerial)
+        DaemonData("serial %07u %02x\n", ident.serial, ident.emcs);
+    DaemonData("modelid %04x\n", ident.ModelID);
+    DaemonData("tv %s\n", ident.TVSystem);
+    if (ident.HasModel)
+        DaemonData("model %s\n", ident.model);
+    DaemonData("rtc %s (%s)\n", ident.rtc, ident.RtcStatus);
+    DaemonData("op %s\n", ident.op);
+    DaemonData("lens %s\n", ident.lens);
+    DaemonData("erased %d\n", ident.erased);
+
+    return 0;
+}
+
+static int DaemonDump(const char *args)
+{
+    const struct EEPROMRegion *region;
+    u16 image[1024 / 2];
+    char line[DAEMON_LINE_MAX];
+    int i, index, result;
+
+    index = args[0] != '\0' ? atoi(args) - 1 : 0;
+    if (index < 0 || (region = EEPROMGetRegion(index)) == NULL)
+        return EINVAL;
+    if ((result = PmapEEPROMDump(DaemonSession, region, image, NULL, NULL)) != 0)
+        return result;
+
+    for (i = region->start; i <= region->end; i++)
+    {
+        if ((i - region->start) % 8 == 0)
+            snprintf(line, sizeof(line), "%03x:", i);
+        snprintf(line + strlen(line), sizeof(line) - strlen(line), " %04x", image[i]);
+        if ((i - region->start) % 8 == 7 || i == region->end)
+            DaemonData("%s\n", line);
+    }
+
+    return 0;
+}
+
+static int DaemonUpdate(const char *args, int commit)
+{
+    struct PmapUpdateOptions options;
+    struct PmapUpdatePlan plan;
+    char option[16];
+    int offset, result;
+
+    memset(&options, 0, sizeof(options));
+    options.op   = MECHA_OP_SONY;
+    options.lens = MECHA_LENS_T487;
+    if (sscanf(args, "%d%n", &options.chassis, &offset) != 1)
+        return EINVAL;
+    options.chassis--;
+    for (args += offset; sscanf(args, "%15s%n", option, &offset) == 1; args += offset)
+    {
+        if (!pstricmp(option, "replaced"))
+            options.ReplacedMecha = 1;
+        else if (!pstricmp(option, "sanyo"))
+            options.op = MECHA_OP_SANYO;
+        else if (!pstricmp(option, "t609k"))
+            options.lens = MECHA_LENS_T609K;
+        else if (!pstricmp(option, "osd2"))
+            options.ClearOSD2InitBit = 1;
+        else
+            return EINVAL;
+    }
+
+    if ((result = PmapUpdatePlan(DaemonSession, &options, &plan)) != 0)
+        return result;
+    DaemonData("regions %04x\n", plan.regions);
+    DaemonData("commands %d\n", plan.commands);
+    DaemonData("duration %u\n", plan.duration);
+
+    if (!commit || plan.regions == 0)
+    {
+        PmapUpdateCancel(DaemonSession);
+        return 0;
+    }
+
+    return PmapUpdateCommit(DaemonSession);
+}
+
+static void DaemonElectStep(int stage, const char *label, u32 duration, int ok, void *context)
+{
+    (void)context;
+    DaemonData("step %s %s %u %s\n", ElectGetStageName(stage), ok ? "OK" : "NG", duration, label);
+}
+
+static void DaemonElectValue(const char *name, float value, float min, float max, int ok, void *context)
+{
+    (void)min;
+    (void)max;
+    (void)context;
+    DaemonData("value %s %g %s\n", ok ? "OK" : "NG", value, name);
+}
+
+static int DaemonElect(const char *args)
+{
+    static const struct PmapElectCallbacks callbacks = {&DaemonElectStep, &DaemonElectValue, NULL};
+    struct PmapElectOptions options = {ELECT_STAGE_CD, 0, 0, 0, &callbacks};
+    char option[16];
+    int offset, stage;
+
+    for (; sscanf(args, "%15s%n", option, &offset) == 1; args += offset)
+    {
+        if (!pstricmp(option, "resume"))
+            options.stage = -1;
+        else if (!pstricmp(option, "t10k"))
+            options.T10K = 1;
+        else if (!pstricmp(option, "profile"))
+            options.profile = 1;
+        else
+        {
+            for (stage = 0; stage < ELECT_STAGE_COUNT && pstricmp(option, ElectGetStageName(stage)); stage++)
+                ;
+            if (stage >= ELECT_STAGE_COUNT)
+                return EINVAL;
+            options.stage = stage;
+        }
+    }
+
+    return PmapElectRun(DaemonSession, &options);
+}
+
+static int DaemonMecha(const char *args)
+{
+    char command[4], reply[MECHA_RX_BUFFER_SIZE];
+    int result;
+
+    if (strlen(args) < 3 || strlen(args) >= 3 + MECHA_TASK_ARGS_MAX)
+        return EINVAL;
+    memcpy(command, args, 3);
+    command[3] = '\0';
+
+    if ((result = PmapMechaCommand(DaemonSession, (unsigned short int)strtoul(command, NULL, 16), args + 3, MECHA_TASK_NORMAL_TO, reply, sizeof(reply))) < 0)
+        return -result;
+    DaemonData("reply %s\n", reply);
+
+    return 0;
+}
+
+static int DaemonRunJob(const char *request)
+{
+    char job[16];
+    unsigned int word, value;
+    int offset, result;
+    u16 data;
+
+    if (sscanf(request, "%15s%n", job, &offset) != 1)
+        return EINVAL;
+    for (request += offset; *request == ' '; request++)
+        ;
+
+    if (!pstricmp(job, "ident"))
+        return DaemonIdent();
+    if (!pstricmp(job, "read"))
+    {
+        if (sscanf(request, "%x", &word) != 1 || word > 0x1FF)
+            return EINVAL;
+        if ((result = PmapEEPROMRead(DaemonSession, (unsigned short int)word, &data)) == 0)
+            DaemonData("%03x %04x\n", word, data);
+        return result;
+    }
+    if (!pstricmp(job, "write"))
+    {
+        if (sscanf(request, "%x %x", &word, &value) != 2 || word > 0x1FF || value > 0xFFFF)
+            return EINVAL;
+        return PmapEEPROMWrite(DaemonSession, (unsigned short int)word, (u16)value);
+    }
+    if (!pstricmp(job, "dump"))
+        return DaemonDump(request);
+    if (!pstricmp(job, "plan"))
+        return DaemonUpdate(request, 0);
+    if (!pstricmp(job, "update"))
+        return DaemonUpdate(request, 1);
+    if (!pstricmp(job, "elect"))
+        return DaemonElect(request);
+    if (!pstricmp(job, "mecha"))
+        return DaemonMecha(request);
+
+    return ENOSYS;
+}
+
+// One station of the daemon: the port stays open from one job to the next.
+int DaemonServe(int station, const char *device)
+{
+    struct PlatHandlers handlers = {&DaemonMessage, &DaemonPrompt, NULL};
+    struct PmapOptions options   = {&handlers, station, 1};
+    char request[PLAT_DAEMON_REQUEST_MAX], result[16];
+    int status;
+
+    if ((status = PmapOpen(device, &options, &DaemonSession)) != 0)
+        return status;
+
+    while (PlatDaemonNextJob(request, sizeof(request)) == 0)
+    {
+        status = DaemonRunJob(request);
+        DaemonEndLine();
+        snprintf(result, sizeof(result), "= %d\n", status);
+        PlatDaemonReply(result);
+    }
+
+    PmapClose(DaemonSession);
+
+    return 0;
+}
@@ -13,26 +13,6 @@ u8 iLinkID[8], ConsoleID[8];
 extern char ConModelName[17];
 extern unsigned char ConMD;
 
-static int EEPROMIDSaveiLinkID(const char *data, int len, int offset)
-{
-    u16 word;
-
-    word                = (u16)strtoul(&data[5], NULL, 16);
-    iLinkID[offset + 1] = word >> 8 & 0xFF;
-    iLinkID[offset]     = word & 0xFF;
-    return 0;
-}
-
-static int EEPROMIDSaveConsoleID(const char *data, int len, int offset)
-{
-    u16 word;
-
-    word                  = (u16)strtoul(&data[5], NULL, 16);
-    ConsoleID[offset + 1] = word >> 8 & 0xFF;
-    ConsoleID[offset]     = word & 0xFF;
-    return 0;
-}
-
 static int EEPROMIDRxHandler(MechaTask_t *task, const char *result, short int len)
 {
     switch (result[0])
@@ -40,22 +20,6 @@ static int EEPROMIDRxHandler(MechaTask_t *task, const char *result, short int le
         case '0': // Rx-OK
             switch (task->tag)
             {
-                case MECHA_CMD_TAG_INIT_ID_ILINK_ID_0:
-                    return EEPROMIDSaveiLinkID(result, len, 0);
-                case MECHA_CMD_TAG_INIT_ID_ILINK_ID_1:
-                    return EEPROMIDSaveiLinkID(result, len, 2);
-                case MECHA_CMD_TAG_INIT_ID_ILINK_ID_2:
-                    return EEPROMIDSaveiLinkID(result, len, 4);
-                case MECHA_CMD_TAG_INIT_ID_ILINK_ID_3:
-                    return EEPROMIDSaveiLinkID(result, len, 6);
-                case MECHA_CMD_TAG_INIT_ID_CON_ID_0:
-                    return EEPROMIDSaveConsoleID(result, len, 0);
-                case MECHA_CMD_TAG_INIT_ID_CON_ID_1:
-                    return EEPROMIDSaveConsoleID(result, len, 2);
-                case MECHA_CMD_TAG_INIT_ID_CON_ID_2:
-                    return EEPROMIDSaveConsoleID(result, len, 4);
-                case MECHA_CMD_TAG_INIT_ID_CON_ID_3:
-                    return EEPROMIDSaveConsoleID(result, len, 6);
                 default:
                     return 0;
             }
@@ -162,53 +126,37 @@ int EEPROMNTSCPALDefaults(int vmode)
 
 int EEPROMInitID(void)
 {
-    char address[5];
-    unsigned char id;
+    u16 iLinkBase, ConBase, word;
+    int result, i;
 
     memset(iLinkID, 0, sizeof(iLinkID));
     memset(ConsoleID, 0, sizeof(ConsoleID));
 
-    id = 1;
-    if (ConMD == 40)
+    if ((result = MechaInitModel()) == 0)
     {
-        snprintf(address, 5, "%04x", EEPROM_MAP_ILINK_ID_NEW_0);
-        MechaCommandAdd(MECHA_CMD_EEPROM_READ, address, id++, MECHA_CMD_TAG_INIT_ID_ILINK_ID_0, MECHA_TASK_NORMAL_TO, "i.Link ID READ");
-        snprintf(address, 5, "%04x", EEPROM_MAP_ILINK_ID_NEW_1);
-        MechaCommandAdd(MECHA_CMD_EEPROM_READ, address, id++, MECHA_CMD_TAG_INIT_ID_ILINK_ID_1, MECHA_TASK_NORMAL_TO, "i.Link ID READ");
-        snprintf(address, 5, "%04x", EEPROM_MAP_ILINK_ID_NEW_2);
-        MechaCommandAdd(MECHA_CMD_EEPROM_READ, address, id++, MECHA_CMD_TAG_INIT_ID_ILINK_ID_2, MECHA_TASK_NORMAL_TO, "i.Link ID READ");
-        snprintf(address, 5, "%04x", EEPROM_MAP_ILINK_ID_NEW_3);
-        MechaCommandAdd(MECHA_CMD_EEPROM_READ, address, id++, MECHA_CMD_TAG_INIT_ID_ILINK_ID_3, MECHA_TASK_NORMAL_TO, "i.Link ID READ");
-        snprintf(address, 5, "%04x", EEPROM_MAP_CON_ID_NEW_0);
-        MechaCommandAdd(MECHA_CMD_EEPROM_READ, address, id++, MECHA_CMD_TAG_INIT_ID_CON_ID_0, MECHA_TASK_NORMAL_TO, "CONSOLE ID READ");
-        snprintf(address, 5, "%04x", EEPROM_MAP_CON_ID_NEW_1);
-        MechaCommandAdd(MECHA_CMD_EEPROM_READ, address, id++, MECHA_CMD_TAG_INIT_ID_CON_ID_1, MECHA_TASK_NORMAL_TO, "CONSOLE ID READ");
-        snprintf(address, 5, "%04x", EEPROM_MAP_CON_ID_NEW_2);
-        MechaCommandAdd(MECHA_CMD_EEPROM_READ, address, id++, MECHA_CMD_TAG_INIT_ID_CON_ID_2, MECHA_TASK_NORMAL_TO, "CONSOLE ID READ");
-        snprintf(address, 5, "%04x", EEPROM_MAP_CON_ID_NEW_3);
-        MechaCommandAdd(MECHA_CMD_EEPROM_READ, address, id++, MECHA_CMD_TAG_INIT_ID_CON_ID_3, MECHA_TASK_NORMAL_TO, "CONSOLE ID READ");
-    }
-    else
-    {
-        snprintf(address, 5, "%04x", EEPROM_MAP_ILINK_ID_0);
-        MechaCommandAdd(MECHA_CMD_EEPROM_READ, address, id++, MECHA_CMD_TAG_INIT_ID_ILINK_ID_0, MECHA_TASK_NORMAL_TO, "i.Link ID READ");
-        snprintf(address, 5, "%04x", EEPROM_MAP_ILINK_ID_1);
-        MechaCommandAdd(MECHA_CMD_EEPROM_READ, address, id++, MECHA_CMD_TAG_INIT_ID_ILINK_ID_1, MECHA_TASK_NORMAL_TO, "i.Link ID READ");
-        snprintf(address, 5, "%04x", EEPROM_MAP_ILINK_ID_2);
-        MechaCommandAdd(MECHA_CMD_EEPROM_READ, address, id++, MECHA_CMD_TAG_INIT_ID_ILINK_ID_2, MECHA_TASK_NORMAL_TO, "i.Link ID READ");
-        snprintf(address, 5, "%04x", EEPROM_MAP_ILINK_ID_3);
-        MechaCommandAdd(MECHA_CMD_EEPROM_READ, address, id++, MECHA_CMD_TAG_INIT_ID_ILINK_ID_3, MECHA_TASK_NORMAL_TO, "i.Link ID READ");
-        snprintf(address, 5, "%04x", EEPROM_MAP_CON_ID_0);
-        MechaCommandAdd(MECHA_CMD_EEPROM_READ, address, id++, MECHA_CMD_TAG_INIT_ID_CON_ID_0, MECHA_TASK_NORMAL_TO, "CONSOLE ID READ");
-        snprintf(address, 5, "%04x", EEPROM_MAP_CON_ID_1);
-        MechaCommandAdd(MECHA_CMD_EEPROM_READ, address, id++, MECHA_CMD_TAG_INIT_ID_CON_ID_1, MECHA_TASK_NORMAL_TO, "CONSOLE ID READ");
-        snprintf(address, 5, "%04x", EEPROM_MAP_CON_ID_2);
-        MechaCommandAdd(MECHA_CMD_EEPROM_READ, address, id++, MECHA_CMD_TAG_INIT_ID_CON_ID_2, MECHA_TASK_NORMAL_TO, "CONSOLE ID READ");
-        snprintf(address, 5, "%04x", EEPROM_MAP_CON_ID_3);
-        MechaCommandAdd(MECHA_CMD_EEPROM_READ, address, id++, MECHA_CMD_TAG_INIT_ID_CON_ID_3, MECHA_TASK_NORMAL_TO, "CONSOLE ID READ");
+        if (ConMD == 40)
+        {
+            iLinkBase = EEPROM_MAP_ILINK_ID_NEW_0;
+            ConBase   = EEPROM_MAP_CON_ID_NEW_0;
+        }
+        else
+        {
+            iLinkBase = EEPROM_MAP_ILINK_ID_0;
+            ConBase   = EEPROM_MAP_CON_ID_0;
+        }
+
+        for (i = 0; i < 4; i++)
+        {
+            word                 = EEPMapRead(iLinkBase + i);
+            iLinkID[i * 2 + 1]   = word >> 8 & 0xFF;
+            iLinkID[i * 2]       = word & 0xFF;
+            word                 = EEPMapRead(ConBase + i);
+            ConsoleID[i * 2 + 1] = word >> 8 & 0xFF;
+            ConsoleID[i * 2]     = word & 0xFF;
+        }
     }
 
-    return MechaCommandExecuteList(NULL, &EEPROMIDRxHandler);
+    return result;
 }
 
 void EEPROMGetiLinkID(u8 *id)
@@ -9,37 +9,79 @@
 #include "mecha.h"
 #include "eeprom.h"
 #include "updates.h"
+#include "pmap.h"
 
-static int DumpEEPROM(const char *filename)
+static void ShowProgress(int done, int total, void *context)
 {
+    int progress;
+
+    *(int *)context = done; // The word being transferred, for error messages.
+
+    putchar('\r');
+    PlatShowMessage("Progress: ");
+    putchar('[');
+    for (progress = 0; progress <= (done * 20 / total); progress++)
+        putchar('#');
+    for (; progress < 20; progress++)
+        putchar(' ');
+    putchar(']');
+}
+
+// Fills the words from the end of the image up to (but not including) word end with 0xFFFF, as in an erased EEPROM.
+static int PadEEPROMImage(FILE *dump, int end)
+{
+    const u16 erased = 0xFFFF;
+    long int size;
+
+    if (fseek(dump, 0, SEEK_END) != 0 || (size = ftell(dump)) < 0)
+        return -EIO;
+    for (size /= sizeof(u16); size < end; size++)
+    {
+        if (fwrite(&erased, sizeof(u16), 1, dump) != 1)
+            return -EIO;
+    }
+
+    return 0;
+}
+
+/*  Images always keep the layout of a full dump (word N at offset N * 2).
+    Dumping a region into an existing image only replaces that region's words,
+    so several partial dumps can be merged into the same file.
+    The other words of a new image are 0xFFFF (erased), never 0x0000. */
+static int DumpEEPROM(const char *filename, const struct EEPROMRegion *region)
+{
+    u16 image[1024 / 2];
     FILE *dump;
-    int i, progress, result;
-    u16 data;
+    int count, done, result, created;
 
-    PlatShowMessage("\nDumping EEPROM:\n");
-    if ((dump = fopen(filename, "wb")) != NULL)
+    count = region->end - region->start + 1;
+    PlatShowMessage("\nDumping EEPROM (%s):\n", region->name);
+    created = 0;
+    if (count == 1024 / 2 || (dump = fopen(filename, "r+b")) == NULL)
     {
-        for (i = 0; i < 1024 / 2; i++)
-        {
-            putchar('\r');
-            PlatShowMessage("Progress: ");
-            putchar('[');
-            for (progress = 0; progress <= (i * 20 / 512); progress++)
-                putchar('#');
-            for (; progress < (512 * 20 / 512); progress++)
-                putchar(' ');
-            putchar(']');
-
-            if ((result = EEPROMReadWord(i, &data)) != 0)
-            {
-                PlatShowMessage("EEPROM read error %d:%d\n", i, result);
-                break;
-            }
-            if (fwrite(&data, sizeof(u16), 1, dump) != 1)
-                break;
-        }
+        dump    = fopen(filename, "wb");
+        created = 1;
+    }
+
+    if (dump != NULL)
+    {
+        done = 0;
+        // Do not leave a gap of zeros before the region, if the image is shorter.
+        if (PadEEPROMImage(dump, region->start) != 0 || fseek(dump, region->start * sizeof(u16), SEEK_SET) != 0)
+            result = -EIO;
+        else if ((result = PmapEEPROMDump(ConsoleSession, region, image, &ShowProgress, &done)) != 0)
+            PlatShowMessage("EEPROM read error %d:%d\n", region->start + done, result);
+        else
+            done = count;
         putchar('\n');
 
+        // Whatever was read before an error is kept.
+        if (done > 0 && fwrite(&image[region->start], sizeof(u16), done, dump) != (size_t)done && result == 0)
+            result = -EIO;
+        // Only once the region is complete, so that a restore still reports the words that could not be read.
+        if (result == 0 && created)
+            result = PadEEPROMImage(dump, 1024 / 2);
+
         fclose(dump);
     }
     else
@@ -48,33 +90,36 @@ static int DumpEEPROM(const char *filename)
     return result;
 }
 
-static int RestoreEEPROM(const char *filename)
+static int RestoreEEPROM(const char *filename, const struct EEPROMRegion *region)
 {
+    struct EEPROMRegion available;
+    u16 image[1024 / 2];
     FILE *dump;
-    int i, progress, result;
-    u16 data;
+    int count, done, result;
 
-    PlatShowMessage("\nRestoring EEPROM:\n");
+    count = region->end - region->start + 1;
+    PlatShowMessage("\nRestoring EEPROM (%s):\n", region->name);
     if ((dump = fopen(filename, "rb")) != NULL)
     {
-        for (i = 0; i < 1024 / 2; i++)
+        available = *region;
+        if (fseek(dump, region->start * sizeof(u16), SEEK_SET) != 0)
+            result = -EIO;
+        else
         {
-            putchar('\r');
-            PlatShowMessage("Progress: ");
-            putchar('[');
-            for (progress = 0; progress <= (i * 20 / 512); progress++)
-                putchar('#');
-            for (; progress < (512 * 20 / 512); progress++)
-                putchar(' ');
-            putchar(']');
-
-            if (fread(&data, sizeof(u16), 1, dump) != 1)
-                break;
-
-            if ((result = EEPROMWriteWord(i, data)) != 0)
+            // The words that the image contains are restored, before reporting the first one that is missing.
+            count  = (int)fread(&image[region->start], sizeof(u16), count, dump);
+            result = 0;
+            done   = 0;
+            if (count > 0)
             {
-                PlatShowMessage("EEPROM write error %d:%d\n", i, result);
-                break;
+                available.end = region->start + count - 1;
+                if ((result = PmapEEPROMRestore(ConsoleSession, &available, image, &ShowProgress, &done)) != 0)
+                    PlatShowMessage("EEPROM write error %d:%d\n", region->start + done, result);
+            }
+            if (result == 0 && region->start + count <= region->end)
+            {
+                PlatShowMessage("Image does not contain word %d.\n", region->start + count);
+                result = -EIO;
             }
         }
         putchar('\n');
@@ -87,41 +132,42 @@ static int RestoreEEPROM(const char *filename)
     return result;
 }
 
-#define EEPROM_UPDATE_FLAG_SANYO    1 // Supports SANYO OP
-#define EEPROM_UPDATE_FLAG_NEW_SONY 2 // No support for the old T487
+static const struct EEPROMRegion *SelectEEPROMRegion(void)
+{
+    const struct EEPROMRegion *region;
+    int i, choice;
+
+    PlatShowMessage("Region:\n");
+    for (i = 0; (region = EEPROMGetRegion(i)) != NULL; i++)
+        PlatShowMessage("\t%2d. %s (0x%03x-0x%03x)\n", i + 1, region->name, region->start, region->end);
+
+    do
+    {
+        PlatShowMessage("Choice: ");
+        choice = 0;
+        if (scanf("%d", &choice) > 0)
+            while (getchar() != '\n')
+            {
+            };
+    } while (choice < 1 || choice > i);
+
+    return EEPROMGetRegion(choice - 1);
+}
 
 static int UpdateEEPROM(int chassis)
 {
-    struct UpdateData
-    {
-        int (*update)(int ClearOSD2InitBit, int ReplacedMecha, int lens, int opt);
-        unsigned int flags;
-    };
-    int ClearOSD2InitBit, ReplacedMecha, OpticalBlock, ObjectLens, result;
+    struct PmapUpdateOptions options;
+    struct PmapUpdatePlan plan;
+    int OpticalBlock, ObjectLens, result;
+    unsigned int questions;
     char choice;
-    struct UpdateData *selected;
-    struct UpdateData data[MECHA_CHASSIS_MODEL_COUNT] = {
-        {&MechaUpdateChassisCex10000, 0},
-        {&MechaUpdateChassisA, 0},
-        {&MechaUpdateChassisAB, 0},
-        {&MechaUpdateChassisB, 0},
-        {&MechaUpdateChassisC, 0},
-        {&MechaUpdateChassisD, 0},
-        {&MechaUpdateChassisF, EEPROM_UPDATE_FLAG_SANYO},
-        {&MechaUpdateChassisG, EEPROM_UPDATE_FLAG_SANYO | EEPROM_UPDATE_FLAG_NEW_SONY},
-        {&MechaUpdateChassisH, EEPROM_UPDATE_FLAG_SANYO | EEPROM_UPDATE_FLAG_NEW_SONY},
-        {&MechaUpdateChassisDexA, 0},
-        {&MechaUpdateChassisDexA2, 0},
-        {&MechaUpdateChassisDexA3, 0},
-        {&MechaUpdateChassisDexB, 0},
-        {&MechaUpdateChassisDexD, 0},
-        {&MechaUpdateChassisDexH, EEPROM_UPDATE_FLAG_SANYO | EEPROM_UPDATE_FLAG_NEW_SONY},
-    };
 
     PlatShowMessage("Update EEPROM\n\n");
     if (chassis >= 0)
     {
-        selected = &data[chassis];
+        if ((result = PmapUpdateGetQuestions(ConsoleSession, chassis, &questions)) != 0)
+            return result;
+        options.chassis = chassis;
 
         do
         {
@@ -131,9 +177,9 @@ static int UpdateEEPROM(int chassis)
             {
             };
         } while (choice != 'y' && choice != 'n');
-        ReplacedMecha = choice == 'y';
+        options.ReplacedMecha = choice == 'y';
 
-        if (selected->flags & EEPROM_UPDATE_FLAG_SANYO)
+        if (questions & PMAP_UPDATE_ASK_OP)
         {
             do
             {
@@ -152,7 +198,7 @@ static int UpdateEEPROM(int chassis)
         else
             OpticalBlock = MECHA_OP_SONY;
 
-        if (!(selected->flags & EEPROM_UPDATE_FLAG_NEW_SONY) && (OpticalBlock != MECHA_OP_SANYO))
+        if ((questions & PMAP_UPDATE_ASK_LENS) && (OpticalBlock != MECHA_OP_SANYO))
         {
             do
             {
@@ -171,7 +217,7 @@ static int UpdateEEPROM(int chassis)
         else
             ObjectLens = MECHA_LENS_T487;
 
-        if (EEPROMCanClearOSD2InitBit(chassis))
+        if (questions & PMAP_UPDATE_ASK_OSD2)
         {
             do
             {
@@ -181,39 +227,44 @@ static int UpdateEEPROM(int chassis)
                 {
                 };
             } while (choice != 'y' && choice != 'n');
-            ClearOSD2InitBit = choice == 'y';
+            options.ClearOSD2InitBit = choice == 'y';
         }
         else
-            ClearOSD2InitBit = 0;
+            options.ClearOSD2InitBit = 0;
+        options.lens = ObjectLens;
+        options.op   = OpticalBlock;
 
-        if ((result = selected->update(ClearOSD2InitBit, ReplacedMecha, ObjectLens, OpticalBlock)) > 0)
+        if ((result = PmapUpdatePlan(ConsoleSession, &options, &plan)) == 0 && plan.regions > 0)
         {
             PlatShowMessage("Actions available:\n");
-            if (result & UPDATE_REGION_EEP_ECR)
+            if (plan.regions & UPDATE_REGION_EEP_ECR)
                 PlatShowMessage("\tEEPROM ECR\n");
-            if (result & UPDATE_REGION_DISCDET)
+            if (plan.regions & UPDATE_REGION_DISCDET)
                 PlatShowMessage("\tDisc detect\n");
-            if (result & UPDATE_REGION_SERVO)
+            if (plan.regions & UPDATE_REGION_SERVO)
                 PlatShowMessage("\tServo\n");
-            if (result & UPDATE_REGION_TILT)
+            if (plan.regions & UPDATE_REGION_TILT)
                 PlatShowMessage("\tAuto-tilt\n");
-            if (result & UPDATE_REGION_TRAY)
+            if (plan.regions & UPDATE_REGION_TRAY)
                 PlatShowMessage("\tTray\n");
-            if (result & UPDATE_REGION_EEGS)
+            if (plan.regions & UPDATE_REGION_EEGS)
                 PlatShowMessage("\tEE & GS\n");
-            if (result & UPDATE_REGION_ECR)
+            if (plan.regions & UPDATE_REGION_ECR)
                 PlatShowMessage("\tRTC ECR\n");
-            if (result & UPDATE_REGION_RTC)
+            if (plan.regions & UPDATE_REGION_RTC)
             {
                 PlatShowMessage("\tRTC:\n");
-                if (result & UPDATE_REGION_RTC_CTL12)
+                if (plan.regions & UPDATE_REGION_RTC_CTL12)
                     PlatShowMessage("\t\tRTC CTL1,2 ERROR\n");
-                if (result & UPDATE_REGION_RTC_TIME)
+                if (plan.regions & UPDATE_REGION_RTC_TIME)
                     PlatShowMessage("\t\tRTC TIME ERROR\n");
             }
-            if (result & UPDATE_REGION_DEFAULTS)
+            if (plan.regions & UPDATE_REGION_DEFAULTS)
                 PlatShowMessage("\tMechacon defaults\n");
 
+            PlatShowMessage("\n");
+            MechaCommandSimulateList(NULL);
+
             do
             {
                 PlatShowMessage("Proceed with updates? (y/n) ");
@@ -224,16 +275,17 @@ static int UpdateEEPROM(int chassis)
             } while (choice != 'y' && choice != 'n');
             if (choice == 'y')
             {
-                return MechaCommandExecuteList(NULL, NULL);
+                return PmapUpdateCommit(ConsoleSession);
             }
             else
             {
-                MechaCommandListClear();
+                PmapUpdateCancel(ConsoleSession);
                 result = 0;
             }
         }
         else
         {
+            PmapUpdateCancel(ConsoleSession);
             PlatShowMessage("An error occurred. Wrong chassis selected?, result = %d\n", result);
         }
 
@@ -248,37 +300,34 @@ static int UpdateEEPROM(int chassis)
 
 static int SelectChassis(void)
 {
-    typedef int (*ChassisProbe_t)(void);
-    struct ChassisData
-    {
-        ChassisProbe_t probe;
-        const char *label;
-    };
-    struct ChassisData data[MECHA_CHASSIS_MODEL_COUNT] = {
-        {&IsChassisCex10000, "A-chassis (SCPH-10000/SCPH-15000, GH-001/3)"},
-        {&IsChassisA, "A-chassis (SCPH-15000/SCPH-18000+ with TI RF-AMP, GH-003)"},
-        {&IsChassisB, "AB-chassis (SCPH-18000, GH-008)"},
-        {&IsChassisB, "B-chassis (SCPH-30001 with Auto-Tilt motor)"},
-        {&IsChassisC, "C-chassis (SCPH-30001/2/3/4)"},
-        {&IsChassisD, "D-chassis (SCPH-300xx/SCPH-350xx)"},
-        {&IsChassisF, "F-chassis (SCPH-30000/SCPH-300xx R)"},
-        {&IsChassisG, "G-chassis (SCPH-390xx)"},
-        {&IsChassisDragon, "Dragon (SCPH-5x0xx--SCPH-900xx)"},
-        {&IsChassisDexA, "A-chassis (DTL-H10000)"},  // A
-        {&IsChassisDexA, "A-chassis (DTL-T10000H)"}, // A2
-        {&IsChassisDexA, "A-chassis (DTL-T10000)"},  // A3
-        {&IsChassisDexB, "B-chassis (DTL-H30001/2 with Auto-Tilt motor)"},
-        {&IsChassisDexD, "D-chassis (DTL-H30x0x)"},
-        {&IsChassisDragon, "Dragon (DTL-5x0xx--DTL-900xx)"}};
+    static const char *labels[MECHA_CHASSIS_MODEL_COUNT] = {
+        "A-chassis (SCPH-10000/SCPH-15000, GH-001/3)",
+        "A-chassis (SCPH-15000/SCPH-18000+ with TI RF-AMP, GH-003)",
+        "AB-chassis (SCPH-18000, GH-008)",
+        "B-chassis (SCPH-30001 with Auto-Tilt motor)",
+        "C-chassis (SCPH-30001/2/3/4)",
+        "D-chassis (SCPH-300xx/SCPH-350xx)",
+        "F-chassis (SCPH-30000/SCPH-300xx R)",
+        "G-chassis (SCPH-390xx)",
+        "Dragon (SCPH-5x0xx--SCPH-900xx)",
+        "A-chassis (DTL-H10000)",  // A
+        "A-chassis (DTL-T10000H)", // A2
+        "A-chassis (DTL-T10000)",  // A3
+        "B-chassis (DTL-H30001/2 with Auto-Tilt motor)",
+        "D-chassis (DTL-H30x0x)",
+        "Dragon (DTL-5x0xx--DTL-900xx)"};
+    unsigned int candidates;
     int SelectCount, LastSelectIndex, i, choice;
 
     DisplayCommonConsoleInfo();
+    if (PmapGetChassisCandidates(ConsoleSession, &candidates) != 0)
+        candidates = 0;
     PlatShowMessage("Chassis:\n");
     for (i = 0, SelectCount = 0, LastSelectIndex = -1; i < MECHA_CHASSIS_MODEL_COUNT; i++)
     {
-        if (data[i].probe() != 0)
+        if (candidates & (1u << i))
         {
-            PlatShowMessage("\t%2d. %s\n", i + 1, data[i].label);
+            PlatShowMessage("\t%2d. %s\n", i + 1, labels[i]);
             SelectCount++;
             LastSelectIndex = i;
         }
@@ -334,11 +383,8 @@ void MenuEEPROM(void)
     done = 0;
     do
     {
-        if (MechaInitModel() != 0)
-        {
-            DisplayConnHelp();
+        if (ProbeConsole(MECHA_PROBE_FULL) != 0)
             return;
-        }
         if (IsOutdatedBCModel())
             PlatShowMessage("B/C-chassis: EEPROM update required.\n");
         if (chassis < 0)
@@ -386,19 +432,13 @@ void MenuEEPROM(void)
             case 2:
                 char useDefault;
                 char default_filename[256];
-                u32 serial = 0;
-                u8 emcs    = 0;
-
-                if (EEPROMInitSerial() == 0)
-                    EEPROMGetSerial(&serial, &emcs);
-
-                const char *model = EEPROMGetModelName();
+                struct PmapIdent ident;
 
-                const struct MechaIdentRaw *RawData;
-                RawData = MechaGetRawIdent();
+                if (ProbeConsole(MECHA_PROBE_FULL) != 0 || PmapGetIdent(ConsoleSession, MECHA_PROBE_FULL, &ident) != 0)
+                    break;
 
                 // Format the filename
-                snprintf(default_filename, sizeof(default_filename), "%s_%07u_%s_%#08x.bin", model, serial, RawData->cfd, RawData->cfc);
+                snprintf(default_filename, sizeof(default_filename), "%s_%07u_%s_%#08x.bin", ident.model, ident.serial, ident.cfd, ident.cfc);
 
                 PlatShowMessage("Default filename: %s\n", default_filename);
                 PlatShowMessage("Do you want to use the default filename? (Y/N): ");
@@ -417,7 +457,7 @@ void MenuEEPROM(void)
                         filename[strlen(filename) - 1] = '\0';
                 }
 
-                PlatShowMessage("Dump %s.\n", DumpEEPROM(filename) == 0 ? "completed" : "failed");
+                PlatShowMessage("Dump %s.\n", DumpEEPROM(filename, SelectEEPROMRegion()) == 0 ? "completed" : "failed");
                 break;
             case 3:
                 PlatShowMessage("Enter dump filename: ");
@@ -425,7 +465,7 @@ void MenuEEPROM(void)
                 {
                     filename[strlen(filename) - 1] = '\0';
                     // gets(filename);
-                    PlatShowMessage("Restore %s.\n", RestoreEEPROM(filename) == 0 ? "completed" : "failed");
+                    PlatShowMessage("Restore %s.\n", RestoreEEPROM(filename, SelectEEPROMRegion()) == 0 ? "completed" : "failed");
                 }
                 break;
             case 4:
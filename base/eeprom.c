@@ -7,6 +7,7 @@
 #include "platform.h"
 #include "mecha.h"
 #include "eeprom.h"
+#include "updates.h"
 
 extern unsigned char ConMD, ConType, ConRTC, ConRTCStat;
 u8 ConEmcs;
@@ -15,9 +16,26 @@ char ConModelName[17];
 static u16 EEP[0x200];
 static u32 EEPMap[0x400 / sizeof(u32)];
 
+/*  Some regions overlap: on the Dragon, the tray parameters are gone and
+    0xF0-0xFB hold the i.Link and console IDs instead. */
+static const struct EEPROMRegion EEPRegions[] = {
+    {"Whole EEPROM", 0x000, 0x1FF, 0},
+    {"Disc detect", 0x006, 0x006, UPDATE_REGION_DISCDET},
+    {"OP/lens", EEPROM_MAP_CON, EEPROM_MAP_OPT_13, UPDATE_REGION_SERVO},
+    {"Servo", 0x021, 0x04B, UPDATE_REGION_SERVO | UPDATE_REGION_EEP_ECR},
+    {"Auto-tilt", 0x0C0, 0x0C4, UPDATE_REGION_TILT},
+    {"Model name", EEPROM_MAP_MODEL_NAME_0, EEPROM_MAP_MODEL_NAME_NEW_7, 0},
+    {"i.Link & console ID", EEPROM_MAP_ILINK_ID_0, EEPROM_MAP_CON_ID_3, 0},
+    {"Tray", 0x0F1, 0x0FB, UPDATE_REGION_TRAY},
+    {"i.Link & console ID (Dragon)", EEPROM_MAP_ILINK_ID_NEW_0, EEPROM_MAP_CON_ID_NEW_3, 0},
+    {"EE & GS", EEPROM_MAP_EEGS_NEW_0, EEPROM_MAP_EEGS_7, UPDATE_REGION_EEGS},
+    {"OSD2 (Dragon)", EEPROM_MAP_OSD2_NEW_0, EEPROM_MAP_OSD2_NEW_7, 0},
+    {"OSD2", EEPROM_MAP_OSD2_0, EEPROM_MAP_OSD2_7, 0},
+    {NULL, 0, 0, 0}};
+
 u16 EEPMapRead(u16 word)
 {
-    if (EEPMap[word / 32] & (1 << (word % 32)))
+    if (EEPMap[word / 32] & (1u << (word % 32)))
         return EEP[word];
     else
     {
@@ -30,7 +48,7 @@ u16 EEPMapRead(u16 word)
 void EEPMapWrite(u16 word, u16 data)
 {
     EEP[word] = data;
-    EEPMap[word / 32] |= (1 << (word % 32));
+    EEPMap[word / 32] |= (1u << (word % 32));
 }
 
 void EEPMapClear(void)
@@ -39,83 +57,17 @@ void EEPMapClear(void)
     memset(EEP, 0xFF, sizeof(EEP));
 }
 
-static int EEPROMSaveSerial0(const char *data, int len)
+int EEPMapIsValid(u16 word)
 {
-    u16 word;
-
-    word = (u16)strtoul(&data[5], NULL, 16);
-    ConSerial |= word;
-    return 0;
+    return (EEPMap[word / 32] & (1u << (word % 32))) != 0;
 }
 
-static int EEPROMSaveSerial1(const char *data, int len)
+const struct EEPROMRegion *EEPROMGetRegion(int index)
 {
-    u16 word;
-
-    word = (u16)strtoul(&data[5], NULL, 16);
-    ConSerial |= ((word & 0xFF) << 16);
-    ConEmcs = word >> 8;
+    if (index < 0 || index >= (int)(sizeof(EEPRegions) / sizeof(EEPRegions[0])) - 1)
+        return NULL;
 
-    return 0;
-}
-
-static int EEPROMSaveModelName(const char *data, int len, int offset)
-{
-    u16 word;
-
-    word                     = (u16)strtoul(&data[5], NULL, 16);
-    ConModelName[offset + 1] = word >> 8 & 0xFF;
-    ConModelName[offset]     = word & 0xFF;
-    return 0;
-}
-
-static int EEPROMRxHandler(MechaTask_t *task, const char *result, short int len)
-{
-    switch (result[0])
-    {
-        case '0': // Rx-OK
-            switch (task->tag)
-            {
-                case MECHA_CMD_TAG_EEPROM_SERIAL_0:
-                    return EEPROMSaveSerial0(result, len);
-                case MECHA_CMD_TAG_EEPROM_SERIAL_1:
-                    return EEPROMSaveSerial1(result, len);
-                case MECHA_CMD_TAG_EEPROM_MODEL_NAME_0:
-                    return EEPROMSaveModelName(result, len, 0);
-                case MECHA_CMD_TAG_EEPROM_MODEL_NAME_1:
-                    return EEPROMSaveModelName(result, len, 2);
-                case MECHA_CMD_TAG_EEPROM_MODEL_NAME_2:
-                    return EEPROMSaveModelName(result, len, 4);
-                case MECHA_CMD_TAG_EEPROM_MODEL_NAME_3:
-                    return EEPROMSaveModelName(result, len, 6);
-                case MECHA_CMD_TAG_EEPROM_MODEL_NAME_4:
-                    return EEPROMSaveModelName(result, len, 8);
-                case MECHA_CMD_TAG_EEPROM_MODEL_NAME_5:
-                    return EEPROMSaveModelName(result, len, 10);
-                case MECHA_CMD_TAG_EEPROM_MODEL_NAME_6:
-                    return EEPROMSaveModelName(result, len, 12);
-                case MECHA_CMD_TAG_EEPROM_MODEL_NAME_7:
-                    return EEPROMSaveModelName(result, len, 14);
-                default:
-                    return 0;
-            }
-            break;
-        case '1': // Rx-NGErr
-            switch (task->tag)
-            {
-                default:
-                    return MechaDefaultHandleRes1(task, result, len);
-            }
-            break;
-        case '2': // Rx-NGBadCmd
-            switch (task->tag)
-            {
-                default:
-                    return MechaDefaultHandleRes2(task, result, len);
-            }
-        default:
-            return MechaDefaultHandleResUnknown(task, result, len);
-    }
+    return &EEPRegions[index];
 }
 
 int EEPROMReadWord(unsigned short int word, u16 *data)
@@ -507,31 +459,27 @@ int EEPROMDefaultSanyoOP(void)
 
 int EEPROMInitSerial(void)
 {
+    u16 word0, word1;
     int result;
-    char address[5];
-    unsigned char id;
 
-    id        = 1;
     ConSerial = 0;
     ConEmcs   = 0;
-    if (ConMD == 40)
-    {
-        snprintf(address, 5, "%04x", EEPROM_MAP_SERIAL_NEW_0);
-        MechaCommandAdd(MECHA_CMD_EEPROM_READ, address, id++, MECHA_CMD_TAG_EEPROM_SERIAL_0, MECHA_TASK_NORMAL_TO, "SERIAL READ");
-        snprintf(address, 5, "%04x", EEPROM_MAP_SERIAL_NEW_1);
-        MechaCommandAdd(MECHA_CMD_EEPROM_READ, address, id++, MECHA_CMD_TAG_EEPROM_SERIAL_1, MECHA_TASK_NORMAL_TO, "SERIAL READ");
-    }
-    else
+    if ((result = MechaInitModel()) == 0)
     {
-        snprintf(address, 5, "%04x", EEPROM_MAP_SERIAL_0);
-        MechaCommandAdd(MECHA_CMD_EEPROM_READ, address, id++, MECHA_CMD_TAG_EEPROM_SERIAL_0, MECHA_TASK_NORMAL_TO, "SERIAL READ");
-        snprintf(address, 5, "%04x", EEPROM_MAP_SERIAL_1);
-        MechaCommandAdd(MECHA_CMD_EEPROM_READ, address, id++, MECHA_CMD_TAG_EEPROM_SERIAL_1, MECHA_TASK_NORMAL_TO, "SERIAL READ");
-    }
+        if (ConMD == 40)
+        {
+            word0 = EEPMapRead(EEPROM_MAP_SERIAL_NEW_0);
+            word1 = EEPMapRead(EEPROM_MAP_SERIAL_NEW_1);
+        }
+        else
+        {
+            word0 = EEPMapRead(EEPROM_MAP_SERIAL_0);
+            word1 = EEPMapRead(EEPROM_MAP_SERIAL_1);
+        }
 
-    if ((result = MechaCommandExecuteList(NULL, &EEPROMRxHandler)) == 0)
-    {
-        result = (ConSerial == 0 || ConSerial == 0x00FFFFFF);
+        ConSerial = word0 | ((word1 & 0xFF) << 16);
+        ConEmcs   = word1 >> 8;
+        result    = (ConSerial == 0 || ConSerial == 0x00FFFFFF);
     }
 
     return result;
@@ -539,52 +487,20 @@ int EEPROMInitSerial(void)
 
 int EEPROMInitModelName(void)
 {
-    int result;
-    char address[5];
-    unsigned char id;
+    u16 base, word;
+    int result, i;
 
-    id = 1;
     memset(ConModelName, 0, sizeof(ConModelName));
-    if (ConMD == 40)
-    {
-        snprintf(address, 5, "%04x", EEPROM_MAP_MODEL_NAME_NEW_0);
-        MechaCommandAdd(MECHA_CMD_EEPROM_READ, address, id++, MECHA_CMD_TAG_EEPROM_MODEL_NAME_0, MECHA_TASK_NORMAL_TO, "M NAME READ");
-        snprintf(address, 5, "%04x", EEPROM_MAP_MODEL_NAME_NEW_1);
-        MechaCommandAdd(MECHA_CMD_EEPROM_READ, address, id++, MECHA_CMD_TAG_EEPROM_MODEL_NAME_1, MECHA_TASK_NORMAL_TO, "M NAME READ");
-        snprintf(address, 5, "%04x", EEPROM_MAP_MODEL_NAME_NEW_2);
-        MechaCommandAdd(MECHA_CMD_EEPROM_READ, address, id++, MECHA_CMD_TAG_EEPROM_MODEL_NAME_2, MECHA_TASK_NORMAL_TO, "M NAME READ");
-        snprintf(address, 5, "%04x", EEPROM_MAP_MODEL_NAME_NEW_3);
-        MechaCommandAdd(MECHA_CMD_EEPROM_READ, address, id++, MECHA_CMD_TAG_EEPROM_MODEL_NAME_3, MECHA_TASK_NORMAL_TO, "M NAME READ");
-        snprintf(address, 5, "%04x", EEPROM_MAP_MODEL_NAME_NEW_4);
-        MechaCommandAdd(MECHA_CMD_EEPROM_READ, address, id++, MECHA_CMD_TAG_EEPROM_MODEL_NAME_4, MECHA_TASK_NORMAL_TO, "M NAME READ");
-        snprintf(address, 5, "%04x", EEPROM_MAP_MODEL_NAME_NEW_5);
-        MechaCommandAdd(MECHA_CMD_EEPROM_READ, address, id++, MECHA_CMD_TAG_EEPROM_MODEL_NAME_5, MECHA_TASK_NORMAL_TO, "M NAME READ");
-        snprintf(address, 5, "%04x", EEPROM_MAP_MODEL_NAME_NEW_6);
-        MechaCommandAdd(MECHA_CMD_EEPROM_READ, address, id++, MECHA_CMD_TAG_EEPROM_MODEL_NAME_6, MECHA_TASK_NORMAL_TO, "M NAME READ");
-        snprintf(address, 5, "%04x", EEPROM_MAP_MODEL_NAME_NEW_7);
-        MechaCommandAdd(MECHA_CMD_EEPROM_READ, address, id++, MECHA_CMD_TAG_EEPROM_MODEL_NAME_7, MECHA_TASK_NORMAL_TO, "M NAME READ");
-    }
-    else
-    {
-        snprintf(address, 5, "%04x", EEPROM_MAP_MODEL_NAME_0);
-        MechaCommandAdd(MECHA_CMD_EEPROM_READ, address, id++, MECHA_CMD_TAG_EEPROM_MODEL_NAME_0, MECHA_TASK_NORMAL_TO, "M NAME READ");
-        snprintf(address, 5, "%04x", EEPROM_MAP_MODEL_NAME_1);
-        MechaCommandAdd(MECHA_CMD_EEPROM_READ, address, id++, MECHA_CMD_TAG_EEPROM_MODEL_NAME_1, MECHA_TASK_NORMAL_TO, "M NAME READ");
-        snprintf(address, 5, "%04x", EEPROM_MAP_MODEL_NAME_2);
-        MechaCommandAdd(MECHA_CMD_EEPROM_READ, address, id++, MECHA_CMD_TAG_EEPROM_MODEL_NAME_2, MECHA_TASK_NORMAL_TO, "M NAME READ");
-        snprintf(address, 5, "%04x", EEPROM_MAP_MODEL_NAME_3);
-        MechaCommandAdd(MECHA_CMD_EEPROM_READ, address, id++, MECHA_CMD_TAG_EEPROM_MODEL_NAME_3, MECHA_TASK_NORMAL_TO, "M NAME READ");
-        snprintf(address, 5, "%04x", EEPROM_MAP_MODEL_NAME_4);
-        MechaCommandAdd(MECHA_CMD_EEPROM_READ, address, id++, MECHA_CMD_TAG_EEPROM_MODEL_NAME_4, MECHA_TASK_NORMAL_TO, "M NAME READ");
-        snprintf(address, 5, "%04x", EEPROM_MAP_MODEL_NAME_5);
-        MechaCommandAdd(MECHA_CMD_EEPROM_READ, address, id++, MECHA_CMD_TAG_EEPROM_MODEL_NAME_5, MECHA_TASK_NORMAL_TO, "M NAME READ");
-        snprintf(address, 5, "%04x", EEPROM_MAP_MODEL_NAME_6);
-        MechaCommandAdd(MECHA_CMD_EEPROM_READ, address, id++, MECHA_CMD_TAG_EEPROM_MODEL_NAME_6, MECHA_TASK_NORMAL_TO, "M NAME READ");
-        snprintf(address, 5, "%04x", EEPROM_MAP_MODEL_NAME_7);
-        MechaCommandAdd(MECHA_CMD_EEPROM_READ, address, id++, MECHA_CMD_TAG_EEPROM_MODEL_NAME_7, MECHA_TASK_NORMAL_TO, "M NAME READ");
-    }
-    if ((result = MechaCommandExecuteList(NULL, &EEPROMRxHandler)) == 0)
+    if ((result = MechaInitModel()) == 0)
     {
+        base = ConMD == 40 ? EEPROM_MAP_MODEL_NAME_NEW_0 : EEPROM_MAP_MODEL_NAME_0;
+        for (i = 0; i < 8; i++)
+        {
+            word                    = EEPMapRead(base + i);
+            ConModelName[i * 2 + 1] = word >> 8 & 0xFF;
+            ConModelName[i * 2]     = word & 0xFF;
+        }
+
         result = ((unsigned char)ConModelName[0] == 0 || (unsigned char)ConModelName[0] == 0xFF);
     }
 
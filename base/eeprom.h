@@ -1,6 +1,7 @@
 u16 EEPMapRead(u16 word);
 void EEPMapWrite(u16 word, u16 data);
 void EEPMapClear(void);
+int EEPMapIsValid(u16 word);
 
 int EEPROMReadWord(unsigned short int word, u16 *data);
 int EEPROMWriteWord(unsigned short int word, u16 data);
@@ -29,6 +30,16 @@ int EEPROMGetTVSystem(void);
 
 int EEPROMCanClearOSD2InitBit(int chassis);
 
+// Named EEPROM regions, for region-scoped dumping and restoring.
+struct EEPROMRegion
+{
+    const char *name;
+    u16 start, end;            // Inclusive word addresses
+    unsigned short int update; // Matching UPDATE_REGION_* bit, if any.
+};
+
+const struct EEPROMRegion *EEPROMGetRegion(int index);
+
 enum TV_SYSTEM
 {
     TV_SYSTEM_NTSC = 0,
@@ -8,8 +8,7 @@
 #include "eeprom.h"
 #include "elect.h"
 #include "main.h"
-
-extern unsigned char ElectConIsT10K;
+#include "pmap.h"
 
 static int ElectPromptT10K(void)
 {
@@ -26,16 +25,39 @@ static int ElectPromptT10K(void)
     return (input == 'y');
 }
 
+static int ElectPromptResume(int stage)
+{
+    char input;
+    do
+    {
+        PlatShowMessage("Stages before %s completed earlier. Resume from %s? [y,n] ", ElectGetStageName(stage), ElectGetStageName(stage));
+        input = getchar();
+        while (getchar() != '\n')
+        {
+        };
+    } while (input != 'y' && input != 'n');
+
+    return (input == 'y');
+}
+
 void MenuELECT(void)
 {
+    struct PmapElectOptions options = {ELECT_STAGE_CD, 0, 0, 1, NULL};
+    unsigned int chassis;
     char choice;
 
-    if (MechaInitModel() != 0)
+    if (ProbeConsole(MECHA_PROBE_FULL) != 0)
+        return;
+    if (PmapGetChassisCandidates(ConsoleSession, &chassis) != 0 || PmapElectGetCheckpoint(ConsoleSession, &options.stage) != 0)
     {
         DisplayConnHelp();
         return;
     }
-    ElectConIsT10K = IsChassisDexA() ? ElectPromptT10K() : 0;
+    options.T10K = (chassis & (1u << MECHA_CHASSIS_MODEL_DEXA)) ? ElectPromptT10K() : 0;
+    if (options.stage != ELECT_STAGE_CD && !ElectPromptResume(options.stage))
+        options.stage = ELECT_STAGE_CD;
+    if (PmapElectRun(ConsoleSession, &options) != 0)
+        return;
 
     do
     {
@@ -46,14 +68,47 @@ void MenuELECT(void)
                "\t2. Change/remove the spindle motor\n"
                "\t3. Change the MECHACON\n"
                "Warning! This process MAY damage the laser if the wrong type of disc is used!\n"
-               "\nContinue with automatic ELECT adjustment? [y/n]");
+               "\nContinue with automatic ELECT adjustment? [y/n, p = with step timing profile]");
 
         choice = getchar();
         while (getchar() != '\n')
         {
         };
-    } while (choice != 'y' && choice != 'n');
+    } while (choice != 'y' && choice != 'n' && choice != 'p');
+
+    options.simulate = 0;
+    options.profile  = (choice == 'p');
+    if (choice != 'n')
+        PmapElectRun(ConsoleSession, &options);
+}
+
+// One station of a multi-station run: there is nobody to answer questions, so a checkpoint is always resumed.
+int ElectStation(int station, const char *device)
+{
+    struct PmapOptions options       = {NULL, station, 1};
+    struct PmapElectOptions electing = {-1, 0, 0, 0, NULL};
+    unsigned int chassis;
+    int result, stage;
+
+    if ((result = PmapOpen(device, &options, &ConsoleSession)) != 0)
+        return result;
+
+    if ((result = PmapGetChassisCandidates(ConsoleSession, &chassis)) != 0 || (result = PmapElectGetCheckpoint(ConsoleSession, &stage)) != 0)
+        DisplayConnHelp();
+    else if (chassis & (1u << MECHA_CHASSIS_MODEL_DEXA))
+    {
+        // The DTL-T10000 question cannot be answered here, and guessing it wrong would write the wrong parameters.
+        PlatShowMessage("Station %d: DEX chassis A consoles must be adjusted from the ELECT menu.\n", station);
+        result = EINVAL;
+    }
+    else
+    {
+        if (stage != ELECT_STAGE_CD)
+            PlatShowMessage("Station %d: resuming from the %s stage.\n", station, ElectGetStageName(stage));
+        result = PmapElectRun(ConsoleSession, &electing);
+    }
+
+    PmapClose(ConsoleSession);
 
-    if (choice == 'y')
-        ElectAutoAdjust();
+    return result;
 }
@@ -0,0 +1,281 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "platform.h"
+#include "mecha.h"
+#include "elect.h"
+#include "elect-profile.h"
+
+#define ELECT_PROFILE_MAX_TASKS   256
+#define ELECT_PROFILE_MAX_SAMPLES 100 // Per step, only the most recent samples are kept.
+#define ELECT_PROFILE_TOP         20
+#define ELECT_PROFILE_LINE_MAX    256
+
+static const char *ElectProfileKindNames[ELECT_PROFILE_KIND_COUNT] = {
+    "device",
+    "sleep",
+    "operator"};
+
+struct ElectProfileTaskData
+{
+    unsigned char stage, kind;
+    unsigned short int timeout;
+    const char *label;
+    u32 start, duration; // ms, start is relative to the start of the run.
+};
+
+// A distinct step of this run, with the durations recorded for it in all runs on the same MECHA.
+struct ElectProfileStep
+{
+    unsigned char stage, kind;
+    unsigned short int timeout;
+    const char *label;
+    unsigned short int count, next;
+    u32 samples[ELECT_PROFILE_MAX_SAMPLES];
+};
+
+static struct ElectProfile
+{
+    unsigned char active;
+    u32 start;
+    unsigned short int count;
+    struct ElectProfileTaskData tasks[ELECT_PROFILE_MAX_TASKS];
+} profile;
+
+static struct ElectProfileStep steps[ELECT_PROFILE_MAX_TASKS];
+static unsigned short int StepCount;
+
+void ElectProfileBegin(void)
+{
+    memset(&profile, 0, sizeof(profile));
+    profile.active = 1;
+    profile.start  = PlatGetTicks();
+}
+
+void ElectProfileTask(int stage, const MechaTask_t *task, u32 start, u32 end)
+{
+    struct ElectProfileTaskData *data;
+
+    if (!profile.active || profile.count >= ELECT_PROFILE_MAX_TASKS)
+        return;
+
+    data = &profile.tasks[profile.count++];
+    if (task->id != MECHA_TASK_ID_UI)
+        data->kind = ELECT_PROFILE_DEVICE;
+    else if (task->command == MECHA_TASK_UI_CMD_WAIT)
+        data->kind = ELECT_PROFILE_SLEEP;
+    else
+        data->kind = ELECT_PROFILE_OPERATOR;
+    data->stage    = (unsigned char)stage;
+    data->timeout  = task->timeout;
+    data->label    = task->label;
+    data->start    = start - profile.start;
+    data->duration = end - start;
+}
+
+static int ElectProfileCompareTasks(const void *a, const void *b)
+{
+    u32 x = profile.tasks[*(const unsigned short int *)a].duration, y = profile.tasks[*(const unsigned short int *)b].duration;
+
+    return (x < y) - (x > y);
+}
+
+static int ElectProfileCompareSamples(const void *a, const void *b)
+{
+    u32 x = *(const u32 *)a, y = *(const u32 *)b;
+
+    return (x > y) - (x < y);
+}
+
+static void ElectProfilePrintRanking(void)
+{
+    unsigned short int order[ELECT_PROFILE_MAX_TASKS], i;
+    const struct ElectProfileTaskData *data;
+    u32 total, kinds[ELECT_PROFILE_KIND_COUNT];
+
+    for (i = 0, total = 0; i < ELECT_PROFILE_KIND_COUNT; i++)
+        kinds[i] = 0;
+    for (i = 0; i < profile.count; i++)
+    {
+        order[i] = i;
+        kinds[profile.tasks[i].kind] += profile.tasks[i].duration;
+        total += profile.tasks[i].duration;
+    }
+    if (total == 0)
+        total = 1;
+    qsort(order, profile.count, sizeof(order[0]), &ElectProfileCompareTasks);
+
+    PlatShowMessage("\nELECT step profile (%u tasks, slowest first):\n"
+                    "      Stage     Kind      Step                                       Start   Duration\n",
+                    profile.count);
+    for (i = 0; i < profile.count && i < ELECT_PROFILE_TOP; i++)
+    {
+        data = &profile.tasks[order[i]];
+        PlatShowMessage("%4u. %-9s %-9s %-40s %7u.%01us %7u.%03us %5.1f%%\n", i + 1, ElectGetStageName(data->stage), ElectProfileKindNames[data->kind],
+                        data->label, data->start / 1000, (data->start % 1000) / 100, data->duration / 1000, data->duration % 1000, data->duration * 100.0f / total);
+    }
+
+    PlatShowMessage("Total: device %u.%01us (%.1f%%), fixed sleeps %u.%01us (%.1f%%), operator %u.%01us (%.1f%%)\n",
+                    kinds[ELECT_PROFILE_DEVICE] / 1000, (kinds[ELECT_PROFILE_DEVICE] % 1000) / 100, kinds[ELECT_PROFILE_DEVICE] * 100.0f / total,
+                    kinds[ELECT_PROFILE_SLEEP] / 1000, (kinds[ELECT_PROFILE_SLEEP] % 1000) / 100, kinds[ELECT_PROFILE_SLEEP] * 100.0f / total,
+                    kinds[ELECT_PROFILE_OPERATOR] / 1000, (kinds[ELECT_PROFILE_OPERATOR] % 1000) / 100, kinds[ELECT_PROFILE_OPERATOR] * 100.0f / total);
+}
+
+static int ElectProfileSave(const char *mecha)
+{
+    const struct ElectProfileTaskData *data;
+    unsigned short int i;
+    FILE *file;
+
+    if ((file = fopen("elect_profile.csv", "a")) == NULL)
+        return -1;
+
+    if (ftell(file) == 0)
+        fputs("mecha,stage,step,kind,timeout_ms,duration_ms\n", file);
+    for (i = 0; i < profile.count; i++)
+    {
+        data = &profile.tasks[i];
+        fprintf(file, "\"%s\",%s,\"%s\",%s,%u,%u\n", mecha, ElectGetStageName(data->stage), data->label,
+                ElectProfileKindNames[data->kind], data->timeout, data->duration);
+    }
+    fclose(file);
+
+    return 0;
+}
+
+// Returns the next field of a CSV line, which may be quoted.
+static char *ElectProfileField(char **line)
+{
+    char *field, *p = *line;
+
+    if (*p == '"')
+    {
+        for (field = ++p; *p != '"' && *p != '\0'; p++)
+            ;
+        if (*p == '"')
+            *p++ = '\0';
+    }
+    else
+        field = p;
+
+    for (; *p != ',' && *p != '\r' && *p != '\n' && *p != '\0'; p++)
+        ;
+    if (*p != '\0')
+        *p++ = '\0';
+    *line = p;
+
+    return field;
+}
+
+static struct ElectProfileStep *ElectProfileFindStep(const char *stage, const char *label, const char *kind)
+{
+    unsigned short int i;
+
+    for (i = 0; i < StepCount; i++)
+    {
+        if (!strcmp(ElectGetStageName(steps[i].stage), stage) && !strcmp(steps[i].label, label) && !strcmp(ElectProfileKindNames[steps[i].kind], kind))
+            return &steps[i];
+    }
+
+    return NULL;
+}
+
+static void ElectProfileLoad(const char *mecha)
+{
+    char line[ELECT_PROFILE_LINE_MAX], *p, *stage, *label, *kind;
+    struct ElectProfileStep *step;
+    unsigned short int i;
+    FILE *file;
+
+    // Operator waits cannot be tuned, so only device commands and fixed sleeps are of interest.
+    for (i = 0, StepCount = 0; i < profile.count; i++)
+    {
+        if (profile.tasks[i].kind == ELECT_PROFILE_OPERATOR || ElectProfileFindStep(ElectGetStageName(profile.tasks[i].stage), profile.tasks[i].label, ElectProfileKindNames[profile.tasks[i].kind]) != NULL)
+            continue;
+
+        step          = &steps[StepCount++];
+        step->stage   = profile.tasks[i].stage;
+        step->kind    = profile.tasks[i].kind;
+        step->timeout = profile.tasks[i].timeout;
+        step->label   = profile.tasks[i].label;
+        step->count   = 0;
+        step->next    = 0;
+    }
+
+    if ((file = fopen("elect_profile.csv", "r")) == NULL)
+        return;
+
+    while (fgets(line, sizeof(line), file) != NULL)
+    {
+        p = line;
+        if (strcmp(ElectProfileField(&p), mecha))
+            continue;
+        stage = ElectProfileField(&p);
+        label = ElectProfileField(&p);
+        kind  = ElectProfileField(&p);
+        ElectProfileField(&p); // Timeout at the time
+        if ((step = ElectProfileFindStep(stage, label, kind)) != NULL)
+        {
+            step->samples[step->next] = strtoul(ElectProfileField(&p), NULL, 10);
+            step->next                = (step->next + 1) % ELECT_PROFILE_MAX_SAMPLES;
+            if (step->count < ELECT_PROFILE_MAX_SAMPLES)
+                step->count++;
+        }
+    }
+    fclose(file);
+}
+
+static int ElectProfileCompareSteps(const void *a, const void *b)
+{
+    const struct ElectProfileStep *x = a, *y = b;
+    u32 mx = x->samples[x->count / 2], my = y->samples[y->count / 2];
+
+    return (mx < my) - (mx > my);
+}
+
+static void ElectProfilePrintDistribution(const char *mecha)
+{
+    struct ElectProfileStep *step;
+    unsigned short int i;
+
+    ElectProfileLoad(mecha);
+    for (i = 0; i < StepCount; i++)
+    {
+        if (steps[i].count > 0)
+            qsort(steps[i].samples, steps[i].count, sizeof(u32), &ElectProfileCompareSamples);
+        else
+            steps[i].samples[0] = 0;
+    }
+    qsort(steps, StepCount, sizeof(steps[0]), &ElectProfileCompareSteps);
+
+    // Setting is the timeout of a device step or the length of a sleep. A device step close to its timeout is marked with a "!".
+    PlatShowMessage("\nStep times on %s (up to %u recent samples per step):\n"
+                    "      Stage     Kind      Step                                     Samples   Median      P90      Max  Setting\n",
+                    mecha, ELECT_PROFILE_MAX_SAMPLES);
+    for (i = 0; i < StepCount && i < ELECT_PROFILE_TOP; i++)
+    {
+        step = &steps[i];
+        if (step->count == 0)
+            continue;
+        PlatShowMessage("%4u. %-9s %-9s %-40s %7u %7ums %7ums %7ums %7ums%s\n", i + 1, ElectGetStageName(step->stage), ElectProfileKindNames[step->kind],
+                        step->label, step->count, step->samples[step->count / 2], step->samples[(step->count * 9) / 10],
+                        step->samples[step->count - 1], step->timeout,
+                        (step->kind == ELECT_PROFILE_DEVICE && step->samples[step->count - 1] * 10 > step->timeout * 8u) ? " !" : "");
+    }
+}
+
+void ElectProfileEnd(void)
+{
+    const char *mecha;
+
+    if (!profile.active)
+        return;
+    profile.active = 0;
+
+    mecha          = MechaGetDesc();
+    ElectProfilePrintRanking();
+    if (ElectProfileSave(mecha) != 0)
+        PlatShowEMessage("ELECT: cannot write the step profile.\n");
+    ElectProfilePrintDistribution(mecha);
+}
@@ -0,0 +1,17 @@
+/*  ELECT step timing profile.
+    Every task of a profiled run is timed and classified, then ranked at the end of the run.
+    The timings are also appended to elect_profile.csv, from which per-MECHA step time distributions are shown
+    next to the timeouts and fixed sleeps that are currently used. */
+
+enum ELECT_PROFILE_KIND
+{
+    ELECT_PROFILE_DEVICE = 0, // Command sent to the MECHACON
+    ELECT_PROFILE_SLEEP,      // Fixed UI_CMD_WAIT delay
+    ELECT_PROFILE_OPERATOR,   // Waiting for the operator (UI_CMD_MSG)
+
+    ELECT_PROFILE_KIND_COUNT
+};
+
+void ElectProfileBegin(void);
+void ElectProfileTask(int stage, const MechaTask_t *task, u32 start, u32 end);
+void ElectProfileEnd(void);
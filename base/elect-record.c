@@ -0,0 +1,332 @@
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "platform.h"
+#include "mecha.h"
+#include "eeprom.h"
+#include "elect.h"
+#include "elect-record.h"
+#include "metrics.h"
+
+extern unsigned char ConType;
+extern unsigned char ElectConIsT10K;
+
+#define ELECT_RECORD_MAX_STEPS  160
+#define ELECT_RECORD_MAX_VALUES 96
+#define ELECT_RECORD_BUFFER     0x20000 // Large enough for a whole run, so parallel stations do not interleave their rows.
+
+struct ElectRecordStepData
+{
+    unsigned char stage, ok;
+    const char *label;
+    u32 duration; // ms
+};
+
+struct ElectRecordValueData
+{
+    unsigned char step, ok, attempt; // attempt > 1 for retried measurements.
+    const char *name;
+    float value, min, max;
+};
+
+static struct ElectRecord
+{
+    unsigned char active, FirstStage;
+    char run[32], time[24], model[17], cfd[11];
+    u32 serial, cfc, start;
+    const char *desc, *CexDex, *op, *lens;
+    int type, T10K;
+
+    unsigned char StepCount, ValueCount;
+    struct ElectRecordStepData steps[ELECT_RECORD_MAX_STEPS];
+    struct ElectRecordValueData values[ELECT_RECORD_MAX_VALUES];
+} record;
+
+static struct ElectRecordObserver observer;
+static struct ElectRecordStepData ObservedStep; // Until its verdict is known.
+
+void ElectRecordSetObserver(const struct ElectRecordObserver *NewObserver)
+{
+    if (NewObserver != NULL)
+        observer = *NewObserver;
+    else
+        memset(&observer, 0, sizeof(observer));
+}
+
+void ElectRecordBegin(int stage)
+{
+    const struct MechaIdentRaw *RawData;
+    time_t TimeNow;
+    u8 emcs;
+
+    memset(&record, 0, sizeof(record));
+    record.active     = 1;
+    record.FirstStage = (unsigned char)stage;
+    record.start      = PlatGetTicks();
+
+    if (EEPROMInitSerial() == 0)
+        EEPROMGetSerial(&record.serial, &emcs);
+    if (EEPROMInitModelName() == 0)
+        snprintf(record.model, sizeof(record.model), "%s", EEPROMGetModelName());
+    RawData = MechaGetRawIdent();
+    snprintf(record.cfd, sizeof(record.cfd), "%s", RawData->cfd);
+    record.cfc    = RawData->cfc;
+    record.type   = ConType;
+    record.desc   = MechaGetDesc();
+    record.CexDex = MechaGetCEXDEX() == 0 ? "DEX" : "CEX";
+    record.op     = MechaGetOPTypeName(MechaGetOP());
+    record.lens   = MechaGetLensTypeName(MechaGetLens());
+    record.T10K   = ElectConIsT10K;
+
+    time(&TimeNow);
+    strftime(record.time, sizeof(record.time), "%Y-%m-%dT%H:%M:%S", localtime(&TimeNow));
+    strftime(record.run, sizeof(record.run), "%Y%m%d%H%M%S", localtime(&TimeNow));
+    snprintf(record.run + strlen(record.run), sizeof(record.run) - strlen(record.run), "_%07u", record.serial);
+}
+
+void ElectRecordStep(int stage, const char *label, u32 duration)
+{
+    struct ElectRecordStepData *step;
+
+    ObservedStep.stage    = (unsigned char)stage;
+    ObservedStep.label    = label;
+    ObservedStep.duration = duration;
+
+    if (record.active && record.StepCount < ELECT_RECORD_MAX_STEPS)
+    {
+        step           = &record.steps[record.StepCount++];
+        step->stage    = (unsigned char)stage;
+        step->label    = label;
+        step->duration = duration;
+        step->ok       = 1;
+    }
+}
+
+void ElectRecordStepVerdict(int ok)
+{
+    if (record.active && record.StepCount > 0)
+        record.steps[record.StepCount - 1].ok = (unsigned char)ok;
+    if (observer.step != NULL && ObservedStep.label != NULL)
+        observer.step(ObservedStep.stage, ObservedStep.label, ObservedStep.duration, ok, observer.context);
+    ObservedStep.label = NULL;
+}
+
+void ElectRecordValue(const char *name, float value, float min, float max, int ok)
+{
+    struct ElectRecordValueData *data;
+    int i;
+
+    MetricsJudge(name, ok);
+    if (observer.value != NULL)
+        observer.value(name, value, min, max, ok, observer.context);
+    if (record.active && record.ValueCount < ELECT_RECORD_MAX_VALUES && record.StepCount > 0)
+    {
+        data          = &record.values[record.ValueCount];
+        data->step    = record.StepCount - 1;
+        data->name    = name;
+        data->value   = value;
+        data->min     = min;
+        data->max     = max;
+        data->ok      = (unsigned char)ok;
+        data->attempt = 1;
+        for (i = 0; i < record.ValueCount; i++)
+        {
+            if (!strcmp(record.values[i].name, name))
+                data->attempt++;
+        }
+        record.ValueCount++;
+    }
+}
+
+int ElectRecordCheck(const char *name, float value, float min, float max)
+{
+    int ok;
+
+    ok = (min == ELECT_NO_LIMIT || value >= min) && (max == ELECT_NO_LIMIT || value <= max);
+    ElectRecordValue(name, value, min, max, ok);
+
+    return ok;
+}
+
+static void ElectRecordPrintLimit(FILE *file, float limit, const char *none)
+{
+    if (limit == ELECT_NO_LIMIT)
+        fputs(none, file);
+    else
+        fprintf(file, "%g", limit);
+}
+
+/*  Every string is quoted: as a CSV field (quote set, with "" for ") or as a JSON string (with \" and \\).
+    Labels and names are plain ASCII, but the model name and cfd come from the console. Control characters are dropped. */
+static void ElectRecordPrintString(FILE *file, const char *s, int quote)
+{
+    fputc('"', file);
+    for (; *s != '\0'; s++)
+    {
+        if (*s == '"')
+            fputs(quote ? "\"\"" : "\\\"", file);
+        else if (*s == '\\' && !quote)
+            fputs("\\\\", file);
+        else if ((unsigned char)*s >= 0x20 && (unsigned char)*s < 0x7F)
+            fputc(*s, file);
+    }
+    fputc('"', file);
+}
+
+static void ElectRecordPrintCSVRun(FILE *file, int result)
+{
+    fprintf(file, "%s,%s,%07u,", record.run, record.time, record.serial);
+    ElectRecordPrintString(file, record.model, 1);
+    fputc(',', file);
+    ElectRecordPrintString(file, record.cfd, 1);
+    fprintf(file, ",%08x,", record.cfc);
+    ElectRecordPrintString(file, record.desc, 1);
+    fprintf(file, ",%s,", record.CexDex);
+    ElectRecordPrintString(file, record.op, 1);
+    fputc(',', file);
+    ElectRecordPrintString(file, record.lens, 1);
+    fprintf(file, ",%d,%s,%d,", record.T10K, ElectGetStageName(record.FirstStage), result);
+}
+
+static void ElectRecordPrintCSVStep(FILE *file, const struct ElectRecordStepData *step)
+{
+    fprintf(file, "%s,", ElectGetStageName(step->stage));
+    ElectRecordPrintString(file, step->label, 1);
+    fprintf(file, ",%u,%s,", step->duration, step->ok ? "OK" : "NG");
+}
+
+static FILE *ElectRecordOpenCSV(void)
+{
+    FILE *file;
+
+    if ((file = fopen("elect_results.csv", "a")) == NULL)
+        return NULL;
+    setvbuf(file, NULL, _IOFBF, ELECT_RECORD_BUFFER);
+
+    if (ftell(file) == 0)
+        fputs("run,time,serial,model,cfd,cfc,mecha,cexdex,op,lens,t10k,first_stage,result,stage,step,duration_ms,step_verdict,measurement,value,min,max,verdict,attempt\n", file);
+
+    return file;
+}
+
+int ElectRecordPrepare(void)
+{
+    FILE *file;
+
+    if ((file = ElectRecordOpenCSV()) == NULL)
+        return -1;
+    fclose(file);
+
+    return 0;
+}
+
+static int ElectRecordWriteCSV(int result)
+{
+    const struct ElectRecordStepData *step;
+    const struct ElectRecordValueData *data;
+    FILE *file;
+    int i, j, HasValue;
+
+    if ((file = ElectRecordOpenCSV()) == NULL)
+        return -1;
+
+    for (i = 0; i < record.StepCount; i++)
+    {
+        step     = &record.steps[i];
+        HasValue = 0;
+        for (j = 0; j < record.ValueCount; j++)
+        {
+            data = &record.values[j];
+            if (data->step != i)
+                continue;
+
+            ElectRecordPrintCSVRun(file, result);
+            ElectRecordPrintCSVStep(file, step);
+            ElectRecordPrintString(file, data->name, 1);
+            fprintf(file, ",%g,", data->value);
+            ElectRecordPrintLimit(file, data->min, "");
+            fputc(',', file);
+            ElectRecordPrintLimit(file, data->max, "");
+            fprintf(file, ",%s,%u\n", data->ok ? "OK" : "NG", data->attempt);
+            HasValue = 1;
+        }
+
+        if (!HasValue)
+        {
+            ElectRecordPrintCSVRun(file, result);
+            ElectRecordPrintCSVStep(file, step);
+            fputs(",,,,,\n", file);
+        }
+    }
+    fclose(file);
+
+    return 0;
+}
+
+static int ElectRecordWriteJSON(int result)
+{
+    const struct ElectRecordStepData *step;
+    const struct ElectRecordValueData *data;
+    FILE *file;
+    int i, j, first;
+
+    if ((file = fopen("elect_results.jsonl", "a")) == NULL)
+        return -1;
+    setvbuf(file, NULL, _IOFBF, ELECT_RECORD_BUFFER);
+
+    fprintf(file, "{\"run\":\"%s\",\"time\":\"%s\",\"serial\":%u,\"model\":", record.run, record.time, record.serial);
+    ElectRecordPrintString(file, record.model, 0);
+    fputs(",\"cfd\":", file);
+    ElectRecordPrintString(file, record.cfd, 0);
+    fprintf(file, ",\"cfc\":\"%08x\",\"type\":%d,\"mecha\":", record.cfc, record.type);
+    ElectRecordPrintString(file, record.desc, 0);
+    fprintf(file, ",\"cexdex\":\"%s\",\"op\":", record.CexDex);
+    ElectRecordPrintString(file, record.op, 0);
+    fputs(",\"lens\":", file);
+    ElectRecordPrintString(file, record.lens, 0);
+    fprintf(file, ",\"t10k\":%s,\"first_stage\":\"%s\",\"result\":%d,\"duration_ms\":%u,\"steps\":[",
+            record.T10K ? "true" : "false", ElectGetStageName(record.FirstStage), result, PlatGetTicks() - record.start);
+
+    for (i = 0; i < record.StepCount; i++)
+    {
+        step = &record.steps[i];
+        fprintf(file, "%s{\"stage\":\"%s\",\"step\":", i > 0 ? "," : "", ElectGetStageName(step->stage));
+        ElectRecordPrintString(file, step->label, 0);
+        fprintf(file, ",\"duration_ms\":%u,\"verdict\":\"%s\",\"values\":[", step->duration, step->ok ? "OK" : "NG");
+        for (j = 0, first = 1; j < record.ValueCount; j++)
+        {
+            data = &record.values[j];
+            if (data->step != i)
+                continue;
+
+            fprintf(file, "%s{\"name\":", first ? "" : ",");
+            ElectRecordPrintString(file, data->name, 0);
+            fprintf(file, ",\"value\":%g,\"min\":", data->value);
+            ElectRecordPrintLimit(file, data->min, "null");
+            fputs(",\"max\":", file);
+            ElectRecordPrintLimit(file, data->max, "null");
+            fprintf(file, ",\"verdict\":\"%s\",\"attempt\":%u}", data->ok ? "OK" : "NG", data->attempt);
+            first = 0;
+        }
+        fputs("]}", file);
+    }
+    fputs("]}\n", file);
+    fclose(file);
+
+    return 0;
+}
+
+int ElectRecordEnd(int result)
+{
+    int status;
+
+    if (!record.active)
+        return 0;
+    record.active = 0;
+
+    if ((status = ElectRecordWriteCSV(result)) != 0 || (status = ElectRecordWriteJSON(result)) != 0)
+        PlatShowEMessage("ELECT: cannot write the measurement record.\n");
+
+    return status;
+}
@@ -0,0 +1,23 @@
+/*  ELECT measurement records.
+    Every auto-adjust run is appended to elect_results.csv (one row per measured value, or per step without one)
+    and to elect_results.jsonl (one JSON object per run), for yield and drift analysis across consoles. */
+
+#define ELECT_NO_LIMIT 1e30f // For one-sided limits.
+
+void ElectRecordBegin(int stage);
+void ElectRecordStep(int stage, const char *label, u32 duration);
+void ElectRecordStepVerdict(int ok);
+void ElectRecordValue(const char *name, float value, float min, float max, int ok);
+int ElectRecordCheck(const char *name, float value, float min, float max); // Records the value and returns whether it is within the limits.
+int ElectRecordEnd(int result);
+int ElectRecordPrepare(void); // Creates elect_results.csv with its header. Stations that share it must call this once, before they start.
+
+/*  For an application that follows the run as it happens. value() is called as every value is measured,
+    and step() once the verdict of a step (that the values belong to) is known. NULL removes the observer. */
+struct ElectRecordObserver
+{
+    void (*step)(int stage, const char *label, u32 duration, int ok, void *context);
+    void (*value)(const char *name, float value, float min, float max, int ok, void *context);
+    void *context;
+};
+void ElectRecordSetObserver(const struct ElectRecordObserver *observer);
@@ -7,10 +7,15 @@
 #include "mecha.h"
 #include "eeprom.h"
 #include "elect.h"
+#include "elect-record.h"
+#include "elect-profile.h"
+#include "metrics.h"
 #include "main.h"
 
 extern unsigned char ConMD, ConType, ConTM, ConCEXDEX, ConOP, ConLens, ConChecksumStat, ConSlim;
 unsigned char ElectConIsT10K;
+unsigned char ElectProfiling; // Set to time every step of the next ElectAutoAdjust() run.
+static unsigned char ElectAborted;
 
 static u16 DiscDetectValue136, DVDmaxCalc, CDminCalc, DVDmax, DVDmin;
 static unsigned char DisableDVDDLAdjWorkaround, DisableEEPMIRRWrite, Enable2ndJitter256Check;
@@ -617,6 +622,7 @@ static int ElectJudgeOPTypeError(const char *result, int len)
                 CDstudy = study * (5.0f / 3.0f);
                 PlatDPrintf("CDmin(d)=%d CDstudy(d)=%d CDmax(d)=%d CDdet(f)=%.0f", minthreshold, study, maxthreshold, CDstudy);
                 OPMismatched = (minthreshold >= CDstudy || maxthreshold <= CDstudy);
+                ElectRecordValue("CD DET (OP TYPE)", CDstudy, minthreshold, maxthreshold, !OPMismatched);
             }
             else
             {
@@ -651,6 +657,7 @@ static int ElectJudgeOPTypeError(const char *result, int len)
                 CDstudy = study * (2.0f / 3.0f);
                 PlatDPrintf("CDmin(d)=%d CDstudy(d)=%d CDmax(d)=%d CDdet(f)=%.0f", minthreshold, study, maxthreshold, CDstudy);
                 OPMismatched = (minthreshold >= CDstudy || maxthreshold <= CDstudy);
+                ElectRecordValue("CD DET (OP TYPE)", CDstudy, minthreshold, maxthreshold, !OPMismatched);
             }
             else
             {
@@ -680,7 +687,7 @@ static int ElectJudgeCDFELoopGain(const char *result, int len)
     unsigned int value;
 
     value = (unsigned int)strtoul(&result[1], NULL, 16);
-    if (value >= 0x08 && value <= 0x60)
+    if (ElectRecordCheck("CD FE LOOP GAIN", value, 0x08, 0x60))
     {
         PlatDPrintf("CD FE LOOP GAIN OK: %d\n", value);
         return 0;
@@ -697,7 +704,7 @@ static int ElectJudgeCDTELoopGain(const char *result, int len)
     int value;
 
     value = (unsigned int)strtoul(&result[1], NULL, 16);
-    if (value >= 0x10 && value <= 0x60)
+    if (ElectRecordCheck("CD TE LOOP GAIN", value, 0x10, 0x60))
     {
         PlatDPrintf("CD TE LOOP GAIN OK: %d\n", value);
         return 0;
@@ -723,7 +730,7 @@ static int ElectJudgeDiscDetectRatio(const char *result, int len)
         {
             case MECHA_TYPE_F:
                 DVDRatio = ratio = (float)(max * 3) / (DVDmin * 7);
-                if (ratio >= 1.8f)
+                if (ElectRecordCheck("CD/DVD DISC DETECT RATIO", ratio, 1.8f, ELECT_NO_LIMIT))
                 {
                     PlatDPrintf("CD/DVD DiscDetect Ratio OK: %f\n", ratio);
                     return 0;
@@ -738,7 +745,7 @@ static int ElectJudgeDiscDetectRatio(const char *result, int len)
             case MECHA_TYPE_G2:
             case MECHA_TYPE_40:
                 DVDRatio = ratio = (float)max / (DVDmin * 3);
-                if (ratio >= 1.73f)
+                if (ElectRecordCheck("CD/DVD DISC DETECT RATIO", ratio, 1.73f, ELECT_NO_LIMIT))
                 {
                     PlatDPrintf("CD/DVD DiscDetect Ratio OK: %f\n", ratio);
                     return 0;
@@ -799,7 +806,7 @@ static int ElectJudgeDVDSLFELoopGain(const char *result, int len)
     unsigned int value;
 
     value = (unsigned int)strtoul(&result[1], NULL, 16);
-    if (value >= 0x08 && value <= 0x60)
+    if (ElectRecordCheck("DVD-SL FE LOOP GAIN", value, 0x08, 0x60))
     {
         PlatDPrintf("DVD-SL FE LOOP GAIN OK: %d\n", value);
         return 0;
@@ -816,7 +823,7 @@ static int ElectJudgeDVDSLTELoopGain(const char *result, int len)
     unsigned int value;
 
     value = (unsigned int)strtoul(&result[1], NULL, 16);
-    if (value >= 0x10 && value <= 0x60)
+    if (ElectRecordCheck("DVD-SL TE LOOP GAIN", value, 0x10, 0x60))
     {
         PlatDPrintf("DVD-SL TE LOOP GAIN OK: %d\n", value);
         return 0;
@@ -846,7 +853,7 @@ static int ElectJudgeDVDSLJitter256(const char *result, int len)
     }
 
     value = (unsigned int)strtoul(&result[1], NULL, 16);
-    if (value <= threshold)
+    if (ElectRecordCheck("DVD-SL JITTER (256)", value, 0, threshold))
     {
         PlatDPrintf("DVD-SL jitter(256) OK: %d\n", value);
         return 0;
@@ -863,7 +870,7 @@ static int ElectJudgeDVDSLPIPOCC(const char *result, int len)
     unsigned int value;
 
     value = (unsigned int)strtoul(&result[1], NULL, 16);
-    if (value <= 100)
+    if (ElectRecordCheck("DVD-SL PI+PO-CC", value, 0, 100))
     {
         PlatDPrintf("DVD-SL PI+PO-CC OK: %d\n", value);
         return 0;
@@ -880,7 +887,7 @@ static int ElectJudgeDVDSLPONCC(const char *result, int len)
     unsigned int value;
 
     value = (unsigned int)strtoul(&result[1], NULL, 16);
-    if (value == 0)
+    if (ElectRecordCheck("DVD-SL PO-NCC", value, 0, 0))
     {
         PlatDPrintf("DVD-SL PO-NCC OK: %d\n", value);
         return 0;
@@ -897,7 +904,7 @@ static int ElectJudgeDVDDLDiscDetect(const char *result, int len)
     unsigned int value;
 
     value = (unsigned int)strtoul(&result[1], NULL, 16);
-    if (value == DISC_TYPE_DVDD12)
+    if (ElectRecordCheck("DVD-DL DISC DETECT", value, DISC_TYPE_DVDD12, DISC_TYPE_DVDD12))
     {
         PlatDPrintf("DVD-DL DISC DETECT OK: %d\n", value);
         return 0;
@@ -914,7 +921,7 @@ static int ElectJudgeDVDDLL0FELoopGain(const char *result, int len)
     unsigned int value;
 
     value = (unsigned int)strtoul(&result[1], NULL, 16);
-    if (value >= 0x08 && value <= 0x60)
+    if (ElectRecordCheck("DVD-DL-L0 FE LOOP GAIN", value, 0x08, 0x60))
     {
         PlatDPrintf("DVD-DL-L0 FE LOOP GAIN OK: %d\n", value);
         return 0;
@@ -931,7 +938,7 @@ static int ElectJudgeDVDDLL0TELoopGain(const char *result, int len)
     unsigned int value;
 
     value = (unsigned int)strtoul(&result[1], NULL, 16);
-    if (value >= 0x10 && value <= 0x60)
+    if (ElectRecordCheck("DVD-DL-L0 TE LOOP GAIN", value, 0x10, 0x60))
     {
         PlatDPrintf("DVD-DL-L0 TE LOOP GAIN OK: %d\n", value);
         return 0;
@@ -961,7 +968,7 @@ static int ElectJudgeDVDDLL0Jitter256(const char *result, int len)
     }
 
     value = (unsigned int)strtoul(&result[1], NULL, 16);
-    if (value <= threshold)
+    if (ElectRecordCheck("DVD-DL-L0 JITTER (256)", value, 0, threshold))
     {
         PlatDPrintf("DVD-DL-L0 jitter(256) OK: %d\n", value);
         return 0;
@@ -978,7 +985,7 @@ static int ElectJudgeDVDDLL1FELoopGain(const char *result, int len)
     unsigned int value;
 
     value = (unsigned int)strtoul(&result[1], NULL, 16);
-    if (value >= 0x08 && value <= 0x60)
+    if (ElectRecordCheck("DVD-DL-L1 FE LOOP GAIN", value, 0x08, 0x60))
     {
         PlatDPrintf("DVD-DL-L1 FE LOOP GAIN OK: %d\n", value);
         return 0;
@@ -995,7 +1002,7 @@ static int ElectJudgeDVDDLL1TELoopGain(const char *result, int len)
     unsigned int value;
 
     value = (unsigned int)strtoul(&result[1], NULL, 16);
-    if (value >= 0x10 && value <= 0x60)
+    if (ElectRecordCheck("DVD-DL-L1 TE LOOP GAIN", value, 0x10, 0x60))
     {
         PlatDPrintf("DVD-DL-L1 TE LOOP GAIN OK: %d\n", value);
         return 0;
@@ -1025,7 +1032,7 @@ static int ElectJudgeDVDDLL1Jitter256(const char *result, int len)
     }
 
     value = (unsigned int)strtoul(&result[1], NULL, 16);
-    if (value <= threshold)
+    if (ElectRecordCheck("DVD-DL-L1 JITTER (256)", value, 0, threshold))
     {
         PlatDPrintf("DVD-DL-L1 jitter(256) OK: %d\n", value);
         return 0;
@@ -1042,7 +1049,7 @@ static int ElectJudgeChecksum(const char *result, int len)
     unsigned int value;
 
     value = (unsigned int)strtoul(&result[1], NULL, 16);
-    if (value == 0)
+    if (ElectRecordCheck("EEPROM CHECKSUM", value, 0, 0))
     {
         PlatDPrintf("EEPROM checksum OK: %d\n", value);
         return 0;
@@ -1068,7 +1075,7 @@ static int ElectJudgeFCSSearchData(const char *data, int len)
         value     = (unsigned int)strtoul(&data[5], NULL, 16);
         result    = value * 100 / divisor - 100;
 
-        if ((result >= -10) && (result <= 10))
+        if (ElectRecordCheck("FCS SEARCH DATA", result, -10, 10))
         {
             PlatDPrintf("FCS Search Data OK: %d\n", result);
             return 0;
@@ -1111,7 +1118,7 @@ static int ElectJudgeDVDSLJitter256WithRetry(const char *result, int len)
     int value;
 
     value = (int)strtoul(&result[1], NULL, 16);
-    if (value <= (ConCEXDEX ? 0x3E00 : 0x2970))
+    if (ElectRecordCheck("DVD-SL JITTER (256)", value, 0, ConCEXDEX ? 0x3E00 : 0x2970))
     {
         Enable2ndJitter256Check = 0;
         PlatDPrintf("DVD-SL jitter(256)_WITH_RETRY OK: %d\n", value);
@@ -1133,7 +1140,7 @@ static int ElectJudgeDVDDLL0Jitter256WithRetry(const char *result, int len)
     int value;
 
     value = (int)strtoul(&result[1], NULL, 16);
-    if (value <= (ConCEXDEX ? 0x4C00 : 0x2D00))
+    if (ElectRecordCheck("DVD-DL-L0 JITTER (256)", value, 0, ConCEXDEX ? 0x4C00 : 0x2D00))
     {
         Enable2ndJitter256Check = 0;
         PlatDPrintf("DVD-DL-L0 jitter(256)_WITH_RETRY OK: %d\n", value);
@@ -1155,7 +1162,7 @@ static int ElectJudgeDVDDLL1Jitter256WithRetry(const char *result, int len)
     int value;
 
     value = (int)strtoul(&result[1], NULL, 16);
-    if (value <= (ConCEXDEX ? 0x4C00 : 0x2D00))
+    if (ElectRecordCheck("DVD-DL-L1 JITTER (256)", value, 0, ConCEXDEX ? 0x4C00 : 0x2D00))
     {
         Enable2ndJitter256Check = 0;
         PlatDPrintf("DVD-DL-L0 jitter(256)_WITH_RETRY OK: %d\n", value);
@@ -1193,7 +1200,7 @@ static int ElectJudgeCDRFDCLevel(const char *data, int len)
     value2    = (unsigned short int)strtoul(&data[3], NULL, 16);
     result    = value - value2;
 
-    if (result >= 0x49 && result <= 0x89)
+    if (ElectRecordCheck("CD RFDC LEVEL", result, 0x49, 0x89))
     {
         PlatDPrintf("CD RFDC level OK: %d\n", result);
         return 0;
@@ -1217,7 +1224,7 @@ static int ElectJudgeDVDSLRFDCLevel(const char *data, int len)
     value2    = (unsigned short int)strtoul(&data[3], NULL, 16);
     result    = value - value2;
 
-    if (result >= 0x35)
+    if (ElectRecordCheck("DVD-SL RFDC LEVEL", result, 0x35, ELECT_NO_LIMIT))
     {
         PlatDPrintf("DVD-SL RFDC level OK: %d\n", result);
         return 0;
@@ -1241,7 +1248,7 @@ static int ElectJudgeDVDDLL0RFDCLevel(const char *data, int len)
     value2    = (unsigned short int)strtoul(&data[3], NULL, 16);
     result    = value - value2;
 
-    if (result >= 0x35)
+    if (ElectRecordCheck("DVD-DL-L0 RFDC LEVEL", result, 0x35, ELECT_NO_LIMIT))
     {
         PlatDPrintf("DVD-DL-L0 RFDC level OK: %d\n", result);
         return 0;
@@ -1265,7 +1272,7 @@ static int ElectJudgeDVDDLL1RFDCLevel(const char *data, int len)
     value2    = (unsigned short int)strtoul(&data[3], NULL, 16);
     result    = value - value2;
 
-    if (result >= 0x35)
+    if (ElectRecordCheck("DVD-DL-L1 RFDC LEVEL", result, 0x35, ELECT_NO_LIMIT))
     {
         PlatDPrintf("DVD-DL-L1 RFDC level OK: %d\n, result");
         return 0;
@@ -1300,14 +1307,14 @@ static int ElectJudgeCDTPP(const char *data, int len)
     // Subtract value2 from value1 (3A)
     value1 -= value2;
 
-    if (value1 >= 0x35 && value1 <= 0x7E) // TPP check
+    if (ElectRecordCheck("CD TPP", value1, 0x35, 0x7E)) // TPP check
     {
         PlatDPrintf("CD TPP OK: %d\n", value1);
         // Tbal check
         sub32 = value3 - value2;
         Tbal  = (int)((value1 * 0.5f - sub32) / value1 * 100);
 
-        if (Tbal >= -30 && Tbal <= 30)
+        if (ElectRecordCheck("CD TPP TBAL", Tbal, -30, 30))
         {
             PlatDPrintf("CD TPP Tbal  OK: %ld\n", Tbal);
             return 0;
@@ -1357,7 +1364,7 @@ static int JudgeDVDSLFocusOffset(const char *data, int len)
 
     offset = (ConFocusOffset * 0.5f - (value6 - value3)) / ConFocusOffset * 100;
 
-    if (min <= offset && offset <= max)
+    if (ElectRecordCheck("DVD-SL FOCUS OFFSET", offset, min, max))
     {
         PlatDPrintf("DVD-SL FOCUS OFFSET Check OK: %f\n", offset);
         return 0;
@@ -1382,7 +1389,7 @@ static int JudgeDVDSLDeFocusOffset(const char *data, int len)
 
     result = offset / (ConFocusOffset << 2) * 100.0f;
 
-    if (result >= -16.0f && result <= 16.0f)
+    if (ElectRecordCheck("DVD-SL DE-FOCUS OFFSET", result, -16.0f, 16.0f))
     {
         PlatDPrintf("DVD-SL DE-FOCUS OFFSET Check OK: %f\n", result);
         return 0;
@@ -1398,17 +1405,23 @@ static int JudgeDVDSLFBOffset(const char *data, int len)
 {
     char number[3];
     unsigned short int FbOffsetHi, FbOffsetLo;
+    int HiOK, LoOK;
 
     strncpy(number, &data[5], 2);
     number[2]  = '\0';
     FbOffsetHi = (unsigned short int)strtoul(number, NULL, 16);
     FbOffsetLo = (unsigned short int)strtoul(&data[7], NULL, 16);
 
-    if ((FbOffsetHi <= 0x4C) || (FbOffsetHi >= 0xB4 && FbOffsetHi <= 0xFF))
+    // Either side of the 0x4D-0xB3 band is acceptable, which a single min/max cannot express.
+    HiOK = (FbOffsetHi <= 0x4C) || (FbOffsetHi >= 0xB4 && FbOffsetHi <= 0xFF);
+    LoOK = (FbOffsetLo <= 0x4C) || (FbOffsetLo >= 0xB4 && FbOffsetLo <= 0xFF);
+    ElectRecordValue("DVD-SL FB OFFSET (HI)", FbOffsetHi, ELECT_NO_LIMIT, ELECT_NO_LIMIT, HiOK);
+    ElectRecordValue("DVD-SL FB OFFSET (LO)", FbOffsetLo, ELECT_NO_LIMIT, ELECT_NO_LIMIT, LoOK);
+    if (HiOK)
     {
         PlatDPrintf("DVD-SL FB OFFSET (HI) OK: %d\n", FbOffsetHi);
 
-        if ((FbOffsetLo <= 0x4C) || (FbOffsetLo >= 0xB4 && FbOffsetLo <= 0xFF))
+        if (LoOK)
         {
             PlatDPrintf("DVD-SL FB OFFSET (LO) Check OK: %d\n", FbOffsetLo);
             return 0;
@@ -1428,6 +1441,9 @@ static int JudgeDVDSLFBOffset(const char *data, int len)
 
 static int ElectTxHandler(MechaTask_t *task)
 {
+    if (ElectAborted)
+        return ECANCELED;
+
     switch (task->tag)
     {
         case MECHA_CMD_TAG_ELECT_CD_TYPE:
@@ -1594,56 +1610,364 @@ static int ElectRxHandler(MechaTask_t *task, const char *result, short int len)
     }
 }
 
-int ElectAutoAdjust(void)
+/*  Sent before resuming from a later stage, as the previous attempt may have been
+    aborted with the disc still spinning. The slim consoles have no tray. */
+static const ElectMechaTaskPrep_t ElectResumeCommands[] = {
+    {1, 0, 3000, MECHA_CMD_FOCUS_UPDOWN, "RESUME STOP", "00"},
+    {2, 0, 3000, MECHA_CMD_SLED_POS_HOME, "RESUME SLED HOME POSITION", NULL},
+    {3, 0, 6000, MECHA_CMD_TRAY, "RESUME (TRAY OPEN)", "01"},
+    {-1, -1, -1, -1, NULL, NULL},
+};
+
+static const char *ElectStageNames[ELECT_STAGE_COUNT] = {"CD", "DVD-SL", "DVD-DL", "Checksum"};
+
+#define ELECT_CHECKPOINT_MAX_WORDS 0x200 // Every word of the EEPROM, as each word is only kept once.
+
+/*  EEPROM words read or written by the completed stages, with the stage that last
+    touched them. These are re-read before resuming, to detect stale results. */
+static struct ElectCheckpoint
 {
-    int result;
-    const ElectMechaTaskPrep_t *cmd;
+    unsigned char type, completed;
+    unsigned short int count;
+    struct
+    {
+        u16 word, data;
+        unsigned char stage;
+    } words[ELECT_CHECKPOINT_MAX_WORDS];
+} ElectCheckpoint;
+static unsigned char ElectCurrentStage;
+static u32 ElectStepStart;
+static char ElectCheckpointFile[64];
+
+const char *ElectGetStageName(int stage)
+{
+    return (stage >= 0 && stage < ELECT_STAGE_COUNT) ? ElectStageNames[stage] : "-";
+}
+
+// Named after the console, so that a checkpoint is never applied to a different one.
+static void ElectInitCheckpointFilename(void)
+{
+    const struct MechaIdentRaw *RawData;
+    u32 serial = 0;
+    u8 emcs    = 0;
+
+    if (EEPROMInitSerial() == 0)
+        EEPROMGetSerial(&serial, &emcs);
+    RawData = MechaGetRawIdent();
+    snprintf(ElectCheckpointFile, sizeof(ElectCheckpointFile), "elect_%07u_%s_%08x.chk", serial, RawData->cfd, RawData->cfc);
+}
+
+static int ElectCheckpointRecord(u16 word, u16 data)
+{
+    int i;
+
+    for (i = 0; i < ElectCheckpoint.count; i++)
+    {
+        if (ElectCheckpoint.words[i].word == word)
+            break;
+    }
+
+    if (i >= ELECT_CHECKPOINT_MAX_WORDS) // A word that was not kept could not be checked before resuming.
+    {
+        PlatShowEMessage("ELECT: Too many EEPROM words for the checkpoint (0x%03x).\n", word);
+        return ENOSPC;
+    }
+
+    ElectCheckpoint.words[i].word  = word;
+    ElectCheckpoint.words[i].data  = data;
+    ElectCheckpoint.words[i].stage = ElectCurrentStage;
+    if (i == ElectCheckpoint.count)
+        ElectCheckpoint.count++;
+
+    return 0;
+}
+
+static int ElectSaveCheckpoint(void)
+{
+    FILE *file;
+    int i;
+
+    if ((file = fopen(ElectCheckpointFile, "w")) == NULL)
+        return -errno;
+
+    fprintf(file, "type %u\n"
+                  "completed %u\n",
+            ElectCheckpoint.type, ElectCheckpoint.completed);
+    for (i = 0; i < ElectCheckpoint.count; i++)
+        fprintf(file, "%04x %04x %u\n", ElectCheckpoint.words[i].word, ElectCheckpoint.words[i].data, ElectCheckpoint.words[i].stage);
+    fclose(file);
+
+    return 0;
+}
+
+static void ElectResetCheckpoint(void)
+{
+    memset(&ElectCheckpoint, 0, sizeof(ElectCheckpoint));
+    ElectCheckpoint.type = ConType;
+    remove(ElectCheckpointFile);
+}
+
+int ElectLoadCheckpoint(void)
+{
+    unsigned int type, completed, word, data, stage;
+    int i, resume;
+    u16 value;
+    FILE *file;
+
+    memset(&ElectCheckpoint, 0, sizeof(ElectCheckpoint));
+    ElectCheckpoint.type = ConType;
+
+    ElectInitCheckpointFilename();
+    if ((file = fopen(ElectCheckpointFile, "r")) == NULL)
+        return ELECT_STAGE_CD;
+
+    if (fscanf(file, "type %u completed %u", &type, &completed) != 2 || type != ConType || completed >= ELECT_STAGE_COUNT)
+    {
+        PlatShowMessage("Ignoring checkpoint %s: it does not belong to this MECHACON.\n", ElectCheckpointFile);
+        fclose(file);
+        return ELECT_STAGE_CD;
+    }
+
+    while (ElectCheckpoint.count < ELECT_CHECKPOINT_MAX_WORDS && fscanf(file, "%x %x %u", &word, &data, &stage) == 3)
+    {
+        ElectCheckpoint.words[ElectCheckpoint.count].word  = (u16)word;
+        ElectCheckpoint.words[ElectCheckpoint.count].data  = (u16)data;
+        ElectCheckpoint.words[ElectCheckpoint.count].stage = (unsigned char)stage;
+        ElectCheckpoint.count++;
+    }
+    fclose(file);
+
+    // A stage has to be redone if anything it left in the EEPROM has changed since.
+    resume = completed;
+    for (i = 0; i < ElectCheckpoint.count; i++)
+    {
+        if (ElectCheckpoint.words[i].stage < resume &&
+            (EEPROMReadWord(ElectCheckpoint.words[i].word, &value) != 0 || value != ElectCheckpoint.words[i].data))
+        {
+            PlatShowMessage("EEPROM 0x%03x changed since the %s stage.\n", ElectCheckpoint.words[i].word, ElectStageNames[ElectCheckpoint.words[i].stage]);
+            resume = ElectCheckpoint.words[i].stage;
+        }
+    }
+
+    for (i = 0; i < ElectCheckpoint.count;)
+    {
+        if (ElectCheckpoint.words[i].stage >= resume)
+            ElectCheckpoint.words[i] = ElectCheckpoint.words[--ElectCheckpoint.count];
+        else
+            i++;
+    }
+    ElectCheckpoint.completed = resume;
+
+    return resume;
+}
+
+static int ElectStageRxHandler(MechaTask_t *task, const char *result, short int len)
+{
+    char address[5];
+    int status;
+    u32 now;
+
+    // Operator prompts and waits are not steps, but they do restart the step timer.
+    now = PlatGetTicks();
+    if (task->id != MECHA_TASK_ID_UI)
+        ElectRecordStep(ElectCurrentStage, task->label, now - ElectStepStart);
+    ElectProfileTask(ElectCurrentStage, task, ElectStepStart, now);
+    ElectStepStart = now;
+
+    status = ElectRxHandler(task, result, len);
+    if (task->id != MECHA_TASK_ID_UI)
+        ElectRecordStepVerdict(status == 0);
+
+    if (status == 0 && result[0] == '0')
+    {
+        switch (task->command)
+        {
+            case MECHA_CMD_EEPROM_WRITE: // ce0aaaadddd
+                strncpy(address, task->args, 4);
+                address[4] = '\0';
+                status = ElectCheckpointRecord((u16)strtoul(address, NULL, 16), (u16)strtoul(&task->args[4], NULL, 16));
+                break;
+            case MECHA_CMD_EEPROM_READ: // 0aaaadddd
+                if (len == 9)
+                {
+                    strncpy(address, &result[1], 4);
+                    address[4] = '\0';
+                    status = ElectCheckpointRecord((u16)strtoul(address, NULL, 16), (u16)strtoul(&result[5], NULL, 16));
+                }
+                break;
+        }
+    }
+
+    return status;
+}
 
+static const ElectMechaTaskPrep_t *ElectGetAutoAdjCommands(void)
+{
     switch (ConType)
     {
         case MECHA_TYPE_36:
         case MECHA_TYPE_38:
-            cmd = AutoAdjACommands;
-            break;
+            return AutoAdjACommands;
         case MECHA_TYPE_39:
-            cmd = AutoAdj139Commands;
-            break;
+            return AutoAdj139Commands;
         case MECHA_TYPE_F:
-            cmd = AutoAdjFCommands;
-            break;
+            return AutoAdjFCommands;
         case MECHA_TYPE_G:
-            cmd = AutoAdjGCommands;
-            break;
+            return AutoAdjGCommands;
         case MECHA_TYPE_G2:
-            cmd = AutoAdjG2Commands;
-            break;
+            return AutoAdjG2Commands;
         case MECHA_TYPE_40:
-            if (ConSlim)
-                cmd = AutoAdjSlimCommands;
-            else
-                cmd = AutoAdj140Commands;
-            break;
+            return ConSlim ? AutoAdjSlimCommands : AutoAdj140Commands;
         default:
             PlatShowEMessage("ELECT: Unsupported MECHACON.\n");
-            return EINVAL;
+            return NULL;
     }
+}
 
-    PlatDPrintf("\n--- AUTO ELECT ADJUSTMENT START ---\n"
-                "MECHA type: %d\n\n",
-                ConType);
+/*  Each disc stage starts at the prompt for its disc. The checksum stage starts at the
+    checksum write that precedes the final checksum check. A stage that is not in the table
+    starts where the next one does, so it is empty. Returns EINVAL if the requested stage is. */
+static int ElectFindStages(const ElectMechaTaskPrep_t *cmd, int *start, int stage)
+{
+    int i, LastWrite;
+
+    for (i = ELECT_STAGE_CD + 1; i < ELECT_STAGE_COUNT; i++)
+        start[i] = -1;
+    start[ELECT_STAGE_CD] = 0;
+    for (i = 0, LastWrite = 0; cmd[i].id != 0xFF; i++)
+    {
+        // A disc stage starts with the tray opening for its disc, so that its prompt can be announced while the tray moves.
+        if (cmd[i].id == MECHA_TASK_ID_UI && cmd[i].command == MECHA_TASK_UI_CMD_MSG)
+        {
+            if (strstr(cmd[i].label, "DVD-SL") != NULL)
+                start[ELECT_STAGE_DVDSL] = (i > 0 && cmd[i - 1].command == MECHA_CMD_TRAY) ? i - 1 : i;
+            else if (strstr(cmd[i].label, "DVD-DL") != NULL)
+                start[ELECT_STAGE_DVDDL] = (i > 0 && cmd[i - 1].command == MECHA_CMD_TRAY) ? i - 1 : i;
+        }
+        else if (cmd[i].command == MECHA_CMD_WRITE_CHECKSUM)
+            LastWrite = i;
+        else if (cmd[i].tag == MECHA_CMD_TAG_ELECT_EEPROM_CHECKSUM_CHK)
+            start[ELECT_STAGE_CHECKSUM] = LastWrite;
+    }
+    start[ELECT_STAGE_COUNT] = i;
+    for (i = ELECT_STAGE_COUNT - 1; i > ELECT_STAGE_CD; i--)
+    {
+        if (start[i] < 0)
+            start[i] = start[i + 1];
+    }
 
-    for (result = 0; cmd->id != 0xFF; cmd++)
+    if (start[stage] == start[stage + 1])
     {
-        if ((result = MechaCommandAdd(cmd->command, cmd->args, cmd->id, cmd->tag, cmd->timeout, cmd->label)) != 0)
+        PlatShowEMessage("ELECT: There is no %s stage for this MECHACON.\n", ElectGetStageName(stage));
+        return EINVAL;
+    }
+
+    return 0;
+}
+
+static int ElectAddCommands(const ElectMechaTaskPrep_t *cmd, int first, int last)
+{
+    int result;
+
+    for (result = 0; first < last && cmd[first].id != 0xFF; first++)
+    {
+        if (ConSlim && cmd[first].command == MECHA_CMD_TRAY)
+            continue;
+        // Disc swaps also complete when the tray is pushed in (one switch change) or the lid is opened and closed (two).
+        if (cmd[first].id == MECHA_TASK_ID_UI && cmd[first].command == MECHA_TASK_UI_CMD_MSG)
+            result = MechaCommandAdd(MECHA_TASK_UI_CMD_MSG_SW, ConSlim ? "2" : "1", cmd[first].id, cmd[first].tag, cmd[first].timeout, cmd[first].label);
+        else
+            result = MechaCommandAdd(cmd[first].command, cmd[first].args, cmd[first].id, cmd[first].tag, cmd[first].timeout, cmd[first].label);
+        if (result != 0)
             break;
     }
 
-    if (result == 0)
+    if (result != 0)
+        MechaCommandListClear();
+
+    return result;
+}
+
+int ElectSimulateAutoAdjust(int stage)
+{
+    const ElectMechaTaskPrep_t *cmd;
+    int start[ELECT_STAGE_COUNT + 1];
+    int result;
+
+    if ((cmd = ElectGetAutoAdjCommands()) == NULL)
+        return EINVAL;
+    ElectAborted = 0;
+    if ((result = ElectFindStages(cmd, start, stage)) != 0)
+        return result;
+
+    result = 0;
+    if (stage != ELECT_STAGE_CD)
+        result = ElectAddCommands(ElectResumeCommands, 0, sizeof(ElectResumeCommands) / sizeof(ElectResumeCommands[0]));
+    if (result == 0 && (result = ElectAddCommands(cmd, start[stage], start[ELECT_STAGE_COUNT])) == 0)
     {
-        result = MechaCommandExecuteList(&ElectTxHandler, &ElectRxHandler);
+        result = MechaCommandSimulateList(&ElectTxHandler);
+        MechaCommandListClear();
+    }
+
+    return result;
+}
+
+void ElectAbort(void)
+{
+    ElectAborted = 1;
+}
+
+int ElectAutoAdjust(int stage)
+{
+    const ElectMechaTaskPrep_t *cmd;
+    int start[ELECT_STAGE_COUNT + 1];
+    int result;
+
+    ElectAborted = 0; // An abort only applies to the run it was made during.
+    PlatDPrintf("\n--- AUTO ELECT ADJUSTMENT START ---\n"
+                "MECHA type: %d\n"
+                "First stage: %s\n\n",
+                ConType, ElectGetStageName(stage));
+
+    if ((cmd = ElectGetAutoAdjCommands()) == NULL)
+        return EINVAL;
+    if ((result = ElectFindStages(cmd, start, stage)) != 0)
+        return result;
+    ElectInitCheckpointFilename(); // Before anything is sent, while the ident data is still cached.
+    ElectRecordBegin(stage);
+    if (ElectProfiling)
+        ElectProfileBegin();
+
+    if (stage == ELECT_STAGE_CD || stage > ElectCheckpoint.completed)
+    {
+        ElectResetCheckpoint();
+        stage  = ELECT_STAGE_CD;
+        result = 0;
     }
     else
-        MechaCommandListClear();
+        result = ElectAddCommands(ElectResumeCommands, 0, sizeof(ElectResumeCommands) / sizeof(ElectResumeCommands[0]));
+
+    while (result == 0 && stage < ELECT_STAGE_COUNT)
+    {
+        ElectCurrentStage = stage;
+        MetricsOperation("elect", ElectGetStageName(stage));
+        ElectStepStart = PlatGetTicks();
+        if ((result = ElectAddCommands(cmd, start[stage], start[stage + 1])) == 0 &&
+            (result = MechaCommandExecuteList(&ElectTxHandler, &ElectStageRxHandler)) == 0)
+        {
+            ElectCheckpoint.completed = ++stage;
+            if (stage < ELECT_STAGE_COUNT)
+                ElectSaveCheckpoint();
+        }
+    }
+
+    MetricsOperation(NULL, NULL);
+    ElectRecordEnd(result);
+    ElectProfileEnd();
+    if (result == 0)
+        ElectResetCheckpoint();
+    else if (ElectCheckpoint.completed > ELECT_STAGE_CD)
+        PlatShowMessage("ELECT stopped in the %s stage. It can be resumed from there.\n", ElectGetStageName(stage));
 
     PlatDPrintf("\nAdjustment result: %d\n"
                 "--- AUTO ELECT ADJUSTMENT FIN ---\n",
@@ -62,4 +62,18 @@
         Disc Detect CD/DVD Ratio:  >= 1.80 / G/H/I-chassis: >=1.73
         EEPROM Checksum:                         0 */
 
-int ElectAutoAdjust(void);
+enum ELECT_STAGE
+{
+    ELECT_STAGE_CD = 0,
+    ELECT_STAGE_DVDSL,
+    ELECT_STAGE_DVDDL,
+    ELECT_STAGE_CHECKSUM,
+
+    ELECT_STAGE_COUNT
+};
+
+int ElectLoadCheckpoint(void); // Returns the first stage that has to be (re)done for this console.
+const char *ElectGetStageName(int stage);
+int ElectAutoAdjust(int stage);
+void ElectAbort(void); // Stops the run in progress before its next command (ECANCELED), e.g. from a prompt handler.
+int ElectSimulateAutoAdjust(int stage); // Shows the ELECT command list and its estimated duration, without sending anything.
@@ -267,7 +267,9 @@ void MenuID(void)
     char done;
     int choice;
 
-    if (MechaInitModel() != 0 || EEPROMInitID() != 0)
+    if (ProbeConsole(MECHA_PROBE_FULL) != 0)
+        return;
+    if (EEPROMInitID() != 0)
     {
         DisplayConnHelp();
         return;
@@ -8,57 +8,59 @@
 #include "main.h"
 #include "mecha.h"
 #include "eeprom.h"
+#include "metrics.h"
+#include "elect-record.h"
+#include "pmap.h"
+
+#define RECONNECT_TIMEOUT   60000 // ms
+#define LINK_TEST_EXCHANGES 200
+
+struct PmapSession *ConsoleSession;
 
 void DisplayRawIdentData(void)
 {
-    u8 tm, md;
-    const struct MechaIdentRaw *RawData;
+    struct PmapIdent ident;
 
-    MechaGetMode(&tm, &md);
-    RawData = MechaGetRawIdent();
+    if (PmapGetIdent(ConsoleSession, MECHA_PROBE_IDENT, &ident) != 0)
+        return;
 
     PlatShowMessage("\nTestMode.%d MD1.%d\n"
            "CFD:\t\t0x%s\n"
            "CFC:\t\t%#08x\n"
            "Version:\t%#04x\n",
-           tm, md, RawData->cfd, RawData->cfc, RawData->VersionID);
+           ident.TestMode, ident.MD, ident.cfd, ident.cfc, ident.VersionID);
 }
 
 void DisplayCommonConsoleInfo(void)
 {
-    const char *ModelName;
-    u32 serial;
-    u8 emcs, tm, md;
+    struct PmapIdent ident;
+
+    if (PmapGetIdent(ConsoleSession, MECHA_PROBE_FULL, &ident) != 0)
+        return;
 
-    MechaGetMode(&tm, &md);
     PlatShowMessage("\nTestMode.%d MD1.%d\tChecksum: %s\n"
            "MECHA:\t\t%s (%s)\n",
-           tm, md, MechaGetEEPROMStat() ? "OK" : "NG",
-           MechaGetDesc(), MechaGetCEXDEX() == 0 ? "DEX" : "CEX");
+           ident.TestMode, ident.MD, ident.ChecksumOK ? "OK" : "NG",
+           ident.mecha, ident.cex ? "CEX" : "DEX");
     PlatShowMessage("Serial:\t\t");
-    if (EEPROMInitSerial() == 0)
+    if (ident.HasSerial)
     {
-        EEPROMGetSerial(&serial, &emcs);
         PlatShowMessage("%07u\t\t"
                "EMCS:\t%02x\n",
-               serial, emcs);
+               ident.serial, ident.emcs);
     }
     else
         PlatShowMessage("<no serial number>\n");
-    PlatShowMessage("MODELID:\t%04x\t\tTV:\t%s\n", EEPROMGetModelID(), MechaGetTVSystemDesc(EEPROMGetTVSystem()));
+    PlatShowMessage("MODELID:\t%04x\t\tTV:\t%s\n", ident.ModelID, ident.TVSystem);
     PlatShowMessage("Model:\t\t");
-    if (EEPROMInitModelName() == 0)
-    {
-        ModelName = EEPROMGetModelName();
-        PlatShowMessage("%s\n", ModelName);
-    }
+    if (ident.HasModel)
+        PlatShowMessage("%s\n", ident.model);
     else
         PlatShowMessage("<no model name>\n");
     PlatShowMessage("RTC:\t\t%s (%s)\n"
            "OP:\t\t%s\t\tLens:\t%s\n",
-           MechaGetRTCName(MechaGetRTCType()), MechaGetRtcStatusDesc(MechaGetRTCType(), MechaGetRTCStat()),
-           MechaGetOPTypeName(MechaGetOP()), MechaGetLensTypeName(MechaGetLens()));
-    if (EEPROMGetEEPROMStatus() == 1)
+           ident.rtc, ident.RtcStatus, ident.op, ident.lens);
+    if (ident.erased)
         PlatShowMessage("EEPROM was erased (defaults must now be loaded).\n");
 }
 
@@ -68,25 +70,190 @@ void DisplayConnHelp(void)
            "Check the connections, press the RESET button and try again.\n\n");
 }
 
+/*  Probes the console up to level (MECHA_PROBE_*). If it does not reply, waits for it to come back, e.g. after it was reset
+    or its cable was pulled, so that the operator can carry on where they were. Returns 0 if the console is ready. */
+int ProbeConsole(int level)
+{
+    if (PmapProbe(ConsoleSession, level) == 0)
+        return 0;
+
+    PlatShowMessage("The console is not replying. Waiting for it to come back (check the cable, or press the RESET button)...\n");
+    if (PmapReconnect(ConsoleSession, RECONNECT_TIMEOUT) == 0 && PmapProbe(ConsoleSession, level) == 0)
+    {
+        PlatShowMessage("The console is back.\n");
+        return 0;
+    }
+
+    DisplayConnHelp();
+    return 1;
+}
+
+static int DiscoverConsoles(int count, char *const patterns[])
+{
+    struct PmapPort ports[PLAT_MAX_PORTS];
+    int i, found, consoles, result;
+
+    if ((result = PmapDiscover(count, patterns, ports, PLAT_MAX_PORTS, &found)) != 0)
+    {
+        PlatShowEMessage("Cannot probe the serial devices (%d).\n", result);
+        return result;
+    }
+
+    for (i = 0, consoles = 0; i < found; i++)
+    {
+        if (ports[i].status == 0)
+        {
+            PlatShowMessage("%-20s MD%u TM%u cfd %s cfc %08x version ID %04x\n", ports[i].device, ports[i].MD, ports[i].TestMode,
+                            ports[i].cfd, ports[i].cfc, ports[i].VersionID);
+            consoles++;
+        }
+        else
+            PlatShowMessage("%-20s no console (%d)\n", ports[i].device, ports[i].status);
+    }
+    PlatShowMessage("%d console(s) found on %d device(s).\n", consoles, found);
+
+    return consoles > 0 ? 0 : ENODEV;
+}
+
+// Returns 0 if nothing went wrong on the link.
+static int DisplayLinkStats(const struct PmapLinkStats *stats)
+{
+    u32 rate;
+
+    if (stats->status != 0)
+    {
+        PlatShowMessage("%s: not tested (%d).\n", stats->device, stats->status);
+        return 1;
+    }
+
+    rate = stats->duration > 0 ? (stats->sent + stats->received) * 1000 / stats->duration : 0;
+    PlatShowMessage("%s: %d exchanges, %d timeouts, %d NG, %d invalid, %d mismatched replies\n"
+                    "\tRTT (ms): min %u, median %u, 90%% %u, 99%% %u, max %u, mean %u\n"
+                    "\t%u B/s, %u%% of the %u B/s of 57600 8N1 (%u of %u ms on the wire)\n",
+                    stats->device, stats->exchanges, stats->timeouts, stats->refused, stats->invalid, stats->mismatched,
+                    stats->RttMin, stats->RttMedian, stats->Rtt90, stats->Rtt99, stats->RttMax,
+                    stats->replies > 0 ? stats->RttTotal / stats->replies : 0,
+                    rate, rate * 100 / PMAP_LINK_BYTES_PER_S, PMAP_LINK_BYTES_PER_S, stats->WireTime, stats->duration);
+    if (stats->HasLineErrors)
+        PlatShowMessage("\tLine errors: %u framing, %u overrun, %u parity, %u break\n", stats->LineErrors.frame,
+                        stats->LineErrors.overrun, stats->LineErrors.parity, stats->LineErrors.brk);
+    else
+        PlatShowMessage("\tLine errors: not counted by this driver\n");
+
+    return stats->replies == 0 || stats->timeouts > 0 || stats->refused > 0 || stats->invalid > 0 || stats->mismatched > 0 ||
+           stats->LineErrors.frame > 0 || stats->LineErrors.overrun > 0 || stats->LineErrors.parity > 0 || stats->LineErrors.brk > 0;
+}
+
+// Tests the link to each device, or to each console that can be found if none are given, all at once.
+static int TestLinks(int count, char *const devices[])
+{
+    struct PmapLinkStats stats[PLAT_MAX_PORTS];
+    struct PmapPort ports[PLAT_MAX_PORTS];
+    char *consoles[PLAT_MAX_PORTS];
+    int i, found, result, failed;
+
+    if (count < 1)
+    {
+        if ((result = PmapDiscover(0, NULL, ports, PLAT_MAX_PORTS, &found)) != 0)
+            return result;
+        for (i = 0, count = 0; i < found; i++)
+        {
+            if (ports[i].status == 0)
+                consoles[count++] = ports[i].device;
+        }
+        if (count < 1)
+        {
+            PlatShowMessage("No consoles found.\n");
+            return ENODEV;
+        }
+        devices = consoles;
+    }
+
+    if ((result = PmapLinkTestPorts(count, devices, LINK_TEST_EXCHANGES, stats)) != 0)
+    {
+        PlatShowEMessage("Cannot test the links (%d).\n", result);
+        return result;
+    }
+
+    for (i = 0, failed = 0; i < count; i++)
+        failed += DisplayLinkStats(&stats[i]);
+
+    return failed;
+}
+
 int main(int argc, char *argv[])
 {
+    struct PmapOptions options = {NULL, 0, 1};
     short int choice;
     unsigned char done;
 
+    // -metrics <file> [<interval>] may come before any of the other arguments.
+    if (argc > 2 && !strcmp(argv[1], "-metrics"))
+    {
+        if (argc > 3 && isdigit((unsigned char)argv[3][0]))
+        {
+            MetricsConfigure(argv[2], (unsigned short int)atoi(argv[3]));
+            argc -= 3;
+            argv += 3;
+        }
+        else
+        {
+            MetricsConfigure(argv[2], METRICS_DEFAULT_INTERVAL);
+            argc -= 2;
+            argv += 2;
+        }
+    }
+
+    if (argc > 2 && !strcmp(argv[1], "-elect"))
+    {
+        if (ElectRecordPrepare() != 0)
+            PlatShowEMessage("ELECT: cannot create the measurement record.\n");
+        return PlatRunStations(argc - 2, argv + 2, &ElectStation);
+    }
+
+    if (argc > 1 && !strcmp(argv[1], "-discover"))
+        return DiscoverConsoles(argc - 2, argv + 2);
+
+    if (argc > 1 && !strcmp(argv[1], "-linktest"))
+        return TestLinks(argc - 2, argv + 2);
+
+    if (argc > 3 && !strcmp(argv[1], "-daemon"))
+        return PlatRunDaemon(argv[2], argc - 3, argv + 3, &DaemonServe);
+
+    if (argc == 5 && !strcmp(argv[1], "-mecha") && (!pstricmp(argv[2], "ADJ") || !pstricmp(argv[2], "TEST")))
+    {
+        if (PmapOpen(argv[4], &options, &ConsoleSession) != 0)
+        {
+            PlatShowMessage("Cannot open %s.\n", argv[4]);
+            return ENODEV;
+        }
+
+        choice = MechaRunScript(!pstricmp(argv[2], "TEST"), argv[3]);
+        PmapClose(ConsoleSession);
+
+        return choice;
+    }
+
     if (argc != 2)
     {
-        PlatShowMessage("Syntax error. Syntax: PMAP <COM port>\n");
+        PlatShowMessage("Syntax error. Syntax: PMAP <COM port>\n"
+                        "       ELECT on several consoles: PMAP -elect <COM port> [<COM port> ...]\n"
+                        "       MECHA script: PMAP -mecha <ADJ|TEST> <script file> <COM port>\n"
+                        "       Find consoles: PMAP -discover [<device pattern> ...]\n"
+                        "       Link test: PMAP -linktest [<COM port> ...] (all consoles found if none are given)\n"
+                        "       Daemon: PMAP -daemon <socket> <COM port> [<COM port> ...]\n"
+                        "       Metrics: PMAP -metrics <file> [<interval in s>] <any of the above>\n");
         return EINVAL;
     }
 
-    if (PlatOpenCOMPort(argv[1]) != 0)
+    if (PmapOpen(argv[1], &options, &ConsoleSession) != 0)
     {
         PlatShowMessage("Cannot open %s.\n", argv[1]);
         return ENODEV;
     }
 
-    // TODO!
-    PlatDebugInit();
+    if (PmapProbe(ConsoleSession, MECHA_PROBE_LINK) != 0)
+        DisplayConnHelp();
 
     done = 0;
     do
@@ -129,10 +296,8 @@ int main(int argc, char *argv[])
                 MenuMECHA();
                 break;
             case 4:
-                if (MechaInitModel() == 0)
+                if (ProbeConsole(MECHA_PROBE_IDENT) == 0)
                     DisplayRawIdentData();
-                else
-                    DisplayConnHelp();
                 break;
 #ifdef ID_MANAGEMENT
             case 99:
@@ -144,9 +309,7 @@ int main(int argc, char *argv[])
         }
     } while (!done);
 
-    PlatCloseCOMPort();
-
-    PlatDebugDeinit();
+    PmapClose(ConsoleSession);
 
     return 0;
 }
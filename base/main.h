@@ -1,9 +1,15 @@
+extern struct PmapSession *ConsoleSession; // The console that the menus work on.
+
 void DisplayRawIdentData(void);
 void DisplayCommonConsoleInfo(void);
 void DisplayConnHelp(void);
+int ProbeConsole(int level);
 void MenuEEPROM(void);
 void MenuELECT(void);
+int ElectStation(int station, const char *device);
+int DaemonServe(int station, const char *device);
 void MenuMECHA(void);
+int MechaRunScript(int test, const char *file);
 #ifdef ID_MANAGEMENT
 void MenuID(void);
 #endif
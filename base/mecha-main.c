@@ -64,11 +64,26 @@ static unsigned char ConIsT10K, status, SledIsAtHome, DiscDetect;
 static unsigned short int DvdJitter, StepAmount;
 static struct DvdError DvdError;
 static struct CdError CdError;
+static unsigned short int CommandErrors; // Failed commands, for scripts.
 
 typedef int (*MechaCmdFunction_t)(short int argc, char *argv[]);
 
-#define MECHA_ADJ_MAX_ARGS   4
+#define MECHA_ADJ_MAX_ARGS   5
 #define MECHA_ADJ_SYNTAX_ERR "Syntax error. For help, type HELP for help.\n"
+#define MECHA_SCRIPT_HELP    "Runs the commands in a script file, stopping at the first failed command or assertion.\n"                 \
+                             "Besides commands, a script can contain (one per line, # starts a comment):\n"                          \
+                             "\tREPEAT <count>\t\t- Repeats the lines up to the matching END.\n"                                      \
+                             "\tWAIT <ms>\t\t- Waits for the specified time.\n"                                                     \
+                             "\tSET <name> <value>\t- Stores a value in a variable.\n"                                                \
+                             "\tASSERT <value> <op> <value>\t- Fails the script unless the comparison holds. op: < <= > >= == !=\n" \
+                             "\tECHO <text>\t\t- Displays the text, with $<value> replaced by the value.\n"                           \
+                             "A value is a number, a variable or one of the last measurements:\n"                                   \
+                             "\tJITTER\t\t\t- Last JITTER reading.\n"                                                               \
+                             "\tPI-CORRECT, PI-NCORRECT, PI-MAX, PO-CORRECT, PO-NCORRECT, PO-MAX, DSP-JITTER\n"                      \
+                             "\t\t\t\t- Last ERROR DVD reading.\n"                                                                   \
+                             "\tC1, C2\t\t\t- Last ERROR CD reading.\n"                                                              \
+                             "\tERRORS\t\t\t- Number of failed commands so far.\n"                                                  \
+                             "\tLOOP\t\t\t- Iteration of the innermost REPEAT, starting from 1."
 
 static int MechaAdjInit(short int argc, char *argv[]);
 static int MechaAdjHelp(short int argc, char *argv[]);
@@ -79,8 +94,10 @@ static int MechaAdjStop(short int argc, char *argv[]);
 static int MechaAdjPause(short int argc, char *argv[]);
 static int MechaAdjAutoTilt(short int argc, char *argv[]);
 static int MechaAdjTray(short int argc, char *argv[]);
+static int MechaAdjEndurance(short int argc, char *argv[]);
 static int MechaAdjJitter(short int argc, char *argv[]);
 static int MechaAdjGetError(short int argc, char *argv[]);
+static int MechaAdjRun(short int argc, char *argv[]);
 
 static int MechaTestDiscControl(short int argc, char *argv[]);
 static int MechaTestLaserControl(short int argc, char *argv[]);
@@ -235,6 +252,25 @@ static int MechaAdjRxHandler(MechaTask_t *task, const char *result, short int le
     }
 }
 
+static void MechaAdjShowFailure(void)
+{
+    CommandErrors++;
+    PlatShowMessage("Failed to execute.\n");
+}
+
+static void MechaAdjShowError(int result)
+{
+    CommandErrors++;
+    PlatShowMessage("Error %d\n", result);
+}
+
+// For commands that cannot be used in the current state.
+static void MechaAdjShowStateError(const char *message)
+{
+    CommandErrors++;
+    PlatShowMessage("%s", message);
+}
+
 static const struct MechaDiagCommand AdjCommands[] = {
     {"INIT", "INIT <mode>", "Performs initialization. Modes:\n"
                             "\tCD\t- CD test mode.\n"
@@ -251,7 +287,11 @@ static const struct MechaDiagCommand AdjCommands[] = {
                             "\tSTEP-M IN/OUT\t- Moves the sled in/out by a number of micro-steps.\n"
                             "\tSTEP-B IN/OUT\t- Moves the sled in/out by a number of biph-steps.\n"
                             "\tSTEP <amount>\t- Sets the number of steps to move for each step command.\n"
-                            "\tTRACKING ON/OFF\t- Switches on/off tracking.",
+                            "\tTRACKING ON/OFF\t- Switches on/off tracking.\n"
+                            "\tSCAN <points> [<samples> [<file>]]\n"
+                            "\t\t\t- In PLAY mode, measures the error rates at <points> positions, STEP biph-steps\n"
+                            "\t\t\t  apart outwards, with <samples> (default: 4) reads per position.\n"
+                            "\t\t\t  The average and max of each position can be saved to a CSV file.",
      &MechaAdjSled},
     {"PLAY", "PLAY <mode>", "Starts play mode Modes:\n"
                             "\tCD:\n"
@@ -273,6 +313,9 @@ static const struct MechaDiagCommand AdjCommands[] = {
                             "\tFWD\t\t- Step the auto-tilt motor forward\n"
                             "\tREV\t\t- Step the auto-tilt motor in reverse\n"
                             "\tADJ\t\t- Auto-adjust radial skew\n"
+                            "\tSEARCH [<range>]\t- Find the minimum jitter position by measuring, within\n"
+                            "\t\t\t  <range> (default: 32) motor steps of the current position.\n"
+                            "\t\t\t  The result is not saved\n"
                             "\tWRITE\t\t- Write new parameters",
      &MechaAdjAutoTilt},
     {"TRAY", "TRAY <mode>", "Controls the tray. Modes:\n"
@@ -282,7 +325,15 @@ static const struct MechaDiagCommand AdjCommands[] = {
                             "\tOUT-SW\t-Displays the status of the OUT-switch\n"
                             "NOTE: When ejecting/retracting the tray, the sled must be in the HOME position!\n",
      &MechaAdjTray},
-    {"JITTER", "JITTER <mode>", "Gets jitter measurement. Modes: 1, 16, 256", &MechaAdjJitter},
+    {"ENDURANCE", "ENDURANCE <cycles> [<percentile> [<file>]]", "Cycles the tray and sled to test for wear, with the disc removed.\n"
+                                                                "Each movement is timed and the switches are checked after it.\n"
+                                                                "Shows the distribution of movement times, listing the movements slower than\n"
+                                                                "the percentile (default: 95). The times can also be saved to a CSV file.",
+     &MechaAdjEndurance},
+    {"JITTER", "JITTER <mode> [STREAM [<log file>]]", "Gets jitter measurement. Modes: 1, 16, 256\n"
+                                                      "\tSTREAM\t- Measures continuously until ENTER is pressed, showing the mean, min, max and p95\n"
+                                                      "\t\t  of the last samples (in decimal). The samples can also be saved to a CSV file.",
+     &MechaAdjJitter},
     {"ERROR", "ERROR", "Gets error rate measurement. Modes:\n"
                        "\tDVD\t- Gets DVD error rate measurement.\n"
                        "\tCD\t- Gets CD error rate measurement.\n",
@@ -290,6 +341,7 @@ static const struct MechaDiagCommand AdjCommands[] = {
     {"HELP", "HELP", "Displays this help message.\nType HELP <command> to get help on specific commands.\n"
                      "Entering a blank line will cause the previous command entered to be executed.",
      &MechaAdjHelp},
+    {"RUN", "RUN <script file>", MECHA_SCRIPT_HELP, &MechaAdjRun},
     {"QUIT", "QUIT", "Quits adjustment", &MechaAdjQuit},
     {NULL, NULL, NULL}};
 
@@ -324,7 +376,11 @@ static const struct MechaDiagCommand TestCommands[] = {
                             "\tSTEP-M IN/OUT\t- Moves the sled in/out by a number of micro-steps.\n"
                             "\tSTEP-B IN/OUT\t- Moves the sled in/out by a number of biph-steps.\n"
                             "\tSTEP <amount>\t- Sets the number of steps to move for each step command.\n"
-                            "\tTRACKING ON/OFF\t- Switches on/off tracking.",
+                            "\tTRACKING ON/OFF\t- Switches on/off tracking.\n"
+                            "\tSCAN <points> [<samples> [<file>]]\n"
+                            "\t\t\t- In PLAY mode, measures the error rates at <points> positions, STEP biph-steps\n"
+                            "\t\t\t  apart outwards, with <samples> (default: 4) reads per position.\n"
+                            "\t\t\t  The average and max of each position can be saved to a CSV file.",
      &MechaAdjSled},
     {"PLAY", "PLAY <mode>", "Starts play mode. Modes:\n"
                             "\t1x\t- 1x mode\n"
@@ -342,6 +398,11 @@ static const struct MechaDiagCommand TestCommands[] = {
                             "\tOUT-SW\t- Displays the status of the OUT-switch\n"
                             "*NOTE: sled must be at the HOME position!\n",
      &MechaAdjTray},
+    {"ENDURANCE", "ENDURANCE <cycles> [<percentile> [<file>]]", "Cycles the tray and sled to test for wear, with the disc removed.\n"
+                                                                "Each movement is timed and the switches are checked after it.\n"
+                                                                "Shows the distribution of movement times, listing the movements slower than\n"
+                                                                "the percentile (default: 95). The times can also be saved to a CSV file.",
+     &MechaAdjEndurance},
     {"SPIND", "SPIND <mode>", "Controls the spindle motor\n"
                               "\tKICK\t- Causes the spindle motor to \"kick\"\n"
                               "\tBRAKE\t- Brakes the spindle motor\n"
@@ -352,6 +413,7 @@ static const struct MechaDiagCommand TestCommands[] = {
     {"HELP", "HELP", "Displays this help message.\nType HELP <command> to get help on specific commands.\n"
                      "Entering a blank line will cause the previous command entered to be executed.",
      &MechaTestHelp},
+    {"RUN", "RUN <script file>", MECHA_SCRIPT_HELP, &MechaAdjRun},
     {"QUIT", "QUIT", "Quits testing", &MechaAdjQuit},
     {NULL, NULL, NULL}};
 
@@ -558,7 +620,7 @@ static int MechaAdjPlay(short int argc, char *argv[])
                 if (!pstricmp(argv[1], "FJ"))
                 {
                     if ((result = MechaCommandExecute(MECHA_CMD_FOCUS_JUMP, 2000, "0300", buffer, sizeof(buffer))) < 0 || (result = strtoul(buffer, NULL, 16)) != 0)
-                        PlatShowMessage("Error %d\n", result);
+                        MechaAdjShowError(result);
                 }
                 break;
             case MECHA_ADJ_STATE_DVDSL_PAUSE:
@@ -608,7 +670,7 @@ static int MechaAdjPlay(short int argc, char *argv[])
                 if (command != 0)
                 {
                     if ((result = MechaCommandExecute(command, timeout, NULL, buffer, sizeof(buffer))) < 0 || (result = strtoul(buffer, NULL, 16)) != 0)
-                        PlatShowMessage("Error %d\n", result);
+                        MechaAdjShowError(result);
                     else
                         status += speed;
 
@@ -643,7 +705,7 @@ static int MechaAdjPlay(short int argc, char *argv[])
                 if (command != 0)
                 {
                     if ((result = MechaCommandExecute(command, timeout, NULL, buffer, sizeof(buffer))) < 0 || (result = strtoul(buffer, NULL, 16)) != 0)
-                        PlatShowMessage("Error %d\n", result);
+                        MechaAdjShowError(result);
                     else
                         status += speed;
 
@@ -672,7 +734,7 @@ static int MechaAdjStop(short int argc, char *argv[])
         case MECHA_ADJ_STATE_CD_512:
         case MECHA_ADJ_STATE_CD_1024:
             if ((result = MechaCommandExecute(MECHA_CMD_CD_STOP, 4000, NULL, buffer, sizeof(buffer))) < 0 || (result = strtoul(buffer, NULL, 16)) != 0)
-                PlatShowMessage("Error %d\n", result);
+                MechaAdjShowError(result);
             status = MECHA_ADJ_STATE_CD;
             break;
         case MECHA_ADJ_STATE_DVDSL_PAUSE:
@@ -684,7 +746,7 @@ static int MechaAdjStop(short int argc, char *argv[])
         case MECHA_ADJ_STATE_DVDDL_1p6:
         case MECHA_ADJ_STATE_DVDDL_1p64:
             if ((result = MechaCommandExecute(MECHA_CMD_DVD_STOP, 5000, NULL, buffer, sizeof(buffer))) < 0 || (result = strtoul(buffer, NULL, 16)) != 0)
-                PlatShowMessage("Error %d\n", result);
+                MechaAdjShowError(result);
 
             switch (status)
             {
@@ -703,10 +765,226 @@ static int MechaAdjStop(short int argc, char *argv[])
             }
             break;
         default:
-            PlatShowMessage("Not in PLAY mode.\n");
+            MechaAdjShowStateError("Not in PLAY mode.\n");
+    }
+
+    return 0;
+}
+
+#define MECHA_TILT_SEARCH_RANGE  32 // Default search range around the current position, in motor steps.
+#define MECHA_TILT_SEARCH_MAX    64
+#define MECHA_TILT_COARSE_POINTS 8  // Coarse scan intervals across the range, so one more point is measured.
+#define MECHA_TILT_SAMPLES       8  // Jitter samples per position. The highest and lowest are dropped.
+#define MECHA_TILT_SETTLE        200
+#define MECHA_TILT_BACKLASH      4 // Every position is approached moving forward, by going this much further back first.
+
+static struct MechaTiltSearch
+{
+    short int position;
+    unsigned short int steps, moves;
+    unsigned char measured[MECHA_TILT_SEARCH_MAX * 2 + 1];
+    float jitter[MECHA_TILT_SEARCH_MAX * 2 + 1];
+    short int errors[MECHA_TILT_SEARCH_MAX * 2 + 1]; // DVD PI correct count, or -1.
+} TiltSearch;
+
+static int MechaTiltMove(int steps)
+{
+    char args[7];
+    int result;
+
+    if (steps == 0)
+        return 0;
+    snprintf(args, sizeof(args), "%02x%04x", steps > 0 ? 1 : 0, (unsigned short int)(steps > 0 ? steps : -steps));
+    MechaCommandAdd(MECHA_CMD_MOV_AUTO_TILT, args, 1, 0, 5000, steps > 0 ? "TILT ADJUST FWD" : "TILT ADJUST REV");
+    if ((result = MechaCommandExecuteList(&MechaAdjTxHandler, &MechaAdjRxHandler)) == 0)
+    {
+        TiltSearch.position += steps;
+        TiltSearch.steps += (steps > 0 ? steps : -steps);
+        TiltSearch.moves++;
+    }
+
+    return result;
+}
+
+static int MechaTiltMoveTo(int position)
+{
+    int result;
+
+    if (position < TiltSearch.position)
+    {
+        if ((result = MechaTiltMove(position - TiltSearch.position - MECHA_TILT_BACKLASH)) != 0)
+            return result;
+    }
+    if ((result = MechaTiltMove(position - TiltSearch.position)) == 0)
+        PlatSleep(MECHA_TILT_SETTLE);
+
+    return result;
+}
+
+static int MechaTiltCompareSamples(const void *a, const void *b)
+{
+    return (int)*(const unsigned short int *)a - (int)*(const unsigned short int *)b;
+}
+
+// Returns the trimmed mean of the jitter at the position, or a negative number if it cannot be measured.
+static float MechaTiltMeasure(int position)
+{
+    unsigned short int samples[MECHA_TILT_SAMPLES], i;
+    char buffer[8];
+    float total;
+    int index;
+
+    index = position + MECHA_TILT_SEARCH_MAX;
+    if (TiltSearch.measured[index])
+        return TiltSearch.jitter[index];
+
+    if (MechaTiltMoveTo(position) != 0)
+        return -1.0f;
+    for (i = 0; i < MECHA_TILT_SAMPLES; i++)
+    {
+        if (MechaCommandExecute(MECHA_CMD_JITTER, 1000, "02", buffer, sizeof(buffer)) < 0 || buffer[0] != '0')
+            return -1.0f;
+        samples[i] = (unsigned short int)strtoul(&buffer[1], NULL, 16);
+    }
+    qsort(samples, MECHA_TILT_SAMPLES, sizeof(samples[0]), &MechaTiltCompareSamples);
+    for (i = 1, total = 0; i < MECHA_TILT_SAMPLES - 1; i++)
+        total += samples[i];
+
+    TiltSearch.errors[index] = -1;
+    switch (status)
+    {
+        case MECHA_ADJ_STATE_DVDSL_1:
+        case MECHA_ADJ_STATE_DVDSL_1p6:
+        case MECHA_ADJ_STATE_DVDSL_1p64:
+        case MECHA_ADJ_STATE_DVDDL_1:
+        case MECHA_ADJ_STATE_DVDDL_1p6:
+        case MECHA_ADJ_STATE_DVDDL_1p64:
+            MechaCommandAdd(MECHA_CMD_DSP_ERROR_RATE, "00", 1, MECHA_CMD_TAG_MECHA_DVD_ERROR_RATE, 2000, "DVD GET DSP ERROR RATE");
+            if (MechaCommandExecuteList(&MechaAdjTxHandler, &MechaAdjRxHandler) == 0)
+                TiltSearch.errors[index] = DvdError.PICorrect;
+            break;
+    }
+
+    TiltSearch.measured[index] = 1;
+    TiltSearch.jitter[index]   = total / (MECHA_TILT_SAMPLES - 2);
+    PlatShowMessage("Position %+4d: jitter %7.1f\n", position, TiltSearch.jitter[index]);
+
+    return TiltSearch.jitter[index];
+}
+
+static void MechaTiltShowCurve(int best)
+{
+    float min, max;
+    int i, bar;
+
+    for (i = 0, min = 0, max = 0; i < MECHA_TILT_SEARCH_MAX * 2 + 1; i++)
+    {
+        if (!TiltSearch.measured[i])
+            continue;
+        if (max == 0 || TiltSearch.jitter[i] > max)
+            max = TiltSearch.jitter[i];
+        if (min == 0 || TiltSearch.jitter[i] < min)
+            min = TiltSearch.jitter[i];
+    }
+
+    PlatShowMessage("\nPosition  Jitter  PI-C\n");
+    for (i = 0; i < MECHA_TILT_SEARCH_MAX * 2 + 1; i++)
+    {
+        if (!TiltSearch.measured[i])
+            continue;
+        bar = (max > min) ? (int)((TiltSearch.jitter[i] - min) * 40 / (max - min)) : 0;
+        PlatShowMessage("%+8d %7.1f  ", i - MECHA_TILT_SEARCH_MAX, TiltSearch.jitter[i]);
+        if (TiltSearch.errors[i] >= 0)
+            PlatShowMessage("%04x", TiltSearch.errors[i]);
+        else
+            PlatShowMessage("   -");
+        PlatShowMessage(" |%.*s%s%s\n", bar + 1, "########################################", i - MECHA_TILT_SEARCH_MAX == best ? " <- best" : "",
+                        i == MECHA_TILT_SEARCH_MAX ? " (start)" : "");
     }
+}
+
+/*  Finds the minimum jitter position within range steps of the current position:
+    a coarse scan across the range first, then a golden-section search around the best coarse point.
+    Positions are relative to the starting position. The motor is left at the best position, but nothing is written:
+    the result is lost on reset. TILT WRITE cannot save it, as it runs the MECHACON's own tilt adjustment again.
+    If the search fails, the motor is moved back to the starting position. */
+static int MechaAdjTiltSearch(int range)
+{
+    int a, b, c, d, best, step, i;
+    float value, BestValue;
+
+    if (range < MECHA_TILT_COARSE_POINTS || range > MECHA_TILT_SEARCH_MAX)
+    {
+        PlatShowMessage("The range must be from %d to %d steps.\n", MECHA_TILT_COARSE_POINTS, MECHA_TILT_SEARCH_MAX);
+        return 0;
+    }
+
+    memset(&TiltSearch, 0, sizeof(TiltSearch));
+
+    // The starting position is not on the coarse grid for every range, so it is measured first.
+    best = 0;
+    if ((BestValue = MechaTiltMeasure(0)) < 0)
+        goto fail;
+
+    /*  Coarse scan of MECHA_TILT_COARSE_POINTS + 1 points including both ends, from one end to the other so that every
+        position is approached moving forward. step is the largest gap between two of them. */
+    step = (2 * range + MECHA_TILT_COARSE_POINTS - 1) / MECHA_TILT_COARSE_POINTS;
+    for (i = 0; i <= MECHA_TILT_COARSE_POINTS; i++)
+    {
+        if ((value = MechaTiltMeasure(-range + (2 * range * i) / MECHA_TILT_COARSE_POINTS)) < 0)
+            goto fail;
+        if (value < BestValue)
+        {
+            best      = -range + (2 * range * i) / MECHA_TILT_COARSE_POINTS;
+            BestValue = value;
+        }
+    }
+
+    // Golden-section search of the interval around the best coarse point.
+    a = best - step > -range ? best - step : -range;
+    b = best + step < range ? best + step : range;
+    c = b - (int)((b - a) * 0.618f + 0.5f);
+    d = a + (int)((b - a) * 0.618f + 0.5f);
+    while (b - a > 3)
+    {
+        if (c >= d)
+            d = c + 1;
+        if (MechaTiltMeasure(c) < 0 || MechaTiltMeasure(d) < 0)
+            goto fail;
+        if (MechaTiltMeasure(c) < MechaTiltMeasure(d))
+            b = d;
+        else
+            a = c;
+        c = b - (int)((b - a) * 0.618f + 0.5f);
+        d = a + (int)((b - a) * 0.618f + 0.5f);
+    }
+    for (i = a; i <= b; i++)
+    {
+        if ((value = MechaTiltMeasure(i)) < 0)
+            goto fail;
+        if (value < BestValue)
+        {
+            best      = i;
+            BestValue = value;
+        }
+    }
+
+    if (MechaTiltMoveTo(best) != 0)
+        goto fail;
+
+    MechaTiltShowCurve(best);
+    PlatShowMessage("\nBest position: %+d (jitter %.1f, was %.1f at the start).\n"
+                    "%u motor steps in %u moves. The tilt is left there, but not saved: it is lost on reset.\n",
+                    best, BestValue, TiltSearch.jitter[MECHA_TILT_SEARCH_MAX], TiltSearch.steps, TiltSearch.moves);
 
     return 0;
+
+fail:
+    CommandErrors++;
+    PlatShowMessage("Search failed at position %+d.\n", TiltSearch.position);
+    if (MechaTiltMoveTo(0) != 0)
+        PlatShowMessage("Cannot return to the starting position: the tilt is now at %+d.\n", TiltSearch.position);
+    return 0;
 }
 
 static int MechaAdjAutoTilt(short int argc, char *argv[])
@@ -719,6 +997,9 @@ static int MechaAdjAutoTilt(short int argc, char *argv[])
         return 0;
     }
 
+    if ((argc == 2 || argc == 3) && !pstricmp(argv[1], "SEARCH"))
+        return MechaAdjTiltSearch(argc == 3 ? atoi(argv[2]) : MECHA_TILT_SEARCH_RANGE);
+
     if (argc == 2)
     {
         id = 1;
@@ -726,13 +1007,13 @@ static int MechaAdjAutoTilt(short int argc, char *argv[])
         {
             MechaCommandAdd(MECHA_CMD_INIT_AUTO_TILT, NULL, id++, 0, 5000, "AUTO TILT INIT");
             if (MechaCommandExecuteList(&MechaAdjTxHandler, &MechaAdjRxHandler) != 0)
-                PlatShowMessage("Failed to execute.\n");
+                MechaAdjShowFailure();
         }
         else if (!pstricmp(argv[1], "ADJ"))
         {
             MechaCommandAdd(MECHA_CMD_ADJ_AUTO_TILT, "00", id++, 0, 15000, "TILT ADJUST");
             if (MechaCommandExecuteList(&MechaAdjTxHandler, &MechaAdjRxHandler) != 0)
-                PlatShowMessage("Failed to execute.\n");
+                MechaAdjShowFailure();
         }
         else if (!pstricmp(argv[1], "WRITE"))
         {
@@ -748,19 +1029,19 @@ static int MechaAdjAutoTilt(short int argc, char *argv[])
             MechaCommandAdd(MECHA_CMD_WRITE_CHECKSUM, "00", id++, 0, 3000, "EEPROM WRITE CHECKSUM");
             MechaCommandAdd(MECHA_CMD_READ_CHECKSUM, "00", id++, 0, 3000, "EEPROM READ CHECKSUM");
             if (MechaCommandExecuteList(&MechaAdjTxHandler, &MechaAdjRxHandler) != 0)
-                PlatShowMessage("Failed to execute.\n");
+                MechaAdjShowFailure();
         }
         else if (!pstricmp(argv[1], "REV"))
         {
             MechaCommandAdd(MECHA_CMD_MOV_AUTO_TILT, "000001", id++, 0, 5000, "TILT ADJUST REV");
             if (MechaCommandExecuteList(&MechaAdjTxHandler, &MechaAdjRxHandler) != 0)
-                PlatShowMessage("Failed to execute.\n");
+                MechaAdjShowFailure();
         }
         else if (!pstricmp(argv[1], "FWD"))
         {
             MechaCommandAdd(MECHA_CMD_MOV_AUTO_TILT, "010001", id++, 0, 5000, "TILT ADJUST FWD");
             if (MechaCommandExecuteList(&MechaAdjTxHandler, &MechaAdjRxHandler) != 0)
-                PlatShowMessage("Failed to execute.\n");
+                MechaAdjShowFailure();
         }
         else
             return -EINVAL;
@@ -789,7 +1070,7 @@ static int MechaAdjPause(short int argc, char *argv[])
         case MECHA_ADJ_STATE_CD_512:
         case MECHA_ADJ_STATE_CD_1024:
             if ((result = MechaCommandExecute(MECHA_CMD_CD_PAUSE, 3000, NULL, buffer, sizeof(buffer))) < 0 || (result = strtoul(buffer, NULL, 16)) != 0)
-                PlatShowMessage("Error %d\n", result);
+                MechaAdjShowError(result);
             break;
         case MECHA_ADJ_STATE_DVDSL_1:
         case MECHA_ADJ_STATE_DVDSL_1p6:
@@ -798,7 +1079,7 @@ static int MechaAdjPause(short int argc, char *argv[])
         case MECHA_ADJ_STATE_DVDDL_1p6:
         case MECHA_ADJ_STATE_DVDDL_1p64:
             if ((result = MechaCommandExecute(MECHA_CMD_DVD_PAUSE, 5000, NULL, buffer, sizeof(buffer))) < 0 || (result = strtoul(buffer, NULL, 16)) != 0)
-                PlatShowMessage("Error %d\n", result);
+                MechaAdjShowError(result);
 
             switch (status)
             {
@@ -815,7 +1096,7 @@ static int MechaAdjPause(short int argc, char *argv[])
             }
             break;
         default:
-            PlatShowMessage("Not in PLAY mode.\n");
+            MechaAdjShowStateError("Not in PLAY mode.\n");
             break;
     }
 
@@ -833,35 +1114,35 @@ static int MechaAdjTray(short int argc, char *argv[])
         {
             if (!SledIsAtHome)
             {
-                PlatShowMessage("Sled must be in home position!\n");
+                MechaAdjShowStateError("Sled must be in home position!\n");
                 return 0;
             }
 
             if ((result = MechaCommandExecute(MECHA_CMD_TRAY, 6000, "00", buffer, sizeof(buffer))) < 0 || (result = strtoul(buffer, NULL, 16)) != 0)
-                PlatShowMessage("Error %d\n", result);
+                MechaAdjShowError(result);
         }
         else if (!pstricmp(argv[1], "OPEN"))
         {
             if (!SledIsAtHome)
             {
-                PlatShowMessage("Sled must be in home position!\n");
+                MechaAdjShowStateError("Sled must be in home position!\n");
                 return 0;
             }
 
             if ((result = MechaCommandExecute(MECHA_CMD_TRAY, 6000, "01", buffer, sizeof(buffer))) < 0 || (result = strtoul(buffer, NULL, 16)) != 0)
-                PlatShowMessage("Error %d\n", result);
+                MechaAdjShowError(result);
         }
         else if (!pstricmp(argv[1], "IN-SW"))
         {
             if ((result = MechaCommandExecute(MECHA_CMD_TRAY_SW, 3000, "00", buffer, sizeof(buffer))) < 0)
-                PlatShowMessage("Error %d\n", result);
+                MechaAdjShowError(result);
             else
                 PlatShowMessage("IN-SW: %s\n", buffer);
         }
         else if (!pstricmp(argv[1], "OUT-SW"))
         {
             if ((result = MechaCommandExecute(MECHA_CMD_TRAY_SW, 3000, "01", buffer, sizeof(buffer))) < 0)
-                PlatShowMessage("Error %d\n", result);
+                MechaAdjShowError(result);
             else
                 PlatShowMessage("OUT-SW: %s\n", buffer);
         }
@@ -874,37 +1155,343 @@ static int MechaAdjTray(short int argc, char *argv[])
     return 0;
 }
 
-static int MechaAdjJitter(short int argc, char *argv[])
+#define MECHA_ENDURANCE_MAX_CYCLES 2000
+#define MECHA_ENDURANCE_PERCENTILE 95 // Default percentile, above which movements are listed as slow.
+#define MECHA_ENDURANCE_SHOW_SLOW  20 // Slow movements listed, per movement type.
+#define MECHA_ENDURANCE_MOVES      5
+
+/*  One endurance cycle. After a move with a switch, the switch must read differently from after the opposite move,
+    or the mechanism did not reach its end position. */
+static const struct MechaEnduranceMove
 {
-    int result;
+    const char *name;
+    unsigned short int command, timeout;
+    const char *args;
+    unsigned short int sensor; // Switch to read back, or 0.
+    const char *SensorArgs;
+    unsigned char opposite;
+} EnduranceMoves[MECHA_ENDURANCE_MOVES] = {
+    {"TRAY OPEN", MECHA_CMD_TRAY, 6000, "01", MECHA_CMD_TRAY_SW, "00", 1},
+    {"TRAY CLOSE", MECHA_CMD_TRAY, 6000, "00", MECHA_CMD_TRAY_SW, "00", 0},
+    {"SLED IN", MECHA_CMD_SLED_CTL_POS, 2000, "00", MECHA_CMD_SLED_IN_SW, NULL, 3},
+    {"SLED OUT", MECHA_CMD_SLED_CTL_POS, 3000, "02", MECHA_CMD_SLED_IN_SW, NULL, 2},
+    {"SLED HOME", MECHA_CMD_SLED_POS_HOME, 3000, NULL, 0, NULL, 0}};
+
+static struct MechaEndurance
+{
+    unsigned short int cycles, cycle;
+    unsigned char move;
+    short int sensor[MECHA_ENDURANCE_MOVES]; // Last switch reading, or -1.
+    unsigned short int times[MECHA_ENDURANCE_MOVES][MECHA_ENDURANCE_MAX_CYCLES]; // ms
+    u32 start;
+    FILE *log;
+} Endurance;
+
+static int MechaEnduranceCompare(const void *a, const void *b)
+{
+    return (int)*(const unsigned short int *)a - (int)*(const unsigned short int *)b;
+}
+
+// Called back to back while the endurance test runs, for one movement at a time. Returns nonzero to stop.
+static int MechaEndurancePoll(void)
+{
+    const struct MechaEnduranceMove *move;
     char buffer[8];
+    int result, reading;
+    u32 start, duration;
 
-    if (argc == 2)
+    move  = &EnduranceMoves[Endurance.move];
+    start = PlatGetTicks();
+    if ((result = MechaCommandExecute(move->command, move->timeout, move->args, buffer, sizeof(buffer))) < 0 || (result = strtoul(buffer, NULL, 16)) != 0)
     {
-        if (!pstricmp(argv[1], "1"))
+        PlatShowMessage("\nCycle %u: %s failed, error %d.\n", Endurance.cycle + 1, move->name, result);
+        return -EIO;
+    }
+    duration                                         = PlatGetTicks() - start;
+    Endurance.times[Endurance.move][Endurance.cycle] = duration > 0xFFFF ? 0xFFFF : (unsigned short int)duration;
+
+    reading = -1;
+    if (move->sensor != 0)
+    {
+        if (MechaCommandExecute(move->sensor, 1000, move->SensorArgs, buffer, sizeof(buffer)) < 0 || buffer[0] != '0')
         {
-            if ((result = MechaCommandExecute(MECHA_CMD_JITTER, 1000, "00", buffer, sizeof(buffer))) < 0)
-                PlatShowMessage("Error %d\n", result);
-            else
-                PlatShowMessage("%s\n", &buffer[1]);
+            PlatShowMessage("\nCycle %u: %s, the switch cannot be read.\n", Endurance.cycle + 1, move->name);
+            return -EIO;
         }
-        else if (!pstricmp(argv[1], "16"))
+        reading = (int)strtoul(&buffer[1], NULL, 16);
+        if (reading == Endurance.sensor[move->opposite])
         {
-            if ((result = MechaCommandExecute(MECHA_CMD_JITTER, 1000, "02", buffer, sizeof(buffer))) < 0)
-                PlatShowMessage("Error %d\n", result);
-            else
-                PlatShowMessage("%s\n", &buffer[1]);
+            PlatShowMessage("\nCycle %u: %s did not reach its end position (switch: %02x).\n", Endurance.cycle + 1, move->name, reading);
+            return -EIO;
+        }
+        Endurance.sensor[Endurance.move] = (short int)reading;
+    }
+
+    if (Endurance.log != NULL)
+        fprintf(Endurance.log, "%u,%s,%u,%d\n", Endurance.cycle + 1, move->name, duration, reading);
+
+    if (++Endurance.move >= MECHA_ENDURANCE_MOVES)
+    {
+        Endurance.move = 0;
+        Endurance.cycle++;
+        PlatShowMessage("\rCycle %u/%u, %us", Endurance.cycle, Endurance.cycles, (PlatGetTicks() - Endurance.start) / 1000);
+        if (Endurance.cycle >= Endurance.cycles)
+            return 1;
+    }
+
+    return 0;
+}
+
+static void MechaEnduranceReport(unsigned short int percentile)
+{
+    unsigned short int sorted[MECHA_ENDURANCE_MAX_CYCLES], count, limit, quarter, i, j, shown;
+    const unsigned short int *times;
+    u32 first, last;
+
+    PlatShowMessage("\nMovement    Count    Min Median    P90   P%-2u    Max  Trend (ms)\n", percentile);
+    for (i = 0; i < MECHA_ENDURANCE_MOVES; i++)
+    {
+        times = Endurance.times[i];
+        count = Endurance.cycle + (i < Endurance.move ? 1 : 0);
+        if (count == 0)
+            continue;
+        memcpy(sorted, times, count * sizeof(sorted[0]));
+        qsort(sorted, count, sizeof(sorted[0]), &MechaEnduranceCompare);
+
+        // Trend: mean of the last quarter of the cycles, minus that of the first quarter. Worn parts slow down over a run.
+        quarter = count >= 4 ? count / 4 : 1;
+        for (j = 0, first = 0, last = 0; j < quarter; j++)
+        {
+            first += times[j];
+            last += times[count - quarter + j];
         }
-        else if (!pstricmp(argv[1], "256"))
+
+        limit = sorted[((count - 1) * percentile) / 100];
+        PlatShowMessage("%-10s %6u %6u %6u %6u %6u %6u %+6d\n", EnduranceMoves[i].name, count, sorted[0], sorted[(count - 1) / 2],
+                        sorted[((count - 1) * 90) / 100], limit, sorted[count - 1], (int)(last / quarter) - (int)(first / quarter));
+
+        for (j = 0, shown = 0; j < count; j++)
         {
-            if ((result = MechaCommandExecute(MECHA_CMD_JITTER, 2000, "01", buffer, sizeof(buffer))) < 0)
-                PlatShowMessage("Error %d\n", result);
-            else
-                PlatShowMessage("%s\n", &buffer[1]);
+            if (times[j] > limit && shown++ < MECHA_ENDURANCE_SHOW_SLOW)
+                PlatShowMessage("\tSlow: cycle %u, %ums\n", j + 1, times[j]);
+        }
+        if (shown > MECHA_ENDURANCE_SHOW_SLOW)
+            PlatShowMessage("\t... %u more.\n", shown - MECHA_ENDURANCE_SHOW_SLOW);
+    }
+}
+
+static int MechaAdjEndurance(short int argc, char *argv[])
+{
+    char buffer[8];
+    unsigned short int percentile;
+    int result, i;
+
+    if (argc < 2 || argc > 4)
+        return -EINVAL;
+
+    memset(&Endurance, 0, sizeof(Endurance));
+    Endurance.cycles = (unsigned short int)atoi(argv[1]);
+    percentile       = argc >= 3 ? (unsigned short int)atoi(argv[2]) : MECHA_ENDURANCE_PERCENTILE;
+    if (Endurance.cycles < 1 || Endurance.cycles > MECHA_ENDURANCE_MAX_CYCLES || percentile < 1 || percentile > 99)
+    {
+        PlatShowMessage("Up to %d cycles, with a percentile of 1-99.\n", MECHA_ENDURANCE_MAX_CYCLES);
+        return 0;
+    }
+    for (i = 0; i < MECHA_ENDURANCE_MOVES; i++)
+        Endurance.sensor[i] = -1;
+
+    if (argc == 4)
+    {
+        if ((Endurance.log = fopen(argv[3], "w")) == NULL)
+        {
+            PlatShowMessage("Cannot create %s.\n", argv[3]);
+            return 0;
+        }
+        fputs("cycle,movement,ms,switch\n", Endurance.log);
+    }
+
+    // The tray must not move unless the sled is at home.
+    if ((result = MechaCommandExecute(MECHA_CMD_SLED_POS_HOME, 3000, NULL, buffer, sizeof(buffer))) < 0 || (result = strtoul(buffer, NULL, 16)) != 0)
+    {
+        MechaAdjShowError(result);
+        SledIsAtHome = 0;
+    }
+    else
+    {
+        Endurance.start = PlatGetTicks();
+        result          = PlatShowMessageBPoll(&MechaEndurancePoll, 0, "Cycling the tray (OPEN, CLOSE) and sled (IN, OUT, HOME) %u times. Press ENTER to stop.\n"
+                                                                    "Remove the disc before starting!\n",
+                                               Endurance.cycles);
+        if (result < 0)
+            CommandErrors++;
+        else if (result == 0)
+            PlatShowMessage("\nStopped.");
+        MechaEnduranceReport(percentile);
+        SledIsAtHome = (Endurance.move == 0);
+    }
+
+    if (Endurance.log != NULL)
+    {
+        fclose(Endurance.log);
+        PlatShowMessage("Movement times saved to %s.\n", argv[3]);
+    }
+
+    return 0;
+}
+
+#define MECHA_JITTER_WINDOW 64 // Samples in the rolling window of the jitter stream.
+#define MECHA_JITTER_REDRAW 250 // ms between status line updates.
+#define MECHA_JITTER_ERRORS 5   // Consecutive failed samples that stop the stream.
+
+static struct MechaJitterStream
+{
+    const char *args;
+    unsigned short int timeout, window[MECHA_JITTER_WINDOW];
+    unsigned char count, next, errors;
+    u32 samples, start, redraw;
+    FILE *log;
+} JitterStream;
+
+static int MechaJitterCompare(const void *a, const void *b)
+{
+    return (int)*(const unsigned short int *)a - (int)*(const unsigned short int *)b;
+}
+
+static void MechaJitterShowStatus(u32 now)
+{
+    unsigned short int sorted[MECHA_JITTER_WINDOW];
+    unsigned char i;
+    u32 total;
+
+    memcpy(sorted, JitterStream.window, JitterStream.count * sizeof(sorted[0]));
+    qsort(sorted, JitterStream.count, sizeof(sorted[0]), &MechaJitterCompare);
+    for (i = 0, total = 0; i < JitterStream.count; i++)
+        total += sorted[i];
+
+    // Redrawn in place. The time series goes to the log file.
+    PlatShowMessage("\r%6u samples %5.1f/s | now %5u  mean %7.1f  min %5u  max %5u  p95 %5u ",
+                    JitterStream.samples, JitterStream.samples * 1000.0f / (now - JitterStream.start + 1),
+                    JitterStream.window[(JitterStream.next + MECHA_JITTER_WINDOW - 1) % MECHA_JITTER_WINDOW], (float)total / JitterStream.count,
+                    sorted[0], sorted[JitterStream.count - 1], sorted[(JitterStream.count * 95) / 100]);
+}
+
+// Called back to back while the stream runs. Returns nonzero to stop it.
+static int MechaJitterPoll(void)
+{
+    char buffer[8];
+    u32 now;
+    unsigned short int value;
+
+    if (MechaCommandExecute(MECHA_CMD_JITTER, JitterStream.timeout, JitterStream.args, buffer, sizeof(buffer)) < 0 || buffer[0] != '0')
+    {
+        if (++JitterStream.errors >= MECHA_JITTER_ERRORS)
+        {
+            PlatShowMessage("\nJitter cannot be read, stopping.\n");
+            return -EIO;
+        }
+        return 0;
+    }
+
+    now                 = PlatGetTicks();
+    value               = (unsigned short int)strtoul(&buffer[1], NULL, 16);
+    JitterStream.errors = 0;
+
+    JitterStream.window[JitterStream.next] = value;
+    JitterStream.next                      = (JitterStream.next + 1) % MECHA_JITTER_WINDOW;
+    if (JitterStream.count < MECHA_JITTER_WINDOW)
+        JitterStream.count++;
+    JitterStream.samples++;
+
+    if (JitterStream.log != NULL)
+        fprintf(JitterStream.log, "%u,%u\n", now - JitterStream.start, value);
+
+    if (now - JitterStream.redraw >= MECHA_JITTER_REDRAW)
+    {
+        MechaJitterShowStatus(now);
+        JitterStream.redraw = now;
+    }
+
+    return 0;
+}
+
+static int MechaAdjJitterStream(const char *args, unsigned short int timeout, const char *LogFile)
+{
+    int result;
+
+    memset(&JitterStream, 0, sizeof(JitterStream));
+    JitterStream.args    = args;
+    JitterStream.timeout = timeout;
+    if (LogFile != NULL)
+    {
+        if ((JitterStream.log = fopen(LogFile, "w")) == NULL)
+        {
+            PlatShowMessage("Cannot create %s.\n", LogFile);
+            return 0;
         }
+        fputs("ms,jitter\n", JitterStream.log);
+    }
+
+    JitterStream.start  = PlatGetTicks();
+    JitterStream.redraw = JitterStream.start;
+    result              = PlatShowMessageBPoll(&MechaJitterPoll, 0, "Streaming jitter (window: %u samples). Press ENTER to stop.\n", MECHA_JITTER_WINDOW);
+    if (JitterStream.count > 0)
+    {
+        MechaJitterShowStatus(PlatGetTicks());
+        PlatShowMessage("\n");
+    }
+
+    if (JitterStream.log != NULL)
+    {
+        fclose(JitterStream.log);
+        PlatShowMessage("%u samples saved to %s.\n", JitterStream.samples, LogFile);
+    }
+
+    if (result != 0)
+        MechaAdjShowError(result);
+
+    return 0;
+}
+
+static int MechaAdjJitter(short int argc, char *argv[])
+{
+    int result;
+    char buffer[8];
+    const char *args;
+    unsigned short int timeout;
+
+    if (argc < 2)
+        return -EINVAL;
+
+    if (!pstricmp(argv[1], "1"))
+    {
+        args    = "00";
+        timeout = 1000;
+    }
+    else if (!pstricmp(argv[1], "16"))
+    {
+        args    = "02";
+        timeout = 1000;
+    }
+    else if (!pstricmp(argv[1], "256"))
+    {
+        args    = "01";
+        timeout = 2000;
+    }
+    else
+        return -EINVAL;
+
+    if (argc == 2)
+    {
+        if ((result = MechaCommandExecute(MECHA_CMD_JITTER, timeout, args, buffer, sizeof(buffer))) < 0)
+            MechaAdjShowError(result);
         else
-            return -EINVAL;
+        {
+            DvdJitter = (unsigned short int)strtoul(&buffer[1], NULL, 16);
+            PlatShowMessage("%s\n", &buffer[1]);
+        }
     }
+    else if (!pstricmp(argv[2], "STREAM"))
+        return MechaAdjJitterStream(args, timeout, argc == 4 ? argv[3] : NULL);
     else
         return -EINVAL;
 
@@ -939,10 +1526,10 @@ static int MechaAdjGetError(short int argc, char *argv[])
                                     DvdError.jitter);
                 }
                 else
-                    PlatShowMessage("Failed to execute.\n");
+                    MechaAdjShowFailure();
                 break;
             default:
-                PlatShowMessage("Not in a DVD PLAY mode.\n");
+                MechaAdjShowStateError("Not in a DVD PLAY mode.\n");
         }
     }
     else if (!pstricmp(argv[1], "CD"))
@@ -960,10 +1547,10 @@ static int MechaAdjGetError(short int argc, char *argv[])
                     PlatShowMessage("%04x:::%04x\n", CdError.c1, CdError.c2);
                 }
                 else
-                    PlatShowMessage("Failed to execute.\n");
+                    MechaAdjShowFailure();
                 break;
             default:
-                PlatShowMessage("Not in a CD PLAY mode.\n");
+                MechaAdjShowStateError("Not in a CD PLAY mode.\n");
         }
     }
     else
@@ -972,54 +1559,243 @@ static int MechaAdjGetError(short int argc, char *argv[])
     return 0;
 }
 
-static int MechaAdjSled(short int argc, char *argv[])
+#define MECHA_SCAN_MAX_POINTS  64
+#define MECHA_SCAN_MAX_SAMPLES 16
+#define MECHA_SCAN_SAMPLES     4   // Default samples per point
+#define MECHA_SCAN_SETTLE      300 // ms for tracking to settle after each sled move.
+#define MECHA_SCAN_VALUES      7
+
+static const char *ScanDvdNames[MECHA_SCAN_VALUES] = {"pi_correct", "pi_noncorrect", "pi_max", "po_correct", "po_noncorrect", "po_max", "jitter"};
+static const char *ScanCdNames[MECHA_SCAN_VALUES]  = {"c1", "c2"};
+
+static struct MechaScanPoint
 {
-    int result;
-    char buffer[8], args[8];
+    unsigned char samples, dvd;
+    u32 sum[MECHA_SCAN_VALUES];
+    u16 max[MECHA_SCAN_VALUES];
+} ScanPoint;
 
-    if (argc >= 2)
+static void MechaScanAddSample(const u16 *values, int count)
+{
+    int i;
+
+    for (i = 0; i < count; i++)
     {
-        if (!pstricmp(argv[1], "HOME"))
-        {
-            if ((result = MechaCommandExecute(MECHA_CMD_SLED_POS_HOME, 3000, NULL, buffer, sizeof(buffer))) < 0 || (result = strtoul(buffer, NULL, 16)) != 0)
-                PlatShowMessage("Error %d\n", result);
-            else
-                SledIsAtHome = 1;
-        }
-        else if (!pstricmp(argv[1], "IN"))
-        {
-            if ((result = MechaCommandExecute(MECHA_CMD_SLED_CTL_POS, 2000, "00", buffer, sizeof(buffer))) < 0 || (result = strtoul(buffer, NULL, 16)) != 0)
-                PlatShowMessage("Error %d\n", result);
-            SledIsAtHome = 0;
-        }
-        else if (!pstricmp(argv[1], "OUT"))
-        {
-            if ((result = MechaCommandExecute(MECHA_CMD_SLED_CTL_POS, 3000, "02", buffer, sizeof(buffer))) < 0 || (result = strtoul(buffer, NULL, 16)) != 0)
-                PlatShowMessage("Error %d\n", result);
-            SledIsAtHome = 0;
-        }
-        else if (!pstricmp(argv[1], "MID"))
-        {
-            if ((result = MechaCommandExecute(MECHA_CMD_SLED_CTL_POS, 3000, "01", buffer, sizeof(buffer))) < 0 || (result = strtoul(buffer, NULL, 16)) != 0)
-                PlatShowMessage("Error %d\n", result);
-            SledIsAtHome = 0;
-        }
-        else if (!pstricmp(argv[1], "STEP-M"))
-        {
-            if (argc == 3)
-            {
-                if (!pstricmp(argv[2], "IN"))
-                { // Micro reverse
-                    snprintf(args, 7, "00%04x", StepAmount);
-                    if ((result = MechaCommandExecute(MECHA_CMD_SLED_CTL_MICRO, 2000, args, buffer, sizeof(buffer))) < 0 || (result = strtoul(buffer, NULL, 16)) != 0)
-                        PlatShowMessage("Error %d\n", result);
+        ScanPoint.sum[i] += values[i];
+        if (values[i] > ScanPoint.max[i])
+            ScanPoint.max[i] = values[i];
+    }
+    ScanPoint.samples++;
+}
+
+static int MechaScanRxHandler(MechaTask_t *task, const char *result, short int len)
+{
+    u16 values[MECHA_SCAN_VALUES];
+    int status;
+
+    if ((status = MechaAdjRxHandler(task, result, len)) != 0 || result[0] != '0')
+        return status;
+
+    switch (task->tag)
+    {
+        case MECHA_CMD_TAG_MECHA_DVD_ERROR_RATE:
+            values[0] = DvdError.PICorrect;
+            values[1] = DvdError.PINCorrect;
+            values[2] = DvdError.PIMax;
+            values[3] = DvdError.POCorrect;
+            values[4] = DvdError.PONCorrect;
+            values[5] = DvdError.POMax;
+            values[6] = DvdError.jitter;
+            MechaScanAddSample(values, 7);
+            break;
+        case MECHA_CMD_TAG_MECHA_CD_ERROR_RATE:
+            values[0] = CdError.c1;
+            values[1] = CdError.c2;
+            MechaScanAddSample(values, 2);
+            break;
+    }
+
+    return 0;
+}
+
+/*  Steps the sled outwards across the disc, measuring the error rates at each point. Positions are in biph-steps from the
+    starting point, with STEP setting the distance between points; start from the IN position for a full radius profile.
+    The MECHACON takes one command at a time, so each point's move, settle time and reads are queued together in one list. */
+static int MechaAdjSledScan(int points, int samples, const char *ExportFile)
+{
+    const char **names;
+    char args[8];
+    FILE *export;
+    int point, i, count, worst;
+    float mean, WorstMean;
+    unsigned char id;
+
+    switch (status)
+    {
+        case MECHA_ADJ_STATE_DVDSL_1:
+        case MECHA_ADJ_STATE_DVDSL_1p6:
+        case MECHA_ADJ_STATE_DVDSL_1p64:
+        case MECHA_ADJ_STATE_DVDDL_1:
+        case MECHA_ADJ_STATE_DVDDL_1p6:
+        case MECHA_ADJ_STATE_DVDDL_1p64:
+            names = ScanDvdNames;
+            count = 7;
+            break;
+        case MECHA_ADJ_STATE_CD_1:
+        case MECHA_ADJ_STATE_CD_2:
+        case MECHA_ADJ_STATE_CD_4:
+        case MECHA_ADJ_STATE_CD_512:
+        case MECHA_ADJ_STATE_CD_1024:
+            names = ScanCdNames;
+            count = 2;
+            break;
+        default:
+            MechaAdjShowStateError("Not in a PLAY mode.\n");
+            return 0;
+    }
+
+    if (points < 1 || points > MECHA_SCAN_MAX_POINTS || samples < 1 || samples > MECHA_SCAN_MAX_SAMPLES || StepAmount == 0)
+    {
+        PlatShowMessage("Up to %d points and %d samples per point, with a non-zero STEP.\n", MECHA_SCAN_MAX_POINTS, MECHA_SCAN_MAX_SAMPLES);
+        return 0;
+    }
+
+    export = NULL;
+    if (ExportFile != NULL)
+    {
+        if ((export = fopen(ExportFile, "w")) == NULL)
+        {
+            PlatShowMessage("Cannot create %s.\n", ExportFile);
+            return 0;
+        }
+        fputs("position,samples", export);
+        for (i = 0; i < count; i++)
+            fprintf(export, ",%s,%s_max", names[i], names[i]);
+        fputc('\n', export);
+    }
+
+    PlatShowMessage("Position Samples");
+    for (i = 0; i < count; i++)
+        PlatShowMessage(" %13s", names[i]);
+    PlatShowMessage("\n");
+
+    snprintf(args, sizeof(args), "01%04x", StepAmount);
+    worst     = -1;
+    WorstMean = 0;
+    for (point = 0; point < points; point++)
+    {
+        memset(&ScanPoint, 0, sizeof(ScanPoint));
+        id = 1;
+        if (point > 0)
+        {
+            MechaCommandAdd(MECHA_CMD_SLED_CTL_BIPHS, args, id++, 0, 2000, "SLED SCAN STEP OUT");
+            MechaCommandAdd(MECHA_TASK_UI_CMD_WAIT, NULL, MECHA_TASK_ID_UI, 0, MECHA_SCAN_SETTLE, "SLED SCAN SETTLE");
+            SledIsAtHome = 0;
+        }
+        for (i = 0; i < samples; i++)
+        {
+            if (count == 7)
+                MechaCommandAdd(MECHA_CMD_DSP_ERROR_RATE, "00", id++, MECHA_CMD_TAG_MECHA_DVD_ERROR_RATE, 2000, "DVD GET DSP ERROR RATE");
+            else
+                MechaCommandAdd(MECHA_CMD_CD_ERROR, "00", id++, MECHA_CMD_TAG_MECHA_CD_ERROR_RATE, 2000, "CD GET DSP ERROR RATE");
+        }
+
+        if (MechaCommandExecuteList(&MechaAdjTxHandler, &MechaScanRxHandler) != 0 || ScanPoint.samples == 0)
+        {
+            CommandErrors++;
+            PlatShowMessage("Scan stopped at point %d.\n", point);
+            break;
+        }
+
+        PlatShowMessage("%8u %7u", point * StepAmount, ScanPoint.samples);
+        for (i = 0; i < count; i++)
+            PlatShowMessage(" %6.1f/%6u", (float)ScanPoint.sum[i] / ScanPoint.samples, ScanPoint.max[i]);
+        PlatShowMessage("\n");
+
+        // The first value (PI correctable or C1) is the one that rises first towards a bad region of the disc.
+        mean = (float)ScanPoint.sum[0] / ScanPoint.samples;
+        if (worst < 0 || mean > WorstMean)
+        {
+            worst     = point;
+            WorstMean = mean;
+        }
+
+        if (export != NULL)
+        {
+            fprintf(export, "%u,%u", point * StepAmount, ScanPoint.samples);
+            for (i = 0; i < count; i++)
+                fprintf(export, ",%.2f,%u", (float)ScanPoint.sum[i] / ScanPoint.samples, ScanPoint.max[i]);
+            fputc('\n', export);
+        }
+    }
+
+    if (worst >= 0)
+        PlatShowMessage("Worst position: %u (%s average: %.1f)\n", worst * StepAmount, names[0], WorstMean);
+
+    if (export != NULL)
+    {
+        fclose(export);
+        PlatShowMessage("Profile saved to %s.\n", ExportFile);
+    }
+
+    return 0;
+}
+
+static int MechaAdjSled(short int argc, char *argv[])
+{
+    int result;
+    char buffer[8], args[8];
+
+    if (argc >= 2)
+    {
+        if (!pstricmp(argv[1], "SCAN"))
+        {
+            if (argc >= 3)
+                return MechaAdjSledScan(atoi(argv[2]), argc >= 4 ? atoi(argv[3]) : MECHA_SCAN_SAMPLES, argc == 5 ? argv[4] : NULL);
+            else
+                return -EINVAL;
+        }
+        else if (!pstricmp(argv[1], "HOME"))
+        {
+            if ((result = MechaCommandExecute(MECHA_CMD_SLED_POS_HOME, 3000, NULL, buffer, sizeof(buffer))) < 0 || (result = strtoul(buffer, NULL, 16)) != 0)
+                MechaAdjShowError(result);
+            else
+                SledIsAtHome = 1;
+        }
+        else if (!pstricmp(argv[1], "IN"))
+        {
+            if ((result = MechaCommandExecute(MECHA_CMD_SLED_CTL_POS, 2000, "00", buffer, sizeof(buffer))) < 0 || (result = strtoul(buffer, NULL, 16)) != 0)
+                MechaAdjShowError(result);
+            SledIsAtHome = 0;
+        }
+        else if (!pstricmp(argv[1], "OUT"))
+        {
+            if ((result = MechaCommandExecute(MECHA_CMD_SLED_CTL_POS, 3000, "02", buffer, sizeof(buffer))) < 0 || (result = strtoul(buffer, NULL, 16)) != 0)
+                MechaAdjShowError(result);
+            SledIsAtHome = 0;
+        }
+        else if (!pstricmp(argv[1], "MID"))
+        {
+            if ((result = MechaCommandExecute(MECHA_CMD_SLED_CTL_POS, 3000, "01", buffer, sizeof(buffer))) < 0 || (result = strtoul(buffer, NULL, 16)) != 0)
+                MechaAdjShowError(result);
+            SledIsAtHome = 0;
+        }
+        else if (!pstricmp(argv[1], "STEP-M"))
+        {
+            if (argc == 3)
+            {
+                if (!pstricmp(argv[2], "IN"))
+                { // Micro reverse
+                    snprintf(args, 7, "00%04x", StepAmount);
+                    if ((result = MechaCommandExecute(MECHA_CMD_SLED_CTL_MICRO, 2000, args, buffer, sizeof(buffer))) < 0 || (result = strtoul(buffer, NULL, 16)) != 0)
+                        MechaAdjShowError(result);
                     SledIsAtHome = 0;
                 }
                 else if (!pstricmp(argv[2], "OUT"))
                 { // Micro forward
                     snprintf(args, 7, "01%04x", StepAmount);
                     if ((result = MechaCommandExecute(MECHA_CMD_SLED_CTL_MICRO, 2000, "010064", buffer, sizeof(buffer))) < 0 || (result = strtoul(buffer, NULL, 16)) != 0)
-                        PlatShowMessage("Error %d\n", result);
+                        MechaAdjShowError(result);
                     SledIsAtHome = 0;
                 }
                 else
@@ -1036,14 +1812,14 @@ static int MechaAdjSled(short int argc, char *argv[])
                 { // Biphs reverse
                     snprintf(args, 7, "00%04x", StepAmount);
                     if ((result = MechaCommandExecute(MECHA_CMD_SLED_CTL_BIPHS, 2000, args, buffer, sizeof(buffer))) < 0 || (result = strtoul(buffer, NULL, 16)) != 0)
-                        PlatShowMessage("Error %d\n", result);
+                        MechaAdjShowError(result);
                     SledIsAtHome = 0;
                 }
                 else if (!pstricmp(argv[2], "OUT"))
                 { // Biphs forward
                     snprintf(args, 7, "01%04x", StepAmount);
                     if ((result = MechaCommandExecute(MECHA_CMD_SLED_CTL_BIPHS, 2000, args, buffer, sizeof(buffer))) < 0 || (result = strtoul(buffer, NULL, 16)) != 0)
-                        PlatShowMessage("Error %d\n", result);
+                        MechaAdjShowError(result);
                     SledIsAtHome = 0;
                 }
                 else
@@ -1059,12 +1835,12 @@ static int MechaAdjSled(short int argc, char *argv[])
                 if (!pstricmp(argv[2], "ON"))
                 {
                     if ((result = MechaCommandExecute(MECHA_CMD_TRACKING, 1000, "01", buffer, sizeof(buffer))) < 0 || (result = strtoul(buffer, NULL, 16)) != 0)
-                        PlatShowMessage("Error %d\n", result);
+                        MechaAdjShowError(result);
                 }
                 else if (!pstricmp(argv[2], "OFF"))
                 {
                     if ((result = MechaCommandExecute(MECHA_CMD_TRACKING, 1000, "00", buffer, sizeof(buffer))) < 0 || (result = strtoul(buffer, NULL, 16)) != 0)
-                        PlatShowMessage("Error %d\n", result);
+                        MechaAdjShowError(result);
                 }
                 else
                     return -EINVAL;
@@ -1075,7 +1851,7 @@ static int MechaAdjSled(short int argc, char *argv[])
         else if (!pstricmp(argv[1], "IN-SW"))
         {
             if ((result = MechaCommandExecute(MECHA_CMD_SLED_IN_SW, 1000, NULL, buffer, sizeof(buffer))) < 0)
-                PlatShowMessage("Error %d\n", result);
+                MechaAdjShowError(result);
             else
             {
                 result = (int)strtoul(&buffer[1], NULL, 16);
@@ -1165,7 +1941,7 @@ static int MechaTestDiscControl(short int argc, char *argv[])
         if (!pstricmp(argv[1], "CD"))
         {
             if ((result = MechaCommandExecute(MECHA_CMD_DISC_MODE_CD_12, 1000, NULL, buffer, sizeof(buffer))) < 0 || (result = strtoul(buffer, NULL, 16)) != 0)
-                PlatShowMessage("Error %d\n", result);
+                MechaAdjShowError(result);
             else
             {
                 status     = MECHA_ADJ_STATE_CD;
@@ -1175,7 +1951,7 @@ static int MechaTestDiscControl(short int argc, char *argv[])
         else if (!pstricmp(argv[1], "DVD-SL"))
         {
             if ((result = MechaCommandExecute(MECHA_CMD_DISC_MODE_DVDSL_12, 1000, NULL, buffer, sizeof(buffer))) < 0 || (result = strtoul(buffer, NULL, 16)) != 0)
-                PlatShowMessage("Error %d\n", result);
+                MechaAdjShowError(result);
             else
             {
                 status     = MECHA_ADJ_STATE_DVDSL;
@@ -1185,7 +1961,7 @@ static int MechaTestDiscControl(short int argc, char *argv[])
         else if (!pstricmp(argv[1], "DVD-DL"))
         {
             if ((result = MechaCommandExecute(MECHA_CMD_DISC_MODE_DVDDL_12, 1000, NULL, buffer, sizeof(buffer))) < 0 || (result = strtoul(buffer, NULL, 16)) != 0)
-                PlatShowMessage("Error %d\n", result);
+                MechaAdjShowError(result);
             else
             {
                 status     = MECHA_ADJ_STATE_DVDDL;
@@ -1198,7 +1974,7 @@ static int MechaTestDiscControl(short int argc, char *argv[])
             MechaCommandAdd(MECHA_CMD_DISC_MODE_CD_12, NULL, id++, MECHA_CMD_TAG_MECHA_SET_DISC_TYPE, 1000, "DISC MODE CD 12cm");
             MechaCommandAdd(MECHA_CMD_DISC_DETECT, NULL, id++, MECHA_CMD_TAG_MECHA_DISC_DETECT, 3000, "DISC DETECT");
             if (MechaCommandExecuteList(&MechaAdjTxHandler, &MechaAdjRxHandler) != 0)
-                PlatShowMessage("Failed to execute.\n");
+                MechaAdjShowFailure();
         }
         else
             return -EINVAL;
@@ -1220,13 +1996,13 @@ static int MechaTestLaserControl(short int argc, char *argv[])
         {
             MechaCommandAdd(MECHA_CMD_LASER_DIODE, "01", id++, 0, 3000, "LD ON");
             if (MechaCommandExecuteList(&MechaAdjTxHandler, &MechaAdjRxHandler) != 0)
-                PlatShowMessage("Failed to execute.\n");
+                MechaAdjShowFailure();
         }
         else if (!pstricmp(argv[1], "OFF"))
         {
             MechaCommandAdd(MECHA_CMD_LASER_DIODE, "00", id++, 0, 3000, "LD OFF");
             if (MechaCommandExecuteList(&MechaAdjTxHandler, &MechaAdjRxHandler) != 0)
-                PlatShowMessage("Failed to execute.\n");
+                MechaAdjShowFailure();
         }
         else
             return -EINVAL;
@@ -1243,13 +2019,13 @@ static int MechaTestLaserControl(short int argc, char *argv[])
                     {
                         MechaCommandAdd(MECHA_CMD_FOCUS_UPDOWN, "01", id++, 0, 3000, "FOCUS UP/DOWN START");
                         if (MechaCommandExecuteList(&MechaAdjTxHandler, &MechaAdjRxHandler) != 0)
-                            PlatShowMessage("Failed to execute.\n");
+                            MechaAdjShowFailure();
                     }
                     else if (!pstricmp(argv[3], "STOP"))
                     {
                         MechaCommandAdd(MECHA_CMD_FOCUS_UPDOWN, "00", id++, 0, 3000, "FOCUS UP/DOWN STOP");
                         if (MechaCommandExecuteList(&MechaAdjTxHandler, &MechaAdjRxHandler) != 0)
-                            PlatShowMessage("Failed to execute.\n");
+                            MechaAdjShowFailure();
                     }
                     else
                         return -EINVAL;
@@ -1260,13 +2036,13 @@ static int MechaTestLaserControl(short int argc, char *argv[])
                     {
                         MechaCommandAdd(MECHA_CMD_FOCUS_AUTO_START, NULL, id++, 0, 3000, "AUTO FOCUS START");
                         if (MechaCommandExecuteList(&MechaAdjTxHandler, &MechaAdjRxHandler) != 0)
-                            PlatShowMessage("Failed to execute.\n");
+                            MechaAdjShowFailure();
                     }
                     else if (!pstricmp(argv[3], "STOP"))
                     {
                         MechaCommandAdd(MECHA_CMD_FOCUS_AUTO_STOP, NULL, id++, 0, 3000, "AUTO FOCUS STOP");
                         if (MechaCommandExecuteList(&MechaAdjTxHandler, &MechaAdjRxHandler) != 0)
-                            PlatShowMessage("Failed to execute.\n");
+                            MechaAdjShowFailure();
                     }
                     else
                         return -EINVAL;
@@ -1292,7 +2068,7 @@ static int MechaTestServoControl(short int argc, char *argv[])
 
     if (DiscDetect == 0xFF)
     {
-        PlatShowMessage("Disc type/circuit not set up!\n");
+        MechaAdjShowStateError("Disc type/circuit not set up!\n");
         return 0;
     }
 
@@ -1304,7 +2080,7 @@ static int MechaTestServoControl(short int argc, char *argv[])
             MechaCommandAdd(MECHA_CMD_SLED_POS_HOME, NULL, id++, 0, 3000, "SLED HOME");
             MechaCommandAdd(MECHA_CMD_AUTO_ADJ_ST_12, "00", id++, 0, 40000, "SERVO AUTO ADJ START");
             if (MechaCommandExecuteList(&MechaAdjTxHandler, &MechaAdjRxHandler) != 0)
-                PlatShowMessage("Failed to execute.\n");
+                MechaAdjShowFailure();
         }
         else
             return -EINVAL;
@@ -1321,7 +2097,7 @@ static int MechaTestPlay(short int argc, char *argv[])
 
     if (DiscDetect == 0xFF)
     {
-        PlatShowMessage("Disc type/circuit not set up!\n");
+        MechaAdjShowStateError("Disc type/circuit not set up!\n");
         return 0;
     }
 
@@ -1335,7 +2111,7 @@ static int MechaTestPlay(short int argc, char *argv[])
                 case DISC_TYPE_CD12:
                     MechaCommandAdd(MECHA_CMD_CD_PLAY_1, NULL, id++, 0, 3000, "PLAY CD 12cm");
                     if (MechaCommandExecuteList(&MechaAdjTxHandler, &MechaAdjRxHandler) != 0)
-                        PlatShowMessage("Failed to execute.\n");
+                        MechaAdjShowFailure();
                     else
                         status = MECHA_ADJ_STATE_CD_1;
                     break;
@@ -1343,7 +2119,7 @@ static int MechaTestPlay(short int argc, char *argv[])
                 case DISC_TYPE_DVDD12:
                     MechaCommandAdd(MECHA_CMD_DVD_PLAY_1, NULL, id++, 0, 5000, "PLAY DVD 12cm");
                     if (MechaCommandExecuteList(&MechaAdjTxHandler, &MechaAdjRxHandler) != 0)
-                        PlatShowMessage("Failed to execute.\n");
+                        MechaAdjShowFailure();
                     else
                     {
                         switch (DiscDetect)
@@ -1367,10 +2143,10 @@ static int MechaTestPlay(short int argc, char *argv[])
                     {
                         MechaCommandAdd(MECHA_CMD_CD_TRACK_CTL, "01000A", id++, 0, 5000, "CD FWD 1 TRACK");
                         if (MechaCommandExecuteList(&MechaAdjTxHandler, &MechaAdjRxHandler) != 0)
-                            PlatShowMessage("Failed to execute.\n");
+                            MechaAdjShowFailure();
                     }
                     else
-                        PlatShowMessage("Not in PLAY mode.\n");
+                        MechaAdjShowStateError("Not in PLAY mode.\n");
                     break;
                 case DISC_TYPE_DVDS12:
                 case DISC_TYPE_DVDD12:
@@ -1378,10 +2154,10 @@ static int MechaTestPlay(short int argc, char *argv[])
                     {
                         MechaCommandAdd(MECHA_CMD_DVD_TRACK_CTL, "01000A", id++, 0, 5000, "DVD FWD 1 TRACK");
                         if (MechaCommandExecuteList(&MechaAdjTxHandler, &MechaAdjRxHandler) != 0)
-                            PlatShowMessage("Failed to execute.\n");
+                            MechaAdjShowFailure();
                     }
                     else
-                        PlatShowMessage("Not in PLAY mode.\n");
+                        MechaAdjShowStateError("Not in PLAY mode.\n");
             }
         }
         else if (!pstricmp(argv[1], "REV"))
@@ -1393,10 +2169,10 @@ static int MechaTestPlay(short int argc, char *argv[])
                     {
                         MechaCommandAdd(MECHA_CMD_CD_TRACK_CTL, "00000A", id++, 0, 5000, "CD REV 1 TRACK");
                         if (MechaCommandExecuteList(&MechaAdjTxHandler, &MechaAdjRxHandler) != 0)
-                            PlatShowMessage("Failed to execute.\n");
+                            MechaAdjShowFailure();
                     }
                     else
-                        PlatShowMessage("Not in PLAY mode.\n");
+                        MechaAdjShowStateError("Not in PLAY mode.\n");
                     break;
                 case DISC_TYPE_DVDS12:
                 case DISC_TYPE_DVDD12:
@@ -1404,10 +2180,10 @@ static int MechaTestPlay(short int argc, char *argv[])
                     {
                         MechaCommandAdd(MECHA_CMD_DVD_TRACK_CTL, "00000A", id++, 0, 5000, "DVD REV 1 TRACK");
                         if (MechaCommandExecuteList(&MechaAdjTxHandler, &MechaAdjRxHandler) != 0)
-                            PlatShowMessage("Failed to execute.\n");
+                            MechaAdjShowFailure();
                     }
                     else
-                        PlatShowMessage("Not in PLAY mode.\n");
+                        MechaAdjShowStateError("Not in PLAY mode.\n");
                     break;
             }
         }
@@ -1420,10 +2196,10 @@ static int MechaTestPlay(short int argc, char *argv[])
                     {
                         MechaCommandAdd(MECHA_CMD_CD_TRACK_LONG_CTL, "010001", id++, 0, 10000, "CD FWD LONG TRACK");
                         if (MechaCommandExecuteList(&MechaAdjTxHandler, &MechaAdjRxHandler) != 0)
-                            PlatShowMessage("Failed to execute.\n");
+                            MechaAdjShowFailure();
                     }
                     else
-                        PlatShowMessage("Not in PLAY mode.\n");
+                        MechaAdjShowStateError("Not in PLAY mode.\n");
                     break;
                 case DISC_TYPE_DVDS12:
                 case DISC_TYPE_DVDD12:
@@ -1431,10 +2207,10 @@ static int MechaTestPlay(short int argc, char *argv[])
                     {
                         MechaCommandAdd(MECHA_CMD_DVD_TRACK_LONG_CTL, "010001", id++, 0, 10000, "DVD FWD LONG TRACK");
                         if (MechaCommandExecuteList(&MechaAdjTxHandler, &MechaAdjRxHandler) != 0)
-                            PlatShowMessage("Failed to execute.\n");
+                            MechaAdjShowFailure();
                     }
                     else
-                        PlatShowMessage("Not in PLAY mode.\n");
+                        MechaAdjShowStateError("Not in PLAY mode.\n");
                     break;
             }
         }
@@ -1447,10 +2223,10 @@ static int MechaTestPlay(short int argc, char *argv[])
                     {
                         MechaCommandAdd(MECHA_CMD_CD_TRACK_LONG_CTL, "000001", id++, 0, 10000, "CD REV LONG TRACK");
                         if (MechaCommandExecuteList(&MechaAdjTxHandler, &MechaAdjRxHandler) != 0)
-                            PlatShowMessage("Failed to execute.\n");
+                            MechaAdjShowFailure();
                     }
                     else
-                        PlatShowMessage("Not in PLAY mode.\n");
+                        MechaAdjShowStateError("Not in PLAY mode.\n");
                     break;
                 case DISC_TYPE_DVDS12:
                 case DISC_TYPE_DVDD12:
@@ -1458,10 +2234,10 @@ static int MechaTestPlay(short int argc, char *argv[])
                     {
                         MechaCommandAdd(MECHA_CMD_DVD_TRACK_LONG_CTL, "000001", id++, 0, 10000, "DVD REV LONG TRACK");
                         if (MechaCommandExecuteList(&MechaAdjTxHandler, &MechaAdjRxHandler) != 0)
-                            PlatShowMessage("Failed to execute.\n");
+                            MechaAdjShowFailure();
                     }
                     else
-                        PlatShowMessage("Not in PLAY mode.\n");
+                        MechaAdjShowStateError("Not in PLAY mode.\n");
                     break;
             }
         }
@@ -1474,12 +2250,12 @@ static int MechaTestPlay(short int argc, char *argv[])
                     {
                         MechaCommandAdd(MECHA_CMD_CD_STOP, NULL, id++, 0, 20000, "CD STOP");
                         if (MechaCommandExecuteList(&MechaAdjTxHandler, &MechaAdjRxHandler) != 0)
-                            PlatShowMessage("Failed to execute.\n");
+                            MechaAdjShowFailure();
 
                         status = MECHA_ADJ_STATE_CD;
                     }
                     else
-                        PlatShowMessage("Not in PLAY mode.\n");
+                        MechaAdjShowStateError("Not in PLAY mode.\n");
                     break;
                 case DISC_TYPE_DVDS12:
                 case DISC_TYPE_DVDD12:
@@ -1487,7 +2263,7 @@ static int MechaTestPlay(short int argc, char *argv[])
                     {
                         MechaCommandAdd(MECHA_CMD_DVD_STOP, NULL, id++, 0, 20000, "DVD STOP");
                         if (MechaCommandExecuteList(&MechaAdjTxHandler, &MechaAdjRxHandler) != 0)
-                            PlatShowMessage("Failed to execute.\n");
+                            MechaAdjShowFailure();
 
                         switch (status)
                         {
@@ -1500,7 +2276,7 @@ static int MechaTestPlay(short int argc, char *argv[])
                         }
                     }
                     else
-                        PlatShowMessage("Not in PLAY mode.\n");
+                        MechaAdjShowStateError("Not in PLAY mode.\n");
                     break;
             }
         }
@@ -1512,13 +2288,13 @@ static int MechaTestPlay(short int argc, char *argv[])
                 {
                     MechaCommandAdd(MECHA_CMD_FOCUS_JUMP, "0205", id++, 0, 2000, "DVD-DL FOCUS JUMP");
                     if (MechaCommandExecuteList(&MechaAdjTxHandler, &MechaAdjRxHandler) != 0)
-                        PlatShowMessage("Failed to execute.\n");
+                        MechaAdjShowFailure();
                 }
                 else
-                    PlatShowMessage("Not in PLAY mode.\n");
+                    MechaAdjShowStateError("Not in PLAY mode.\n");
             }
             else
-                PlatShowMessage("Not a DVD-DL.\n");
+                MechaAdjShowStateError("Not a DVD-DL.\n");
         }
         else
             return -EINVAL;
@@ -1540,31 +2316,31 @@ static int MechaTestSpindle(short int argc, char *argv[])
         {
             MechaCommandAdd(MECHA_CMD_SP_CTL, "01", id++, 0, 3000, "SP KICK");
             if (MechaCommandExecuteList(&MechaAdjTxHandler, &MechaAdjRxHandler) != 0)
-                PlatShowMessage("Failed to execute.\n");
+                MechaAdjShowFailure();
         }
         else if (!pstricmp(argv[1], "BRAKE"))
         {
             MechaCommandAdd(MECHA_CMD_SP_CTL, "00", id++, 0, 3000, "SP BRAKE");
             if (MechaCommandExecuteList(&MechaAdjTxHandler, &MechaAdjRxHandler) != 0)
-                PlatShowMessage("Failed to execute.\n");
+                MechaAdjShowFailure();
         }
         else if (!pstricmp(argv[1], "STOP"))
         {
             MechaCommandAdd(MECHA_CMD_SP_CTL, "02", id++, 0, 3000, "SP STOP");
             if (MechaCommandExecuteList(&MechaAdjTxHandler, &MechaAdjRxHandler) != 0)
-                PlatShowMessage("Failed to execute.\n");
+                MechaAdjShowFailure();
         }
         else if (!pstricmp(argv[1], "CLV-S"))
         {
             MechaCommandAdd(MECHA_CMD_SP_CLV_S, NULL, id++, 0, 3000, "SP CLV-S");
             if (MechaCommandExecuteList(&MechaAdjTxHandler, &MechaAdjRxHandler) != 0)
-                PlatShowMessage("Failed to execute.\n");
+                MechaAdjShowFailure();
         }
         else if (!pstricmp(argv[1], "CLV-A"))
         {
             MechaCommandAdd(MECHA_CMD_SP_CLV_A, NULL, id++, 0, 3000, "SP CLV-A");
             if (MechaCommandExecuteList(&MechaAdjTxHandler, &MechaAdjRxHandler) != 0)
-                PlatShowMessage("Failed to execute.\n");
+                MechaAdjShowFailure();
         }
         else
             return -EINVAL;
@@ -1575,21 +2351,416 @@ static int MechaTestSpindle(short int argc, char *argv[])
     return 0;
 }
 
-static void MechaCommonMain(const struct MechaDiagCommand *commands, char prompt)
+static int MechaSplitArgs(char *input, char *argv[])
+{
+    char *pTok;
+    int argc;
+
+    argv[0] = NULL;
+    for (argc = 0, pTok = strtok(input, " "); pTok != NULL && argc < MECHA_ADJ_MAX_ARGS; argc++)
+    {
+        argv[argc] = pTok;
+        pTok       = strtok(NULL, " ");
+    }
+
+    return argc;
+}
+
+// Returns the result of the command, or -ENOENT if there is no such command.
+static int MechaExecuteLine(const struct MechaDiagCommand *commands, char *input)
 {
-    int result;
-    u8 tm, md;
     const struct MechaDiagCommand *pCmd;
-    unsigned char done, argc;
-    char input[128], previous[128], *argv[MECHA_ADJ_MAX_ARGS], *pTok;
+    char *argv[MECHA_ADJ_MAX_ARGS];
+    int argc, result;
 
-    MechaGetMode(&tm, &md);
+    argc = MechaSplitArgs(input, argv);
+    for (pCmd = commands; pCmd->command != NULL; pCmd++)
+    {
+        if (!pstricmp(pCmd->command, argv[0]))
+            break;
+    }
+
+    if (pCmd->command != NULL)
+    {
+        if ((result = pCmd->function(argc, argv)) == -EINVAL)
+            PlatShowMessage(MECHA_ADJ_SYNTAX_ERR);
+    }
+    else
+    {
+        PlatShowMessage("Unrecognized command. For help, type HELP.\n");
+        result = -ENOENT;
+    }
+
+    return result;
+}
+
+#define MECHA_SCRIPT_MAX_LINES 256
+#define MECHA_SCRIPT_LINE_MAX  128
+#define MECHA_SCRIPT_MAX_DEPTH 8 // Nested REPEAT loops
+#define MECHA_SCRIPT_MAX_VARS  16
+#define MECHA_SCRIPT_NAME_MAX  16
+
+struct MechaScriptLoop
+{
+    unsigned short int start; // First line of the loop body
+    unsigned int count, iteration;
+};
+
+struct MechaScriptVar
+{
+    char name[MECHA_SCRIPT_NAME_MAX];
+    float value;
+};
+
+static const struct MechaScriptMeasurement
+{
+    const char *name;
+    const unsigned short int *value;
+} ScriptMeasurements[] = {
+    {"JITTER", &DvdJitter},
+    {"PI-CORRECT", &DvdError.PICorrect},
+    {"PI-NCORRECT", &DvdError.PINCorrect},
+    {"PI-MAX", &DvdError.PIMax},
+    {"PO-CORRECT", &DvdError.POCorrect},
+    {"PO-NCORRECT", &DvdError.PONCorrect},
+    {"PO-MAX", &DvdError.POMax},
+    {"DSP-JITTER", &DvdError.jitter},
+    {"C1", &CdError.c1},
+    {"C2", &CdError.c2},
+    {"ERRORS", &CommandErrors},
+    {NULL, NULL}};
+
+static struct MechaScript
+{
+    const char *file;
+    unsigned short int count, line;
+    unsigned char depth, VarCount;
+    struct MechaScriptLoop loops[MECHA_SCRIPT_MAX_DEPTH];
+    struct MechaScriptVar vars[MECHA_SCRIPT_MAX_VARS];
+    char lines[MECHA_SCRIPT_MAX_LINES][MECHA_SCRIPT_LINE_MAX];
+} script;
+
+static const struct MechaDiagCommand *ScriptCommands;
+
+static struct MechaScriptVar *MechaScriptFindVar(const char *name)
+{
+    int i;
+
+    for (i = 0; i < script.VarCount; i++)
+    {
+        if (!pstricmp(script.vars[i].name, name))
+            return &script.vars[i];
+    }
+
+    return NULL;
+}
+
+static int MechaScriptGetValue(const char *name, float *value)
+{
+    const struct MechaScriptMeasurement *measurement;
+    const struct MechaScriptVar *var;
+    char *end;
+
+    *value = (float)strtod(name, &end);
+    if (end != name && *end == '\0')
+        return 0;
+
+    if (!pstricmp(name, "LOOP"))
+    {
+        if (script.depth == 0)
+            return -EINVAL;
+        *value = (float)(script.loops[script.depth - 1].iteration + 1);
+        return 0;
+    }
+
+    for (measurement = ScriptMeasurements; measurement->name != NULL; measurement++)
+    {
+        if (!pstricmp(measurement->name, name))
+        {
+            *value = *measurement->value;
+            return 0;
+        }
+    }
+
+    if ((var = MechaScriptFindVar(name)) != NULL)
+    {
+        *value = var->value;
+        return 0;
+    }
+
+    PlatShowMessage("Unknown value: %s\n", name);
+    return -EINVAL;
+}
+
+static int MechaScriptSet(const char *name, const char *source)
+{
+    struct MechaScriptVar *var;
+    float value;
+
+    if (MechaScriptGetValue(source, &value) != 0 || strlen(name) >= MECHA_SCRIPT_NAME_MAX || !pstricmp(name, "LOOP"))
+        return -EINVAL;
+
+    if ((var = MechaScriptFindVar(name)) == NULL)
+    {
+        if (script.VarCount >= MECHA_SCRIPT_MAX_VARS)
+        {
+            PlatShowMessage("Too many variables (max: %d).\n", MECHA_SCRIPT_MAX_VARS);
+            return -EINVAL;
+        }
+        var = &script.vars[script.VarCount++];
+        strcpy(var->name, name);
+    }
+    var->value = value;
+
+    return 0;
+}
+
+static int MechaScriptAssert(const char *left, const char *op, const char *right)
+{
+    float a, b;
+    int ok;
+
+    if (MechaScriptGetValue(left, &a) != 0 || MechaScriptGetValue(right, &b) != 0)
+        return -EINVAL;
+
+    if (!strcmp(op, "<"))
+        ok = a < b;
+    else if (!strcmp(op, "<="))
+        ok = a <= b;
+    else if (!strcmp(op, ">"))
+        ok = a > b;
+    else if (!strcmp(op, ">="))
+        ok = a >= b;
+    else if (!strcmp(op, "=="))
+        ok = a == b;
+    else if (!strcmp(op, "!="))
+        ok = a != b;
+    else
+        return -EINVAL;
+
+    if (!ok)
+    {
+        PlatShowMessage("ASSERT failed: %s (%g) %s %s (%g)\n", left, a, op, right, b);
+        return -EIO;
+    }
+
+    return 0;
+}
+
+static int MechaScriptEcho(int argc, char *argv[])
+{
+    float value;
+    int i;
+
+    for (i = 1; i < argc; i++)
+    {
+        if (argv[i][0] == '$' && MechaScriptGetValue(&argv[i][1], &value) == 0)
+            PlatShowMessage("%g%s", value, i + 1 < argc ? " " : "\n");
+        else
+            PlatShowMessage("%s%s", argv[i], i + 1 < argc ? " " : "\n");
+    }
+    if (argc < 2)
+        PlatShowMessage("\n");
+
+    return 0;
+}
+
+/*  Executes a script directive or console command. Returns 0 on success, 1 if the console was quit,
+    -EINVAL for an invalid line or -EIO if a command or assertion failed. */
+static int MechaScriptLine(char *input)
+{
+    char line[MECHA_SCRIPT_LINE_MAX], *argv[MECHA_ADJ_MAX_ARGS];
+    struct MechaScriptLoop *loop;
+    unsigned short int errors;
+    int argc, result;
+
+    strcpy(line, input);
+    argc = MechaSplitArgs(line, argv);
+
+    if (!pstricmp(argv[0], "REPEAT"))
+    {
+        if (argc != 2 || atoi(argv[1]) < 1)
+            return -EINVAL;
+        if (script.depth >= MECHA_SCRIPT_MAX_DEPTH)
+        {
+            PlatShowMessage("Too many nested loops (max: %d).\n", MECHA_SCRIPT_MAX_DEPTH);
+            return -EINVAL;
+        }
+        loop            = &script.loops[script.depth++];
+        loop->start     = script.line;
+        loop->count     = atoi(argv[1]);
+        loop->iteration = 0;
+        return 0;
+    }
+    else if (!pstricmp(argv[0], "END"))
+    {
+        if (argc != 1 || script.depth == 0)
+            return -EINVAL;
+        loop = &script.loops[script.depth - 1];
+        if (++loop->iteration < loop->count)
+            script.line = loop->start;
+        else
+            script.depth--;
+        return 0;
+    }
+    else if (!pstricmp(argv[0], "WAIT"))
+    {
+        if (argc != 2 || atoi(argv[1]) < 0 || atoi(argv[1]) > 0xFFFF)
+            return -EINVAL;
+        PlatSleep((unsigned short int)atoi(argv[1]));
+        return 0;
+    }
+    else if (!pstricmp(argv[0], "SET"))
+        return argc == 3 ? MechaScriptSet(argv[1], argv[2]) : -EINVAL;
+    else if (!pstricmp(argv[0], "ASSERT"))
+        return argc == 4 ? MechaScriptAssert(argv[1], argv[2], argv[3]) : -EINVAL;
+    else if (!pstricmp(argv[0], "ECHO"))
+        return MechaScriptEcho(argc, argv);
+    else if (!pstricmp(argv[0], "RUN"))
+    {
+        PlatShowMessage("Scripts cannot run other scripts.\n");
+        return -EINVAL;
+    }
+
+    // Commands report failures but still return 0, so check whether they counted an error.
+    strcpy(line, input); // The line may be run again by a loop.
+    errors = CommandErrors;
+    if ((result = MechaExecuteLine(ScriptCommands, line)) < 0)
+        return -EINVAL;
+
+    return CommandErrors != errors ? -EIO : result;
+}
+
+static int MechaScriptLoad(const char *file)
+{
+    char *p;
+    FILE *input;
+    int result;
+
+    if ((input = fopen(file, "r")) == NULL)
+    {
+        PlatShowMessage("Cannot open %s.\n", file);
+        return -ENOENT;
+    }
+
+    result       = 0;
+    script.count = 0;
+    while (fgets(script.lines[script.count], MECHA_SCRIPT_LINE_MAX, input) != NULL)
+    {
+        if (script.count >= MECHA_SCRIPT_MAX_LINES - 1)
+        {
+            PlatShowMessage("%s: too many lines (max: %d).\n", file, MECHA_SCRIPT_MAX_LINES);
+            result = -EINVAL;
+            break;
+        }
+        // Otherwise fgets() would return the rest as a line of its own.
+        if (strchr(script.lines[script.count], '\n') == NULL && fgetc(input) != EOF)
+        {
+            PlatShowMessage("%s:%d: line too long (max: %d characters).\n", file, script.count + 1, MECHA_SCRIPT_LINE_MAX - 3);
+            result = -EINVAL;
+            break;
+        }
+
+        for (p = script.lines[script.count]; *p != '\0' && *p != '\r' && *p != '\n'; p++)
+        {
+            if (*p == '\t')
+                *p = ' ';
+        }
+        *p = '\0';
+        script.count++;
+    }
+    fclose(input);
+
+    return result;
+}
+
+/*  Runs a script with the given command set. The script stops at the first invalid line, failed command or failed assertion.
+    Returns 0 if the script passed, otherwise a negative error code. */
+static int MechaScriptRun(const struct MechaDiagCommand *commands, const char *file)
+{
+    char *input;
+    unsigned short int number;
+    int result;
+    u32 start;
+
+    if ((result = MechaScriptLoad(file)) != 0)
+        return result;
+
+    ScriptCommands  = commands;
+    script.file     = file;
+    script.line     = 0;
+    script.depth    = 0;
+    script.VarCount = 0;
+    CommandErrors   = 0;
+    number          = 0;
+    start           = PlatGetTicks();
+    while (script.line < script.count)
+    {
+        number = script.line + 1;
+        for (input = script.lines[script.line++]; *input == ' '; input++)
+            ;
+        if (*input == '\0' || *input == '#')
+            continue;
+
+        PlatShowMessage("%s:%u> %s\n", file, number, input);
+        if ((result = MechaScriptLine(input)) != 0)
+            break;
+    }
+
+    if (result == 0 && script.depth != 0)
+    {
+        PlatShowMessage("REPEAT without END.\n");
+        result = -EINVAL;
+    }
+    script.file = NULL;
+
+    if (result < 0)
+    {
+        PlatShowMessage("Script %s %s at line %u.\n", file, result == -EINVAL ? "stopped with a syntax error" : "FAILED", number);
+        return result;
+    }
+
+    PlatShowMessage("Script %s passed in %us.\n", file, (PlatGetTicks() - start) / 1000);
+
+    return 0;
+}
+
+static int MechaAdjRun(short int argc, char *argv[])
+{
+    if (argc != 2)
+        return -EINVAL;
+
+    if (script.file != NULL)
+    {
+        PlatShowMessage("Scripts cannot run other scripts.\n");
+        return 0;
+    }
+
+    MechaScriptRun(ScriptCommands, argv[1]);
+
+    return 0;
+}
+
+static void MechaCommonInit(void)
+{
     status       = MECHA_ADJ_STATE_NONE;
     StepAmount   = 100;
     SledIsAtHome = 0;
     DiscDetect   = 0xFF;
-    done         = 0;
-    previous[0]  = '\0';
+}
+
+static void MechaCommonMain(const struct MechaDiagCommand *commands, char prompt)
+{
+    int result;
+    u8 tm, md;
+    unsigned char done;
+    char input[128], previous[128];
+
+    MechaGetMode(&tm, &md);
+    MechaCommonInit();
+    ScriptCommands = commands;
+    done           = 0;
+    previous[0]    = '\0';
     do
     {
         PlatShowMessage("MD1.%d %c> ", md, prompt);
@@ -1601,33 +2772,8 @@ static void MechaCommonMain(const struct MechaDiagCommand *commands, char prompt
             else
                 strcpy(input, previous);
 
-            argv[0] = NULL;
-            for (argc = 0, pTok = strtok(input, " "); pTok != NULL && argc < MECHA_ADJ_MAX_ARGS; argc++)
-            {
-                argv[argc] = pTok;
-                pTok       = strtok(NULL, " ");
-            }
-
-            for (pCmd = commands; pCmd->command != NULL; pCmd++)
-            {
-                if (!pstricmp(pCmd->command, argv[0]))
-                    break;
-            }
-
-            if (pCmd->command != NULL)
-            {
-                if ((result = pCmd->function(argc, argv)) < 0)
-                {
-                    if (result == -EINVAL)
-                        PlatShowMessage(MECHA_ADJ_SYNTAX_ERR);
-                }
-                else
-                {
-                    done = result;
-                }
-            }
-            else
-                PlatShowMessage("Unrecognized command. For help, type HELP.\n");
+            if ((result = MechaExecuteLine(commands, input)) >= 0)
+                done = result;
         }
     } while (!done);
 }
@@ -1663,11 +2809,8 @@ void MenuMECHA(void)
     unsigned char done;
     char choice;
 
-    if (MechaInitModel() != 0)
-    {
-        DisplayConnHelp();
+    if (ProbeConsole(MECHA_PROBE_FULL) != 0)
         return;
-    }
     if (IsOutdatedBCModel())
     {
         PlatShowMessage("B/C-chassis: EEPROM update required.\n");
@@ -1726,3 +2869,29 @@ void MenuMECHA(void)
         } while (!done);
     }
 }
+
+// Runs a script unattended, for "PMAP -mecha". Returns 0 if the script passed.
+int MechaRunScript(int test, const char *file)
+{
+    if (MechaInitModel() != 0)
+    {
+        DisplayConnHelp();
+        return ENODEV;
+    }
+    if (IsOutdatedBCModel())
+    {
+        PlatShowMessage("B/C-chassis: EEPROM update required.\n");
+        return EINVAL;
+    }
+    if (IsChassisDexA())
+    {
+        // The DTL-T10000 question cannot be answered here.
+        PlatShowMessage("DEX chassis A consoles must be tested from the MECHA adjustment menu.\n");
+        return EINVAL;
+    }
+
+    ConIsT10K = 0;
+    MechaCommonInit();
+
+    return -MechaScriptRun(test ? TestCommands : AdjCommands, file);
+}
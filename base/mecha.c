@@ -9,11 +9,24 @@
 #include "platform.h"
 #include "mecha.h"
 #include "eeprom.h"
+#include "metrics.h"
 
 static struct MechaTask tasks[MAX_MECHA_TASKS];
 static unsigned char TaskCount = 0;
+static struct MechaLatency
+{
+    u32 count, total; // Successful round trips and their total duration, in ms.
+} latency[0x1000];
 char MechaName[9], RTCData[19];
 static struct MechaIdentRaw MechaIdentRaw;
+static unsigned char MechaProbeLevel = MECHA_PROBE_NONE; // How much of the ident data and EEPROM map is up to date.
+static unsigned char MechaLostLevel  = MECHA_PROBE_NONE; // The level when the link was lost, if nothing was written since.
+static unsigned char MechaLogTaskId  = MECHA_TASK_ID_UI; // Task of the command being executed, for the debug log.
+static struct MechaSwitchWatch
+{
+    char last[8];
+    unsigned char changes, target, failed;
+} MechaSwitch;
 unsigned char ConMD, ConType, ConTM, ConCEXDEX, ConOP, ConLens, ConRTC, ConRTCStat, ConECR, ConChecksumStat, ConSlim;
 
 int is_valid_data(const char *data, int size)
@@ -59,20 +72,46 @@ int MechaCommandAdd(unsigned short int command, const char *args, unsigned char
     return result;
 }
 
+/*  Commands that only read state from the MECHACON. Anything else may change
+    the EEPROM or the ident data, so the cached copy has to be read again. */
+int MechaIsReadOnlyCommand(unsigned short int command)
+{
+    switch (command)
+    {
+        case MECHA_CMD_READ_MODEL:
+        case MECHA_CMD_READ_MODEL_2:
+        case MECHA_CMD_READ_CHECKSUM:
+        case MECHA_CMD_RTC_READ:
+        case MECHA_CMD_EEPROM_READ:
+        case MECHA_CMD_TRAY_SW:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
 int MechaCommandExecute(unsigned short int command, unsigned short int timeout, const char *args, char *buffer, unsigned char BufferSize)
 {
     char cmd[MECHA_TX_BUFFER_SIZE];
     unsigned short int size;
-    int result = 0;
+    int result = 0, sent;
+    u32 start;
 
     if (args != NULL)
         snprintf(cmd, sizeof(cmd), "%03x%s\r\n", command, args);
     else
         snprintf(cmd, sizeof(cmd), "%03x\r\n", command);
 
-    PlatDPrintf("PlatWriteCOMPort: %s", cmd);
+    PlatDLogFrame(PLAT_LOG_TX, MechaLogTaskId, command, cmd, strlen(cmd));
 
-    if (PlatWriteCOMPort(cmd) == strlen(cmd))
+    if (!MechaIsReadOnlyCommand(command))
+    {
+        MechaProbeLevel = MECHA_PROBE_NONE;
+        MechaLostLevel  = MECHA_PROBE_NONE;
+    }
+
+    start = PlatGetTicks();
+    if ((sent = PlatWriteCOMPort(cmd)) == (int)strlen(cmd))
     {
         for (size = 0; size < BufferSize - 1; size++)
         {
@@ -98,15 +137,69 @@ int MechaCommandExecute(unsigned short int command, unsigned short int timeout,
 
         buffer[size] = '\0';
         if (result == 0)
+        {
             result = size;
-        PlatDPrintf("PlatReadCOMPort : %s\n", buffer);
+            latency[command & 0xFFF].count++;
+            latency[command & 0xFFF].total += PlatGetTicks() - start;
+        }
+        PlatDLogFrame(PLAT_LOG_RX, MechaLogTaskId, command, buffer, size);
     }
     else
         result = -EPIPE;
+    MetricsCommand(sent, buffer, result, PlatGetTicks() - start);
+
+    if (result < 0)
+    {
+        if (MechaProbeLevel > MechaLostLevel)
+            MechaLostLevel = MechaProbeLevel;
+        MechaProbeLevel = MECHA_PROBE_NONE;
+    }
 
     return result;
 }
 
+/*  Polled while an operator prompt is shown: the prompt completes once the tray switch has changed as often as expected,
+    e.g. once for a tray that was pushed in, or twice for a lid that was opened and closed again.
+    Only changes are counted, as what the switch reads for open or closed is not known. */
+static int MechaPollTraySwitch(void)
+{
+    char buffer[8];
+
+    if (MechaSwitch.failed)
+        return 0;
+
+    if (MechaCommandExecute(MECHA_CMD_TRAY_SW, 1000, "00", buffer, sizeof(buffer)) < 0 || buffer[0] != '0')
+    {
+        PlatDPrintf("TRAY SW: cannot be read, waiting for ENTER only.\n");
+        MechaSwitch.failed = 1;
+        return 0;
+    }
+
+    if (MechaSwitch.last[0] != '\0' && strcmp(MechaSwitch.last, buffer))
+        MechaSwitch.changes++;
+    strcpy(MechaSwitch.last, buffer);
+
+    return (MechaSwitch.changes >= MechaSwitch.target);
+}
+
+static void MechaShowPrompt(const MechaTask_t *task)
+{
+    MechaSwitch.last[0] = '\0';
+    MechaSwitch.changes = 0;
+    MechaSwitch.failed  = 0;
+    MechaSwitch.target  = (unsigned char)atoi(task->args);
+    if (MechaSwitch.target > 0)
+        MechaPollTraySwitch(); // First reading, to compare against
+    if (MechaSwitch.target == 0 || MechaSwitch.failed)
+    {
+        PlatShowMessageB(task->label);
+        return;
+    }
+
+    if (PlatShowMessageBPoll(&MechaPollTraySwitch, MECHA_SWITCH_POLL_INTERVAL, task->label) != 0)
+        PlatShowMessage("Tray switch changed, continuing.\n");
+}
+
 int MechaCommandExecuteList(MechaCommandTxHandler_t transmit, MechaCommandRxHandler_t receive)
 {
     char RxBuffer[MECHA_RX_BUFFER_SIZE];
@@ -143,12 +236,21 @@ int MechaCommandExecuteList(MechaCommandTxHandler_t transmit, MechaCommandRxHand
                         PlatShowMessageB(task->label);
                         result = 0;
                         break;
+                    case MECHA_TASK_UI_CMD_MSG_SW:
+                        MechaShowPrompt(task);
+                        result = 0;
+                        break;
                     default:
                         result = 0;
                 }
                 break;
             default:
-                result = MechaCommandExecute(task->command, task->timeout, task->args, RxBuffer, sizeof(RxBuffer));
+                // Let the operator know what comes next while the mechanism is still moving, e.g. while the tray opens.
+                if (i + 1 < TaskCount && task[1].id == MECHA_TASK_ID_UI && (task[1].command == MECHA_TASK_UI_CMD_MSG || task[1].command == MECHA_TASK_UI_CMD_MSG_SW))
+                    PlatShowMessage("Next: %s\n", task[1].label);
+                MechaLogTaskId = task->id;
+                result         = MechaCommandExecute(task->command, task->timeout, task->args, RxBuffer, sizeof(RxBuffer));
+                MechaLogTaskId = MECHA_TASK_ID_UI;
         }
 
         if (result >= 0)
@@ -189,6 +291,109 @@ void MechaCommandListClear(void)
     TaskCount = 0;
 }
 
+/*  Rough durations of commands that move the mechanism, for when no round trip was measured yet.
+    Measured averages (from MechaCommandExecute) take precedence. */
+static const struct MechaNominalDuration
+{
+    unsigned short int command, msec;
+} MechaNominalDurations[] = {
+    {MECHA_CMD_TRAY, 2000},
+    {MECHA_CMD_SLED_POS_HOME, 1000},
+    {MECHA_CMD_DISC_DETECT, 3000},
+    {MECHA_CMD_DETECT_ADJ, 5000},
+    {MECHA_CMD_AUTO_ADJ_ST_1, 8000},
+    {MECHA_CMD_AUTO_ADJ_ST_2, 8000},
+    {0, 0}};
+
+static unsigned int MechaEstimateTask(const MechaTask_t *task)
+{
+    const struct MechaNominalDuration *nominal;
+
+    if (task->id == MECHA_TASK_ID_UI)
+        return (task->command == MECHA_TASK_UI_CMD_WAIT) ? task->timeout : 0;
+
+    if (latency[task->command & 0xFFF].count > 0)
+        return latency[task->command & 0xFFF].total / latency[task->command & 0xFFF].count;
+
+    for (nominal = MechaNominalDurations; nominal->msec != 0; nominal++)
+    {
+        if (nominal->command == task->command)
+            return nominal->msec;
+    }
+
+    return MECHA_SIM_DEFAULT_RTT;
+}
+
+static void MechaFormatDuration(char *buffer, int size, u32 msec)
+{
+    if (msec >= 60000)
+        snprintf(buffer, size, "%um%02us", msec / 60000, (msec / 1000) % 60);
+    else
+        snprintf(buffer, size, "%u.%02us", msec / 1000, (msec % 1000) / 10);
+}
+
+int MechaCommandSimulateList(MechaCommandTxHandler_t transmit)
+{
+    static struct MechaTask scratch[MAX_MECHA_TASKS]; // The Tx handler may modify tasks, so it must not see the real list.
+    struct MechaTask *task;
+    unsigned short int i, prompts;
+    char duration[16];
+    u32 msec, total;
+    int result = 0;
+
+    memcpy(scratch, tasks, TaskCount * sizeof(struct MechaTask));
+    PlatShowMessage("Simulated command list (nothing will be sent):\n");
+    for (i = 0, task = scratch, total = 0, prompts = 0; i < TaskCount; i++, task++)
+    {
+        if (transmit != NULL)
+        {
+            if ((result = transmit(task)) != 0)
+                break;
+        }
+
+        msec = MechaEstimateTask(task);
+        total += msec;
+        MechaFormatDuration(duration, sizeof(duration), msec);
+        if (task->id == MECHA_TASK_ID_UI)
+        {
+            switch (task->command)
+            {
+                case MECHA_TASK_UI_CMD_SKIP:
+                    PlatShowMessage("%3u. --  (skipped)          %s\n", i + 1, task->label);
+                    break;
+                case MECHA_TASK_UI_CMD_WAIT:
+                    PlatShowMessage("%3u. --  (wait)             %-40s %8s\n", i + 1, task->label, duration);
+                    break;
+                case MECHA_TASK_UI_CMD_MSG:
+                case MECHA_TASK_UI_CMD_MSG_SW:
+                    PlatShowMessage("%3u. --  (operator)         %s\n", i + 1, task->label);
+                    prompts++;
+                    break;
+            }
+        }
+        else
+            PlatShowMessage("%3u. %02u  %03x%-15s %-40s %8s\n", i + 1, task->id, task->command, task->args, task->label, duration);
+    }
+
+    MechaFormatDuration(duration, sizeof(duration), total);
+    PlatShowMessage("%u tasks, estimated time: %s", TaskCount, duration);
+    if (prompts > 0)
+        PlatShowMessage(" (excluding %u operator prompt%s)", prompts, prompts > 1 ? "s" : "");
+    PlatShowMessage("\n");
+
+    return result;
+}
+
+int MechaCommandEstimateList(u32 *msec)
+{
+    unsigned short int i;
+
+    for (i = 0, *msec = 0; i < TaskCount; i++)
+        *msec += MechaEstimateTask(&tasks[i]);
+
+    return TaskCount;
+}
+
 int MechaDefaultHandleRes1(MechaTask_t *task, const char *result, short int len)
 {
     PlatShowEMessage("%d. %04x%s %s - Rx-command error: %s\n", task->id, task->command, task->args, task->label, result);
@@ -198,7 +403,7 @@ int MechaDefaultHandleRes1(MechaTask_t *task, const char *result, short int len)
 int MechaDefaultHandleRes2(MechaTask_t *task, const char *result, short int len)
 {
     if (!pstricmp(result, "2A0"))
-        PlatShowEMessage("%02d. %04x%s %s: 2A0 - Rx-command error, %s\n", task->id, task->command, task->args, task->label);
+        PlatShowEMessage("%02d. %04x%s %s: 2A0 - Rx-command error\n", task->id, task->command, task->args, task->label);
     else if (!pstricmp(result, "2A1"))
         PlatShowEMessage("%02d. %04x%s %s: 2A1 - Rx-command argument count error\n", task->id, task->command, task->args, task->label);
     else if (!pstricmp(result, "2A2"))
@@ -415,8 +620,8 @@ static int MechaCmdInitRxModelHandler(const char *data, int len)
     //  MechaIdentRaw.cfd = (u32)strtoul(&data[1], NULL, 16);
     //  MechaIdentRaw.cfd = (u32)strtoul(&data[len-7], NULL, 16);
 
-    strncpy(MechaIdentRaw.cfd, data + 1, len - 1);
-    MechaIdentRaw.cfd[len] = '\0';
+    // The reply is not trusted to fit: a longer one is cut.
+    snprintf(MechaIdentRaw.cfd, sizeof(MechaIdentRaw.cfd), "%.*s", len > 1 ? len - 1 : 0, data + 1);
     if (len < 10)
     {
         char temp[5];
@@ -454,9 +659,9 @@ static int MechaCmdInitRxModel2Handler(const char *data, int len)
                 06 - China
                 07 - Mexico
             i.e. 00080304 -> PS2, v3.8, Asia    */
-        strcpy(MechaName, &data[1]);
+        snprintf(MechaName, sizeof(MechaName), "%.*s", len > 1 ? len - 1 : 0, &data[1]); // A longer reply is cut.
         MechaIdentRaw.cfc = (u32)strtoul(&data[1], NULL, 16);
-        if (data[6] == '6')
+        if (len > 6 && data[6] == '6')
             ConSlim = 1;
         else
             ConSlim = 0;
@@ -506,7 +711,8 @@ static int MechaCmdInitRxRtcReadHandler(const char *data, int len)
     }
 }
 
-static int MechaCmdInitRxEepReadHandler(const char *data, int len)
+// args is the address that was read: the reply must be for it, or the word that was asked for would be missing from the map.
+static int MechaCmdInitRxEepReadHandler(const char *args, const char *data, int len)
 {
     char address[5];
     u16 offset, word;
@@ -518,6 +724,11 @@ static int MechaCmdInitRxEepReadHandler(const char *data, int len)
         offset     = (u16)strtoul(address, NULL, 16);
         word       = (u16)strtoul(&data[5], NULL, 16);
 
+        if (offset != (u16)strtoul(args, NULL, 16))
+        {
+            PlatShowEMessage("Error: EEPROM Read response is for %04x, not %s.\n", offset, args);
+            return 1;
+        }
         EEPMapWrite(offset, word);
         return 0;
     }
@@ -544,7 +755,7 @@ static int InitRxHandler(MechaTask_t *task, const char *result, short int len)
                 case MECHA_CMD_TAG_INIT_RTC_READ:
                     return MechaCmdInitRxRtcReadHandler(result, len);
                 case MECHA_CMD_TAG_INIT_EEP_READ:
-                    return MechaCmdInitRxEepReadHandler(result, len);
+                    return MechaCmdInitRxEepReadHandler(task->args, result, len);
                 default:
                     return 0;
             }
@@ -581,56 +792,202 @@ static int InitRxHandler(MechaTask_t *task, const char *result, short int len)
     }
 }
 
-int MechaInitModel(void)
+static const struct MechaProbeStep
+{
+    unsigned short int command;
+    const char *args;
+    unsigned char level, tag;
+    const char *label;
+} MechaProbeSteps[] = {
+    {MECHA_CMD_READ_MODEL, NULL, MECHA_PROBE_LINK, MECHA_CMD_TAG_INIT_MODEL, "READ MECHACON MD"},
+    {MECHA_CMD_READ_MODEL_2, NULL, MECHA_PROBE_IDENT, MECHA_CMD_TAG_INIT_MODEL_2, "READ MECHACON MODEL"},
+    {MECHA_CMD_EEPROM_READ, "0010", MECHA_PROBE_IDENT, MECHA_CMD_TAG_INIT_EEP_READ, "READ EEPROM"}, // Version ID
+    {MECHA_CMD_READ_CHECKSUM, "00", MECHA_PROBE_STATUS, MECHA_CMD_TAG_INIT_CHECKSUM_CHK, "EEPROM CHECKSUM CHK"},
+    {MECHA_CMD_RTC_READ, NULL, MECHA_PROBE_STATUS, MECHA_CMD_TAG_INIT_RTC_READ, "READ RTC"},
+    {0, NULL, 0, 0, NULL}};
+
+// Time allowed for reaching each level from scratch, in ms. Also caps the per-command timeout.
+static const unsigned short int MechaProbeBudget[MECHA_PROBE_COUNT] = {0, 1000, 2000, 3000, MECHA_TASK_LONG_TO};
+
+int MechaProbe(int level)
+{
+    if (level <= MechaProbeLevel)
+        return 0;
+    if (level >= MECHA_PROBE_COUNT)
+        return -EINVAL;
+
+    return MechaProbeQuick(level, MechaProbeBudget[level] < MECHA_TASK_NORMAL_TO ? MechaProbeBudget[level] : MECHA_TASK_NORMAL_TO);
+}
+
+// Fetches the pieces between the current level and level, without clearing what was read before.
+static int MechaProbeRun(int level, unsigned short int timeout)
 {
     char address[5];
     int result, i, id;
+    u32 start, elapsed;
     static const u16 EEPMapToInit[] = {// EEPROM words to read.
-                                       0x0001, 0x0006, 0x0008, 0x000e, 0x0010, 0x0012, 0x0013, 0x0021,
-                                       0x0022, 0x0023, 0x0024, 0x0025, 0x0026, 0x0027, 0x0029, 0x002a,
-                                       0x002b, 0x002c, 0x002d, 0x002e, 0x0031, 0x0032, 0x0033, 0x0038,
-                                       0x003a, 0x003d, 0x003e, 0x0040, 0x0044, 0x004b, 0x00c0, 0x00c1,
-                                       0x00c2, 0x00c3, 0x00c4, 0x00e4, 0x00f1, 0x00f2, 0x00f3, 0x00f4,
-                                       0x00f5, 0x00f6, 0x00f7, 0x00f8, 0x00f9, 0x00fa, 0x00fb, 0x0140,
-                                       0x0141, 0x0142, 0x0143, 0x0144, 0x0145, 0x0146, 0x0147, 0x0148,
-                                       0x0149, 0x014a, 0x014b, 0x014c, 0x014d, 0x014e, 0x014f, 0x0160,
-                                       0x0161, 0x0162, 0x0163, 0x0164, 0x0165, 0x0166, 0x0167, 0x0188,
-                                       0x0189, 0x018a, 0x018b, 0x018c, 0x018d, 0x018e, 0x018f, 0xffff};
-
-    id                              = 1;
-    EEPMapClear();
-    if ((result = MechaCommandAdd(MECHA_CMD_READ_MODEL, NULL, id++, MECHA_CMD_TAG_INIT_MODEL, MECHA_TASK_NORMAL_TO, "READ MECHACON MD")) == 0 &&
-        (result = MechaCommandAdd(MECHA_CMD_READ_CHECKSUM, "00", id++, MECHA_CMD_TAG_INIT_CHECKSUM_CHK, MECHA_TASK_NORMAL_TO, "EEPROM CHECKSUM CHK")) == 0 &&
-        (result = MechaCommandAdd(MECHA_CMD_RTC_READ, NULL, id++, MECHA_CMD_TAG_INIT_RTC_READ, MECHA_TASK_NORMAL_TO, "READ RTC")) == 0 &&
-        (result = MechaCommandAdd(MECHA_CMD_READ_MODEL_2, NULL, id++, MECHA_CMD_TAG_INIT_MODEL_2, MECHA_TASK_NORMAL_TO, "READ MECHACON MODEL")) == 0)
+                                       0x0001, 0x0006, 0x0008, 0x000e, 0x0010, 0x0012, 0x0013, 0x0019,
+                                       0x0021, 0x0022, 0x0023, 0x0024, 0x0025, 0x0026, 0x0027, 0x0029,
+                                       0x002a, 0x002b, 0x002c, 0x002d, 0x002e, 0x0031, 0x0032, 0x0033,
+                                       0x0038, 0x003a, 0x003c, 0x003d, 0x003e, 0x0040, 0x0044, 0x004b,
+                                       0x006f, 0x007e, 0x00c0, 0x00c1, 0x00c2, 0x00c3, 0x00c4, 0x00d0,
+                                       0x00d1, 0x00d2, 0x00d3, 0x00d4, 0x00d5, 0x00d6, 0x00d7, 0x00d8,
+                                       0x00d9, 0x00da, 0x00db, 0x00dc, 0x00dd, 0x00de, 0x00df, 0x00e0,
+                                       0x00e1, 0x00e2, 0x00e3, 0x00e4, 0x00e5, 0x00e6, 0x00e7, 0x00f0,
+                                       0x00f1, 0x00f2, 0x00f3, 0x00f4, 0x00f5, 0x00f6, 0x00f7, 0x00f8,
+                                       0x00f9, 0x00fa, 0x00fb, 0x0140, 0x0141, 0x0142, 0x0143, 0x0144,
+                                       0x0145, 0x0146, 0x0147, 0x0148, 0x0149, 0x014a, 0x014b, 0x014c,
+                                       0x014d, 0x014e, 0x014f, 0x0160, 0x0161, 0x0162, 0x0163, 0x0164,
+                                       0x0165, 0x0166, 0x0167, 0x0188, 0x0189, 0x018a, 0x018b, 0x018c,
+                                       0x018d, 0x018e, 0x018f, 0xffff};
+
+    result = 0;
+    id     = 1;
+    for (i = 0; MechaProbeSteps[i].label != NULL && result == 0; i++)
     {
-        for (i = 0; EEPMapToInit[i] != 0xFFFF; i++, id++)
-        {
-            snprintf(address, 5, "%04x", EEPMapToInit[i]);
-            if ((result = MechaCommandAdd(MECHA_CMD_EEPROM_READ, address, id, MECHA_CMD_TAG_INIT_EEP_READ, MECHA_TASK_NORMAL_TO, "READ EEPROM")) != 0)
-                break;
-        }
+        if (MechaProbeSteps[i].level > MechaProbeLevel && MechaProbeSteps[i].level <= level)
+            result = MechaCommandAdd(MechaProbeSteps[i].command, MechaProbeSteps[i].args, id++, MechaProbeSteps[i].tag, timeout, MechaProbeSteps[i].label);
+    }
 
-        if (result == 0)
+    if (level == MECHA_PROBE_FULL)
+    {
+        for (i = 0; EEPMapToInit[i] != 0xFFFF && result == 0; i++)
         {
-            if ((result = MechaCommandExecuteList(NULL, &InitRxHandler)) == 0)
+            if (!EEPMapIsValid(EEPMapToInit[i]))
             {
-                MechaIdentRaw.VersionID = EEPMapRead(EEPROM_MAP_CON);
-                MechaGetNameOfMD();
-                MechaParseCEXDEX();
-                MechaParseOP();
-                MechaParseLens(EEPMapRead(EEPROM_MAP_CON), EEPMapRead(EEPROM_MAP_OPT_12), EEPMapRead(EEPROM_MAP_OPT_13));
+                snprintf(address, 5, "%04x", EEPMapToInit[i]);
+                result = MechaCommandAdd(MECHA_CMD_EEPROM_READ, address, id++, MECHA_CMD_TAG_INIT_EEP_READ, timeout, "READ EEPROM");
             }
         }
-        else
-            MechaCommandListClear();
     }
-    else
+
+    if (result != 0)
+    {
         MechaCommandListClear();
+        return result;
+    }
+
+    start = PlatGetTicks();
+    if ((result = MechaCommandExecuteList(NULL, &InitRxHandler)) == 0)
+    {
+        if (level >= MECHA_PROBE_IDENT)
+            MechaIdentRaw.VersionID = EEPMapRead(EEPROM_MAP_CON);
+        if (level == MECHA_PROBE_FULL)
+        {
+            MechaGetNameOfMD();
+            MechaParseCEXDEX();
+            MechaParseOP();
+            MechaParseLens(EEPMapRead(EEPROM_MAP_CON), EEPMapRead(EEPROM_MAP_OPT_12), EEPMapRead(EEPROM_MAP_OPT_13));
+        }
+        MechaProbeLevel = level;
+
+        if ((elapsed = PlatGetTicks() - start) > MechaProbeBudget[level])
+            PlatDPrintf("MechaProbe: level %d took %ums, over its %ums budget.\n", level, elapsed, MechaProbeBudget[level]);
+    }
 
     return result;
 }
 
+/*  The ident data is the same for every console of a model, so the serial number and EMCS ID words are compared too.
+    Returns 0 if the EEPROM has the words of the map, 1 if not, or a negative errno value if the MECHACON did not reply. */
+static int MechaRevalidateSerial(unsigned short int timeout)
+{
+    char args[5], buffer[16];
+    u16 words[2];
+    int result, i;
+
+    words[0] = ConMD == 40 ? EEPROM_MAP_SERIAL_NEW_0 : EEPROM_MAP_SERIAL_0;
+    words[1] = ConMD == 40 ? EEPROM_MAP_SERIAL_NEW_1 : EEPROM_MAP_SERIAL_1;
+    for (i = 0; i < 2; i++)
+    {
+        if (!EEPMapIsValid(words[i]))
+            return 1;
+
+        snprintf(args, sizeof(args), "%04x", words[i]);
+        if ((result = MechaCommandExecute(MECHA_CMD_EEPROM_READ, timeout, args, buffer, sizeof(buffer))) < 0)
+            return result;
+        if (result != 9 || (u16)strtoul(buffer + 5, NULL, 16) != EEPMapRead(words[i]))
+            return 1;
+    }
+
+    return 0;
+}
+
+/*  After the link was lost, e.g. to a console reset or a cable that was pulled, only the ident data, the serial number and
+    the EEPROM checksum are read again. If they are those of the console that was probed before and the checksum is OK,
+    the EEPROM map that was read before (nothing was written since) is still valid. If the console does not reply, this is
+    tried again next time. */
+static int MechaRevalidate(unsigned short int timeout)
+{
+    struct MechaIdentRaw previous;
+    unsigned char lost;
+    int result, other;
+
+    previous = MechaIdentRaw;
+    lost     = MechaLostLevel;
+    if ((result = MechaProbeRun(MECHA_PROBE_STATUS, timeout)) != 0)
+    {
+        MechaLostLevel = lost;
+        return result;
+    }
+
+    other = strcmp(previous.cfd, MechaIdentRaw.cfd) || previous.cfc != MechaIdentRaw.cfc || previous.VersionID != MechaIdentRaw.VersionID || !ConChecksumStat;
+    if (!other && (other = MechaRevalidateSerial(timeout)) < 0)
+    { // Not known yet whether the map can be kept, so this is tried again next time.
+        MechaProbeLevel = MECHA_PROBE_NONE;
+        MechaLostLevel  = lost;
+        return other;
+    }
+
+    MechaLostLevel = MECHA_PROBE_NONE;
+    if (other)
+    {
+        PlatShowMessage("This is another console, or its EEPROM has changed: reading it again.\n");
+        MechaProbeLevel = MECHA_PROBE_NONE;
+        return 0;
+    }
+
+    PlatDPrintf("MechaRevalidate: same console, EEPROM checksum OK.\n");
+    MechaProbeLevel = lost;
+
+    return 0;
+}
+
+int MechaProbeQuick(int level, unsigned short int timeout)
+{
+    int result;
+
+    /*  Whatever was already read stays valid until something is written, so only the
+        pieces between the current level and the requested one are fetched. */
+    if (level <= MechaProbeLevel)
+        return 0;
+    if (level >= MECHA_PROBE_COUNT)
+        return -EINVAL;
+
+    if (MechaProbeLevel == MECHA_PROBE_NONE)
+    {
+        if (MechaLostLevel > MECHA_PROBE_STATUS && (result = MechaRevalidate(timeout)) != 0) // Only worth it if the EEPROM map was read.
+            return result;
+        if (MechaProbeLevel == MECHA_PROBE_NONE)
+            EEPMapClear();
+        if (level <= MechaProbeLevel)
+            return 0;
+    }
+
+    return MechaProbeRun(level, timeout);
+}
+
+int MechaInitModel(void)
+{
+    return MechaProbe(MECHA_PROBE_FULL);
+}
+
+void MechaInvalidateModel(void)
+{
+    MechaProbeLevel = MECHA_PROBE_NONE;
+    MechaLostLevel  = MECHA_PROBE_NONE;
+}
+
 void MechaGetMode(u8 *tm, u8 *md)
 {
     *tm = ConTM;
@@ -23,12 +23,15 @@ typedef struct MechaTask
 
 #define MECHA_TASK_NORMAL_TO   6000
 #define MECHA_TASK_LONG_TO     10000
+#define MECHA_SIM_DEFAULT_RTT  50 // Assumed round trip for commands without a measurement, in ms.
+#define MECHA_SWITCH_POLL_INTERVAL 250 // How often the tray switch is read during an operator prompt, in ms.
 
 // Software commands
 #define MECHA_TASK_ID_UI       0x00
 #define MECHA_TASK_UI_CMD_SKIP 0x0000
 #define MECHA_TASK_UI_CMD_WAIT 0x0001
 #define MECHA_TASK_UI_CMD_MSG  0x0002
+#define MECHA_TASK_UI_CMD_MSG_SW 0x0003 // Like MSG, but also completes once the tray (IN-SW) switch has changed <args> times.
 
 enum MECHA_CMD_TAG_INIT
 {
@@ -39,31 +42,15 @@ enum MECHA_CMD_TAG_INIT
     MECHA_CMD_TAG_INIT_EEP_READ,
 };
 
-enum MECHA_CMD_TAG_INIT_ID
+enum MECHA_PROBE_LEVEL
 {
-    MECHA_CMD_TAG_INIT_ID_ILINK_ID_0 = 1,
-    MECHA_CMD_TAG_INIT_ID_ILINK_ID_1,
-    MECHA_CMD_TAG_INIT_ID_ILINK_ID_2,
-    MECHA_CMD_TAG_INIT_ID_ILINK_ID_3,
-    MECHA_CMD_TAG_INIT_ID_CON_ID_0,
-    MECHA_CMD_TAG_INIT_ID_CON_ID_1,
-    MECHA_CMD_TAG_INIT_ID_CON_ID_2,
-    MECHA_CMD_TAG_INIT_ID_CON_ID_3,
-};
+    MECHA_PROBE_NONE = 0,
+    MECHA_PROBE_LINK,   // A MECHACON is answering (cfd).
+    MECHA_PROBE_IDENT,  // MD/TestMode, MECHACON version and version ID.
+    MECHA_PROBE_STATUS, // Ident, EEPROM checksum and RTC status.
+    MECHA_PROBE_FULL,   // Everything, including the EEPROM map and the chassis.
 
-enum MECHA_CMD_TAG_EEPROM
-{
-    MECHA_CMD_TAG_EEPROM_SERIAL_0 = 1,
-    MECHA_CMD_TAG_EEPROM_SERIAL_1,
-    MECHA_CMD_TAG_EEPROM_MODEL_NAME_0,
-    MECHA_CMD_TAG_EEPROM_MODEL_NAME_1,
-    MECHA_CMD_TAG_EEPROM_MODEL_NAME_2,
-    MECHA_CMD_TAG_EEPROM_MODEL_NAME_3,
-    MECHA_CMD_TAG_EEPROM_MODEL_NAME_4,
-    MECHA_CMD_TAG_EEPROM_MODEL_NAME_5,
-    MECHA_CMD_TAG_EEPROM_MODEL_NAME_6,
-    MECHA_CMD_TAG_EEPROM_MODEL_NAME_7,
-    MECHA_CMD_TAG_EEPROM_MODEL_NAME_8,
+    MECHA_PROBE_COUNT
 };
 
 enum MECHA_CMD_TAG_ELECT
@@ -125,17 +112,24 @@ typedef int (*MechaCommandHandler_t)(const char *data, int len);
 typedef int (*MechaCommandTxHandler_t)(MechaTask_t *task);
 typedef int (*MechaCommandRxHandler_t)(MechaTask_t *task, const char *result, short int len);
 
+int is_valid_data(const char *data, int size); // Every character is printable.
 int MechaCommandAdd(unsigned short int command, const char *args, unsigned char id, unsigned char tag, unsigned short int timeout, const char *label);
 int MechaCommandExecute(unsigned short int command, unsigned short int timeout, const char *args, char *buffer, unsigned char BufferSize);
+int MechaIsReadOnlyCommand(unsigned short int command); // Only reads state, so it leaves the EEPROM and ident data as they are.
 int MechaCommandExecuteList(MechaCommandTxHandler_t transmit, MechaCommandRxHandler_t receive);
 void MechaCommandListClear(void);
+int MechaCommandSimulateList(MechaCommandTxHandler_t transmit);
+int MechaCommandEstimateList(u32 *msec); // Returns the number of tasks; operator prompts are not included in the time.
 
 int MechaDefaultHandleRes1(MechaTask_t *task, const char *result, short int len);
 int MechaDefaultHandleRes2(MechaTask_t *task, const char *result, short int len);
 int MechaDefaultHandleResUnknown(MechaTask_t *task, const char *result, short int len);
 
 const struct MechaIdentRaw *MechaGetRawIdent(void);
+int MechaProbe(int level);
+int MechaProbeQuick(int level, unsigned short int timeout); // Each command may take up to timeout ms, for devices that may have no console.
 int MechaInitModel(void);
+void MechaInvalidateModel(void);
 void MechaGetMode(u8 *tm, u8 *md);
 int MechaGetCEXDEX(void);
 int MechaGetRTCType(void);
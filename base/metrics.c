@@ -0,0 +1,309 @@
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "platform.h"
+#include "metrics.h"
+
+#define METRICS_MAX_JUDGES 64
+#define METRICS_FILE_MAX   256
+
+enum METRICS_REPLY
+{
+    METRICS_REPLY_1XX = 0, // Rx-NGErr
+    METRICS_REPLY_2A0,
+    METRICS_REPLY_2A1,
+    METRICS_REPLY_2A2,
+    METRICS_REPLY_2XX, // Any other Rx-NGBadCmd
+
+    METRICS_REPLY_COUNT
+};
+
+static const char *MetricsReplyNames[METRICS_REPLY_COUNT] = {
+    "1xx",
+    "2A0",
+    "2A1",
+    "2A2",
+    "2xx"};
+
+static const u32 MetricsRttBuckets[] = {5, 10, 25, 50, 100, 250, 500, 1000, 2500, 5000}; // ms
+
+#define METRICS_RTT_BUCKETS (sizeof(MetricsRttBuckets) / sizeof(MetricsRttBuckets[0]))
+
+struct MetricsJudgeData
+{
+    const char *name;
+    u32 pass, fail;
+};
+
+static char MetricsFile[METRICS_FILE_MAX];
+static unsigned short int MetricsInterval = METRICS_DEFAULT_INTERVAL;
+
+static struct Metrics
+{
+    unsigned char active, failed;
+    char file[METRICS_FILE_MAX], temp[METRICS_FILE_MAX + 4], port[64];
+    const char *operation, *stage;
+    u32 written; // When the file was last written, in ms.
+
+    u32 commands, timeouts, TxBytes, RxBytes;
+    u32 replies[METRICS_REPLY_COUNT];
+    u32 rtt[METRICS_RTT_BUCKETS + 1], RttSum, RttCount; // Only replies are timed; the last bucket is +Inf.
+
+    unsigned char JudgeCount;
+    struct MetricsJudgeData judges[METRICS_MAX_JUDGES];
+} metrics;
+
+void MetricsConfigure(const char *file, unsigned short int interval)
+{
+    strncpy(MetricsFile, file, sizeof(MetricsFile) - 1);
+    MetricsInterval = interval > 0 ? interval : 1;
+}
+
+// Label values may contain anything but quotes, backslashes and newlines, which must be escaped.
+static void MetricsPrintLabel(FILE *file, const char *value)
+{
+    for (; *value != '\0'; value++)
+    {
+        if (*value == '"' || *value == '\\')
+            fputc('\\', file);
+        if (*value == '\n')
+            fputs("\\n", file);
+        else
+            fputc(*value, file);
+    }
+}
+
+static void MetricsPrintCounter(FILE *file, const char *port, const char *name, const char *help, u32 value)
+{
+    fprintf(file, "# HELP %s %s\n"
+                  "# TYPE %s counter\n"
+                  "%s{port=\"",
+            name, help, name, name);
+    MetricsPrintLabel(file, port);
+    fprintf(file, "\"} %u\n", value);
+}
+
+// Writes a snapshot of the metrics. Runs in the background (see MetricsUpdate()), so it only uses its own copy.
+static int MetricsWrite(const void *data)
+{
+    const struct Metrics *snapshot = data;
+    unsigned short int i;
+    FILE *file;
+    u32 count;
+
+    if ((file = fopen(snapshot->temp, "w")) == NULL)
+        return -1;
+
+    MetricsPrintCounter(file, snapshot->port, "pmap_commands_total", "Commands sent to the MECHACON.", snapshot->commands);
+    MetricsPrintCounter(file, snapshot->port, "pmap_timeouts_total", "Commands without a complete reply.", snapshot->timeouts);
+    MetricsPrintCounter(file, snapshot->port, "pmap_tx_bytes_total", "Bytes sent to the MECHACON.", snapshot->TxBytes);
+    MetricsPrintCounter(file, snapshot->port, "pmap_rx_bytes_total", "Bytes received from the MECHACON.", snapshot->RxBytes);
+
+    fputs("# HELP pmap_error_replies_total Error replies from the MECHACON, by code.\n"
+          "# TYPE pmap_error_replies_total counter\n",
+          file);
+    for (i = 0; i < METRICS_REPLY_COUNT; i++)
+    {
+        fputs("pmap_error_replies_total{port=\"", file);
+        MetricsPrintLabel(file, snapshot->port);
+        fprintf(file, "\",code=\"%s\"} %u\n", MetricsReplyNames[i], snapshot->replies[i]);
+    }
+
+    fputs("# HELP pmap_command_rtt_seconds Time from sending a command to receiving its reply.\n"
+          "# TYPE pmap_command_rtt_seconds histogram\n",
+          file);
+    for (i = 0, count = 0; i <= METRICS_RTT_BUCKETS; i++)
+    {
+        count += snapshot->rtt[i];
+        fputs("pmap_command_rtt_seconds_bucket{port=\"", file);
+        MetricsPrintLabel(file, snapshot->port);
+        if (i < METRICS_RTT_BUCKETS)
+            fprintf(file, "\",le=\"%u.%03u\"} %u\n", MetricsRttBuckets[i] / 1000, MetricsRttBuckets[i] % 1000, count);
+        else
+            fprintf(file, "\",le=\"+Inf\"} %u\n", count);
+    }
+    fputs("pmap_command_rtt_seconds_sum{port=\"", file);
+    MetricsPrintLabel(file, snapshot->port);
+    fprintf(file, "\"} %u.%03u\n", snapshot->RttSum / 1000, snapshot->RttSum % 1000);
+    fputs("pmap_command_rtt_seconds_count{port=\"", file);
+    MetricsPrintLabel(file, snapshot->port);
+    fprintf(file, "\"} %u\n", snapshot->RttCount);
+
+    fputs("# HELP pmap_operation The operation in progress.\n"
+          "# TYPE pmap_operation gauge\n"
+          "pmap_operation{port=\"",
+          file);
+    MetricsPrintLabel(file, snapshot->port);
+    fprintf(file, "\",operation=\"%s\",stage=\"", snapshot->operation != NULL ? snapshot->operation : "idle");
+    MetricsPrintLabel(file, snapshot->stage != NULL ? snapshot->stage : "");
+    fputs("\"} 1\n", file);
+
+    fputs("# HELP pmap_elect_judgements_total Verdicts of the ELECT judges.\n"
+          "# TYPE pmap_elect_judgements_total counter\n",
+          file);
+    for (i = 0; i < snapshot->JudgeCount; i++)
+    {
+        fputs("pmap_elect_judgements_total{port=\"", file);
+        MetricsPrintLabel(file, snapshot->port);
+        fputs("\",judge=\"", file);
+        MetricsPrintLabel(file, snapshot->judges[i].name);
+        fprintf(file, "\",result=\"pass\"} %u\n", snapshot->judges[i].pass);
+        fputs("pmap_elect_judgements_total{port=\"", file);
+        MetricsPrintLabel(file, snapshot->port);
+        fputs("\",judge=\"", file);
+        MetricsPrintLabel(file, snapshot->judges[i].name);
+        fprintf(file, "\",result=\"fail\"} %u\n", snapshot->judges[i].fail);
+    }
+
+    fprintf(file, "# HELP pmap_metrics_timestamp_seconds When this file was written.\n"
+                  "# TYPE pmap_metrics_timestamp_seconds gauge\n"
+                  "pmap_metrics_timestamp_seconds %lu\n",
+            (unsigned long)time(NULL));
+
+    if (fclose(file) != 0)
+        return -1;
+
+    /*  rename() replaces the file atomically on POSIX systems, so readers always see a complete file.
+        Where it cannot replace an existing file (Windows), the old one is removed first, so there is a short time
+        without a file, but never a partial one. */
+    if (rename(snapshot->temp, snapshot->file) != 0 && (remove(snapshot->file) != 0 || rename(snapshot->temp, snapshot->file) != 0))
+        return -1;
+
+    return 0;
+}
+
+static void MetricsReportFailure(int result)
+{
+    if (result != 0 && !metrics.failed)
+    {
+        PlatShowEMessage("Cannot write the metrics to %s.\n", metrics.file);
+        metrics.failed = 1;
+    }
+}
+
+/*  Called on the serial path, so the file is not written here: a snapshot is handed to the background writer.
+    A failure is reported with the next snapshot after it. */
+static void MetricsUpdate(int force)
+{
+    u32 now;
+
+    now = PlatGetTicks();
+    if (!force && now - metrics.written < MetricsInterval * 1000u)
+        return;
+    metrics.written = now;
+
+    MetricsReportFailure(PlatBackgroundPost(&MetricsWrite, &metrics, sizeof(metrics)));
+}
+
+int MetricsStart(const char *port, int station)
+{
+    const char *name, *extension;
+    int length;
+
+    if (MetricsFile[0] == '\0')
+        return 0;
+
+    memset(&metrics, 0, sizeof(metrics));
+    strncpy(metrics.port, port, sizeof(metrics.port) - 1);
+    if (station > 0)
+    { // pmap.prom becomes pmap_station1.prom
+        for (name = MetricsFile + strlen(MetricsFile); name > MetricsFile && name[-1] != '/' && name[-1] != '\\'; name--)
+            ;
+        if ((extension = strrchr(name, '.')) == NULL || extension == name)
+            extension = name + strlen(name);
+        length = (int)(extension - MetricsFile);
+        snprintf(metrics.file, sizeof(metrics.file), "%.*s_station%d%s", length, MetricsFile, station, extension);
+    }
+    else
+        strcpy(metrics.file, MetricsFile);
+    snprintf(metrics.temp, sizeof(metrics.temp), "%s.tmp", metrics.file);
+
+    // Written right away, so that a file that cannot be written is reported before anything starts.
+    metrics.active  = 1;
+    metrics.written = PlatGetTicks();
+    MetricsReportFailure(MetricsWrite(&metrics));
+
+    return metrics.failed ? EIO : 0;
+}
+
+void MetricsStop(void)
+{
+    if (metrics.active)
+    {
+        metrics.operation = NULL;
+        metrics.stage     = NULL;
+        MetricsUpdate(1);
+        MetricsReportFailure(PlatBackgroundFlush());
+        metrics.active = 0;
+    }
+}
+
+void MetricsCommand(int sent, const char *reply, int result, u32 rtt)
+{
+    unsigned short int i;
+
+    if (!metrics.active)
+        return;
+
+    metrics.commands++;
+    if (sent > 0)
+        metrics.TxBytes += sent;
+
+    if (result < 0)
+        metrics.timeouts++;
+    else
+    {
+        metrics.RxBytes += result + 2; // Including the CR/LF
+        for (i = 0; i < METRICS_RTT_BUCKETS && rtt > MetricsRttBuckets[i]; i++)
+            ;
+        metrics.rtt[i]++;
+        metrics.RttSum += rtt;
+        metrics.RttCount++;
+
+        if (reply[0] == '1')
+            metrics.replies[METRICS_REPLY_1XX]++;
+        else if (reply[0] == '2')
+        {
+            if ((reply[1] == 'A' || reply[1] == 'a') && reply[2] >= '0' && reply[2] <= '2')
+                metrics.replies[METRICS_REPLY_2A0 + reply[2] - '0']++;
+            else
+                metrics.replies[METRICS_REPLY_2XX]++;
+        }
+    }
+
+    MetricsUpdate(0);
+}
+
+void MetricsOperation(const char *operation, const char *stage)
+{
+    if (!metrics.active)
+        return;
+
+    metrics.operation = operation;
+    metrics.stage     = stage;
+    MetricsUpdate(1);
+}
+
+void MetricsJudge(const char *name, int ok)
+{
+    unsigned short int i;
+
+    if (!metrics.active)
+        return;
+
+    for (i = 0; i < metrics.JudgeCount && strcmp(metrics.judges[i].name, name); i++)
+        ;
+    if (i >= metrics.JudgeCount)
+    {
+        if (metrics.JudgeCount >= METRICS_MAX_JUDGES)
+            return;
+        metrics.judges[metrics.JudgeCount++].name = name;
+    }
+
+    if (ok)
+        metrics.judges[i].pass++;
+    else
+        metrics.judges[i].fail++;
+}
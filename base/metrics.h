@@ -0,0 +1,17 @@
+/*  Metrics for bench dashboards, in the Prometheus text format.
+    Commands, timeouts, error replies, round trip times and bytes transferred are counted for the port in use,
+    together with the current operation and the verdicts of the ELECT judges.
+    The file is replaced (written to a temporary file, then renamed) once the interval has passed since it was last written,
+    and whenever the operation changes. It is written in the background (PlatBackgroundPost()), not on the serial path:
+    the commands only update the counters. */
+
+#define METRICS_DEFAULT_INTERVAL 10 // s
+
+void MetricsConfigure(const char *file, unsigned short int interval);
+int MetricsStart(const char *port, int station); // A station writes to its own file, named after the station.
+void MetricsStop(void);
+
+// result is the length of the reply, or negative if there was none.
+void MetricsCommand(int sent, const char *reply, int result, u32 rtt);
+void MetricsOperation(const char *operation, const char *stage); // operation is NULL when idle.
+void MetricsJudge(const char *name, int ok);
@@ -3,18 +3,92 @@ typedef unsigned short int u16;
 typedef unsigned int u32;
 
 int PlatOpenCOMPort(const char *device);
+/*  Lists the serial devices that may have a console attached: those matching the glob patterns, or if there are none,
+    /dev/ttyUSB*, /dev/ttyACM*, /dev/ttyS* and /dev/cu.*. Serial ports without a UART behind them are left out.
+    Returns how many were found, up to max. */
+#define PLAT_DEVICE_MAX 64
+#define PLAT_MAX_PORTS  64
+int PlatListCOMPorts(int count, char *const patterns[], char devices[][PLAT_DEVICE_MAX], int max);
 int PlatReadCOMPort(char *data, int n, unsigned short timeout);
 int PlatWriteCOMPort(const char *data);
 void PlatCloseCOMPort(void);
+/*  For reconnecting: waits up to msec ms, but returns early if the device of the port is removed or added. If the device is
+    gone, or was replaced (e.g. a USB adapter that was plugged in again), the port is closed, and opened again once the device
+    is back. Anything received in the meantime is discarded. Returns 0 if the port is open. */
+int PlatWatchCOMPort(unsigned short int msec);
+// Line errors counted by the driver of the port so far. Returns ENOTSUP if the driver does not count them.
+struct PlatCOMPortErrors
+{
+    u32 frame, overrun, parity, brk;
+};
+int PlatGetCOMPortErrors(struct PlatCOMPortErrors *errors);
 void PlatSleep(unsigned short int msec);
+u32 PlatGetTicks(void); // Monotonic time in milliseconds
 void PlatShowEMessage(const char *format, ...);
 void PlatShowMessage(const char *format, ...);
 void PlatShowMessageB(const char *format, ...);
+/*  Like PlatShowMessageB(), but poll() is also called every interval ms while waiting, and the wait ends once it returns nonzero.
+    Returns what poll() returned, or 0 if the user pressed ENTER. */
+int PlatShowMessageBPoll(int (*poll)(void), unsigned short int interval, const char *format, ...);
+
+/*  Lets an application that embeds PMAP receive messages and operator prompts, instead of the console.
+    message() receives every message shown (level is a PLAT_LOG_* level). prompt() is called instead of waiting for ENTER,
+    and returns once the operator is done. NULL restores the console. Returns ENOSYS if the platform only has a console. */
+struct PlatHandlers
+{
+    void (*message)(int level, const char *text, void *context);
+    void (*prompt)(const char *text, void *context);
+    void *context;
+};
+int PlatSetHandlers(const struct PlatHandlers *handlers);
+
+/*  Runs run() on each device at the same time, each in a separate station (run() may use all other Plat functions).
+    Operator prompts from PlatShowMessageB() are queued and shown one at a time, with the station they belong to.
+    Returns 0 if every station completed. */
+#define PLAT_MAX_STATIONS       8
+#define PLAT_STATION_PROMPT_MAX 256
+int PlatRunStations(int count, char *const devices[], int (*run)(int station, const char *device));
+
+/*  Runs probe() on each device at the same time, each in a separate process whose messages are discarded (probe() may open
+    the device and use all other Plat functions). probe() fills in size bytes at result, which are copied to
+    results + i * size, and its return value to status[i]. Probes still running after timeout ms are stopped (ETIMEDOUT). */
+int PlatProbeCOMPorts(int count, char *const devices[], int (*probe)(const char *device, void *result), void *results, int size, int status[], unsigned short int timeout);
+
+/*  Runs serve() on each device in a station that stays up, and passes it jobs from clients of the local socket at path.
+    A client connects and sends "<device> <request>" (device may also be the station number) on one line; the station gets
+    the request from PlatDaemonNextJob(), and talks to the client until it moves on to the next job. The jobs for a device run
+    one after another, the jobs for different devices at the same time. Returns once stopped with SIGINT or SIGTERM. */
+#define PLAT_DAEMON_REQUEST_MAX 256
+int PlatRunDaemon(const char *path, int count, char *const devices[], int (*serve)(int station, const char *device));
+int PlatDaemonNextJob(char *request, int size); // Waits for the next job. Returns non-zero once the daemon stops.
+int PlatDaemonReply(const char *text);
+int PlatDaemonAnswer(char *line, int size); // Reads a line from the client.
+
+/*  Runs work() on a thread of its own, with a copy of size bytes of data, so that the caller does not wait for it (e.g. for
+    files that must not be written on the serial path). There is one slot: work that has not started yet is replaced.
+    Returns what the last completed work() returned (0 if none). Platforms without the thread run work() right away.
+    PlatBackgroundFlush() waits until the posted work is done and returns what it returned. */
+#define PLAT_BACKGROUND_DATA_MAX 4096
+int PlatBackgroundPost(int (*work)(const void *data), const void *data, int size);
+int PlatBackgroundFlush(void);
 
 void PlatDebugInit(void);
 void PlatDebugDeinit(void);
 void PlatDPrintf(const char *format, ...);
 
+enum PLAT_LOG_LEVEL
+{
+    PLAT_LOG_MESSAGE = 0, // PlatShowMessage() and operator prompts
+    PLAT_LOG_ERROR,       // PlatShowEMessage()
+    PLAT_LOG_DEBUG,       // PlatDPrintf()
+    PLAT_LOG_TX,          // Frame sent to the MECHACON
+    PLAT_LOG_RX,          // Frame received from the MECHACON
+};
+
+/*  Logs a frame of the given command (level is PLAT_LOG_TX or PLAT_LOG_RX) to the debug log, with the ID of the task that it belongs to.
+    Like PlatDPrintf(), this may only queue the frame, so it does not wait for the log to be written. */
+void PlatDLogFrame(int level, unsigned char id, unsigned short int command, const char *frame, int length);
+
 // If necessary, provide these functions, otherwise define them to their equivalents
 int pstricmp(const char *s1, const char *s2);
 int pstrincmp(const char *s1, const char *s2, int len);
@@ -0,0 +1,520 @@
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "platform.h"
+#include "mecha.h"
+#include "eeprom.h"
+#include "elect.h"
+#include "elect-record.h"
+#include "updates.h"
+#include "metrics.h"
+#include "pmap.h"
+
+extern unsigned char ElectConIsT10K, ElectProfiling;
+
+#define PMAP_UPDATE_FLAG_SANYO    1 // Supports SANYO OP
+#define PMAP_UPDATE_FLAG_NEW_SONY 2 // No support for the old T487
+
+#define PMAP_DISCOVER_COMMAND_TO 250 // ms, per command
+#define PMAP_DISCOVER_TO         900 // ms, for all devices
+
+#define PMAP_RECONNECT_POLL_MIN 100  // ms, doubled after each try
+#define PMAP_RECONNECT_POLL_MAX 3200 // ms
+#define PMAP_RECONNECT_PING_TO  500  // ms
+
+#define PMAP_LINK_COMMAND_TO 500   // ms
+#define PMAP_LINK_DEAD       3     // Timeouts without any reply, after which the burst is given up.
+#define PMAP_LINK_TEST_TO    60000 // ms, for all devices
+
+struct PmapSession
+{
+    unsigned char open, DebugLog, planned;
+};
+
+static struct PmapSession session;
+static int LinkExchanges; // For the processes of PmapLinkTestPorts().
+
+int PmapOpen(const char *device, const struct PmapOptions *options, struct PmapSession **NewSession)
+{
+    int result;
+
+    if (session.open)
+        return EBUSY;
+
+    if (options != NULL && options->handlers != NULL && (result = PlatSetHandlers(options->handlers)) != 0)
+        return result;
+    if (PlatOpenCOMPort(device) != 0)
+    {
+        PlatSetHandlers(NULL);
+        return ENODEV;
+    }
+
+    memset(&session, 0, sizeof(session));
+    session.open     = 1;
+    session.DebugLog = options != NULL ? options->DebugLog : 0;
+    if (session.DebugLog)
+        PlatDebugInit();
+    MetricsStart(device, options != NULL ? options->station : 0);
+    MechaInvalidateModel(); // This may be another console than the last one.
+
+    *NewSession = &session;
+
+    return 0;
+}
+
+void PmapClose(struct PmapSession *session)
+{
+    if (session->planned)
+        PmapUpdateCancel(session);
+
+    MetricsStop();
+    PlatCloseCOMPort();
+    if (session->DebugLog)
+        PlatDebugDeinit();
+    PlatSetHandlers(NULL);
+    session->open = 0;
+}
+
+// Runs in a process of its own for each device, so the MECHACON state of this process is not touched.
+static int PmapDiscoverProbe(const char *device, void *result)
+{
+    struct PmapPort *port = result;
+    const struct MechaIdentRaw *RawData;
+    int status;
+
+    if (PlatOpenCOMPort(device) != 0)
+        return ENODEV;
+    MechaInvalidateModel();
+    if ((status = MechaProbeQuick(MECHA_PROBE_IDENT, PMAP_DISCOVER_COMMAND_TO)) != 0)
+        return status;
+
+    MechaGetMode(&port->TestMode, &port->MD);
+    RawData = MechaGetRawIdent();
+    strcpy(port->cfd, RawData->cfd);
+    port->cfc       = RawData->cfc;
+    port->VersionID = RawData->VersionID;
+
+    return 0;
+}
+
+int PmapDiscover(int count, char *const patterns[], struct PmapPort *ports, int max, int *found)
+{
+    char devices[PLAT_MAX_PORTS][PLAT_DEVICE_MAX], *names[PLAT_MAX_PORTS];
+    int status[PLAT_MAX_PORTS], i, result;
+
+    if (session.open)
+        return EBUSY; // Its device would be probed from under it.
+
+    *found = PlatListCOMPorts(count, patterns, devices, max < PLAT_MAX_PORTS ? max : PLAT_MAX_PORTS);
+    for (i = 0; i < *found; i++)
+        names[i] = devices[i];
+    if ((result = PlatProbeCOMPorts(*found, names, &PmapDiscoverProbe, ports, sizeof(struct PmapPort), status, PMAP_DISCOVER_TO)) != 0)
+        return result;
+
+    for (i = 0; i < *found; i++)
+    {
+        strcpy(ports[i].device, devices[i]);
+        ports[i].status = status[i];
+    }
+
+    return 0;
+}
+
+int PmapProbe(struct PmapSession *session, int level)
+{
+    if (session->planned) // Everything that probes comes through here.
+        return EBUSY;
+    if (level < MECHA_PROBE_NONE || level >= MECHA_PROBE_COUNT)
+        return EINVAL;
+
+    return MechaProbe(level);
+}
+
+static int PmapLinkCompareRtt(const void *a, const void *b)
+{
+    return (int)*(const u16 *)a - (int)*(const u16 *)b;
+}
+
+int PmapLinkTest(struct PmapSession *session, int exchanges, struct PmapLinkStats *stats)
+{
+    static const struct
+    {
+        unsigned short int command;
+        const char *args;
+    } queries[2] = {{MECHA_CMD_READ_MODEL, ""}, {MECHA_CMD_EEPROM_READ, "0010"}};
+    char reply[MECHA_RX_BUFFER_SIZE], first[2][MECHA_RX_BUFFER_SIZE];
+    u16 rtt[PMAP_LINK_MAX_EXCHANGES];
+    struct PlatCOMPortErrors before, after;
+    int i, query, result;
+    u32 start;
+
+    (void)session;
+    if (exchanges < 1 || exchanges > PMAP_LINK_MAX_EXCHANGES)
+        return EINVAL;
+
+    memset(stats, 0, sizeof(*stats));
+    first[0][0]          = '\0';
+    first[1][0]          = '\0';
+    stats->HasLineErrors = PlatGetCOMPortErrors(&before) == 0;
+
+    MetricsOperation("linktest", NULL);
+    for (i = 0, stats->duration = PlatGetTicks(); i < exchanges && (stats->replies > 0 || stats->timeouts < PMAP_LINK_DEAD); i++)
+    {
+        query  = i % 2;
+        start  = PlatGetTicks();
+        result = MechaCommandExecute(queries[query].command, PMAP_LINK_COMMAND_TO, queries[query].args, reply, sizeof(reply));
+        stats->exchanges++;
+        stats->sent += 3 + strlen(queries[query].args) + 2;
+        if (result < 0)
+        {
+            stats->timeouts++;
+            continue;
+        }
+
+        rtt[stats->replies++] = (u16)(PlatGetTicks() - start);
+        stats->received += result + 2;
+        if (!is_valid_data(reply, result))
+            stats->invalid++;
+        else if (reply[0] != '0')
+            stats->refused++;
+        else if (first[query][0] == '\0')
+            strcpy(first[query], reply);
+        else if (strcmp(first[query], reply))
+            stats->mismatched++;
+    }
+    stats->duration = PlatGetTicks() - stats->duration;
+    MetricsOperation(NULL, NULL);
+
+    if (stats->HasLineErrors && PlatGetCOMPortErrors(&after) == 0)
+    {
+        stats->LineErrors.frame   = after.frame - before.frame;
+        stats->LineErrors.overrun = after.overrun - before.overrun;
+        stats->LineErrors.parity  = after.parity - before.parity;
+        stats->LineErrors.brk     = after.brk - before.brk;
+    }
+    else
+        stats->HasLineErrors = 0;
+
+    stats->WireTime = (stats->sent + stats->received) * 1000 / PMAP_LINK_BYTES_PER_S;
+    if (stats->replies > 0)
+    {
+        qsort(rtt, stats->replies, sizeof(rtt[0]), &PmapLinkCompareRtt);
+        stats->RttMin    = rtt[0];
+        stats->RttMedian = rtt[stats->replies / 2];
+        stats->Rtt90     = rtt[stats->replies * 9 / 10];
+        stats->Rtt99     = rtt[stats->replies * 99 / 100];
+        stats->RttMax    = rtt[stats->replies - 1];
+        for (i = 0; i < stats->replies; i++)
+            stats->RttTotal += rtt[i];
+    }
+
+    return 0;
+}
+
+static int PmapLinkTestProbe(const char *device, void *result)
+{
+    if (PlatOpenCOMPort(device) != 0)
+        return ENODEV;
+
+    return PmapLinkTest(&session, LinkExchanges, result);
+}
+
+int PmapLinkTestPorts(int count, char *const devices[], int exchanges, struct PmapLinkStats *stats)
+{
+    int status[PLAT_MAX_PORTS], i, result;
+
+    if (session.open)
+        return EBUSY;
+    if (count > PLAT_MAX_PORTS || exchanges < 1 || exchanges > PMAP_LINK_MAX_EXCHANGES)
+        return EINVAL;
+
+    LinkExchanges = exchanges;
+    if ((result = PlatProbeCOMPorts(count, devices, &PmapLinkTestProbe, stats, sizeof(struct PmapLinkStats), status, PMAP_LINK_TEST_TO)) != 0)
+        return result;
+
+    for (i = 0; i < count; i++)
+    {
+        snprintf(stats[i].device, sizeof(stats[i].device), "%s", devices[i]);
+        stats[i].status = status[i];
+    }
+
+    return 0;
+}
+
+int PmapReconnect(struct PmapSession *session, u32 timeout)
+{
+    char reply[MECHA_RX_BUFFER_SIZE];
+    unsigned short int interval;
+    u32 start;
+
+    for (start = PlatGetTicks(), interval = PMAP_RECONNECT_POLL_MIN;; interval = interval < PMAP_RECONNECT_POLL_MAX / 2 ? interval * 2 : PMAP_RECONNECT_POLL_MAX)
+    {
+        if (PlatWatchCOMPort(interval) == 0 && MechaCommandExecute(MECHA_CMD_READ_MODEL, PMAP_RECONNECT_PING_TO, NULL, reply, sizeof(reply)) > 0)
+            break;
+        if (PlatGetTicks() - start >= timeout)
+            return ETIMEDOUT;
+    }
+
+    return PmapProbe(session, MECHA_PROBE_STATUS);
+}
+
+int PmapGetIdent(struct PmapSession *session, int level, struct PmapIdent *ident)
+{
+    const struct MechaIdentRaw *RawData;
+    int result;
+
+    if ((result = PmapProbe(session, level)) != 0)
+        return result;
+
+    memset(ident, 0, sizeof(*ident));
+    MechaGetMode(&ident->TestMode, &ident->MD);
+    RawData = MechaGetRawIdent();
+    strcpy(ident->cfd, RawData->cfd);
+    ident->cfc        = RawData->cfc;
+    ident->VersionID  = RawData->VersionID;
+    if (level < MECHA_PROBE_FULL)
+        return 0;
+
+    ident->mecha      = MechaGetDesc();
+    ident->rtc        = MechaGetRTCName(MechaGetRTCType());
+    ident->RtcStatus  = MechaGetRtcStatusDesc(MechaGetRTCType(), MechaGetRTCStat());
+    ident->op         = MechaGetOPTypeName(MechaGetOP());
+    ident->lens       = MechaGetLensTypeName(MechaGetLens());
+    ident->cex        = MechaGetCEXDEX() != 0;
+    ident->ChecksumOK = MechaGetEEPROMStat() != 0;
+
+    if (EEPROMInitSerial() == 0)
+    {
+        EEPROMGetSerial(&ident->serial, &ident->emcs);
+        ident->HasSerial = 1;
+    }
+    ident->ModelID  = (u16)EEPROMGetModelID();
+    ident->TVSystem = MechaGetTVSystemDesc(EEPROMGetTVSystem());
+    if (EEPROMInitModelName() == 0)
+    {
+        strncpy(ident->model, EEPROMGetModelName(), sizeof(ident->model) - 1);
+        ident->HasModel = 1;
+    }
+    ident->erased = EEPROMGetEEPROMStatus() == 1;
+
+    return 0;
+}
+
+int PmapGetChassisCandidates(struct PmapSession *session, unsigned int *mask)
+{
+    typedef int (*ChassisProbe_t)(void);
+    static const ChassisProbe_t probes[MECHA_CHASSIS_MODEL_COUNT] = {
+        &IsChassisCex10000, // SCPH-10000
+        &IsChassisA,        // A
+        &IsChassisB,        // AB
+        &IsChassisB,        // B
+        &IsChassisC,        // C
+        &IsChassisD,        // D
+        &IsChassisF,        // F
+        &IsChassisG,        // G
+        &IsChassisDragon,   // H
+        &IsChassisDexA,     // DEX A
+        &IsChassisDexA,     // DEX A2
+        &IsChassisDexA,     // DEX A3
+        &IsChassisDexB,     // DEX B
+        &IsChassisDexD,     // DEX D
+        &IsChassisDragon,   // DEX H
+    };
+    int i, result;
+
+    if ((result = PmapProbe(session, MECHA_PROBE_FULL)) != 0)
+        return result;
+
+    for (i = 0, *mask = 0; i < MECHA_CHASSIS_MODEL_COUNT; i++)
+    {
+        if (probes[i]() != 0)
+            *mask |= 1u << i;
+    }
+
+    return 0;
+}
+
+int PmapEEPROMRead(struct PmapSession *session, unsigned short int word, u16 *data)
+{
+    (void)session;
+    return EEPROMReadWord(word, data);
+}
+
+int PmapEEPROMWrite(struct PmapSession *session, unsigned short int word, u16 data)
+{
+    if (session->planned)
+        return EBUSY;
+    return EEPROMWriteWord(word, data);
+}
+
+int PmapEEPROMDump(struct PmapSession *session, const struct EEPROMRegion *region, u16 *image, PmapProgress_t progress, void *context)
+{
+    int i, count, result;
+
+    count = region->end - region->start + 1;
+    MetricsOperation("dump", region->name);
+    for (i = 0, result = 0; i < count && result == 0; i++)
+    {
+        if (progress != NULL)
+            progress(i, count, context);
+        result = PmapEEPROMRead(session, region->start + i, &image[region->start + i]);
+    }
+    MetricsOperation(NULL, NULL);
+
+    return result;
+}
+
+int PmapEEPROMRestore(struct PmapSession *session, const struct EEPROMRegion *region, const u16 *image, PmapProgress_t progress, void *context)
+{
+    int i, count, result;
+
+    if (session->planned)
+        return EBUSY;
+
+    count = region->end - region->start + 1;
+    MetricsOperation("restore", region->name);
+    for (i = 0, result = 0; i < count && result == 0; i++)
+    {
+        if (progress != NULL)
+            progress(i, count, context);
+        result = PmapEEPROMWrite(session, region->start + i, image[region->start + i]);
+    }
+    MetricsOperation(NULL, NULL);
+
+    return result;
+}
+
+int PmapUpdateGetQuestions(struct PmapSession *session, int chassis, unsigned int *questions)
+{
+    static const unsigned char ChassisFlags[MECHA_CHASSIS_MODEL_COUNT] = {
+        0,                                                  // SCPH-10000
+        0,                                                  // A
+        0,                                                  // AB
+        0,                                                  // B
+        0,                                                  // C
+        0,                                                  // D
+        PMAP_UPDATE_FLAG_SANYO,                             // F
+        PMAP_UPDATE_FLAG_SANYO | PMAP_UPDATE_FLAG_NEW_SONY, // G
+        PMAP_UPDATE_FLAG_SANYO | PMAP_UPDATE_FLAG_NEW_SONY, // H
+        0,                                                  // DEX A
+        0,                                                  // DEX A2
+        0,                                                  // DEX A3
+        0,                                                  // DEX B
+        0,                                                  // DEX D
+        PMAP_UPDATE_FLAG_SANYO | PMAP_UPDATE_FLAG_NEW_SONY, // DEX H
+    };
+    int result;
+
+    if (chassis < 0 || chassis >= MECHA_CHASSIS_MODEL_COUNT)
+        return EINVAL;
+    if ((result = PmapProbe(session, MECHA_PROBE_FULL)) != 0)
+        return result;
+
+    *questions = 0;
+    if (ChassisFlags[chassis] & PMAP_UPDATE_FLAG_SANYO)
+        *questions |= PMAP_UPDATE_ASK_OP;
+    if (!(ChassisFlags[chassis] & PMAP_UPDATE_FLAG_NEW_SONY))
+        *questions |= PMAP_UPDATE_ASK_LENS;
+    if (EEPROMCanClearOSD2InitBit(chassis))
+        *questions |= PMAP_UPDATE_ASK_OSD2;
+
+    return 0;
+}
+
+int PmapUpdatePlan(struct PmapSession *session, const struct PmapUpdateOptions *options, struct PmapUpdatePlan *plan)
+{
+    int result;
+
+    if (options->chassis < 0 || options->chassis >= MECHA_CHASSIS_MODEL_COUNT)
+        return EINVAL;
+    if (session->planned)
+        PmapUpdateCancel(session);
+    if ((result = PmapProbe(session, MECHA_PROBE_FULL)) != 0)
+        return result;
+
+    if ((result = MechaUpdateChassis(options->chassis, options->ClearOSD2InitBit, options->ReplacedMecha, options->lens, options->op)) < 0)
+    {
+        MechaCommandListClear();
+        return result == -1 ? ENOTSUP : -result; // -1: the chassis does not support these options.
+    }
+
+    plan->regions    = (unsigned int)result;
+    plan->commands   = MechaCommandEstimateList(&plan->duration);
+    session->planned = 1;
+
+    return 0;
+}
+
+int PmapUpdateCommit(struct PmapSession *session)
+{
+    if (!session->planned)
+        return EINVAL;
+    session->planned = 0;
+
+    return MechaCommandExecuteList(NULL, NULL);
+}
+
+void PmapUpdateCancel(struct PmapSession *session)
+{
+    MechaCommandListClear();
+    session->planned = 0;
+}
+
+int PmapElectGetCheckpoint(struct PmapSession *session, int *stage)
+{
+    int result;
+
+    if ((result = PmapProbe(session, MECHA_PROBE_FULL)) != 0)
+        return result;
+    *stage = ElectLoadCheckpoint();
+
+    return 0;
+}
+
+int PmapElectRun(struct PmapSession *session, const struct PmapElectOptions *options)
+{
+    struct ElectRecordObserver observer;
+    int result, stage;
+
+    if ((result = PmapElectGetCheckpoint(session, &stage)) != 0)
+        return result;
+    if (options->stage >= 0)
+    {
+        if (options->stage >= ELECT_STAGE_COUNT)
+            return EINVAL;
+        stage = options->stage;
+    }
+
+    ElectConIsT10K = options->T10K;
+    if (options->simulate)
+        return ElectSimulateAutoAdjust(stage);
+
+    if (options->callbacks != NULL)
+    {
+        observer.step    = options->callbacks->step;
+        observer.value   = options->callbacks->value;
+        observer.context = options->callbacks->context;
+        ElectRecordSetObserver(&observer);
+    }
+    ElectProfiling = options->profile;
+    result         = ElectAutoAdjust(stage);
+    ElectProfiling = 0;
+    ElectRecordSetObserver(NULL);
+
+    return result;
+}
+
+void PmapElectAbort(struct PmapSession *session)
+{
+    (void)session;
+    ElectAbort();
+}
+
+int PmapMechaCommand(struct PmapSession *session, unsigned short int command, const char *args, unsigned short int timeout, char *reply, unsigned char size)
+{
+    if (session->planned && !MechaIsReadOnlyCommand(command))
+        return -EBUSY;
+    return MechaCommandExecute(command, timeout, args, reply, size);
+}
@@ -0,0 +1,145 @@
+/*  libpmap: PMAP for applications that drive consoles themselves, such as station software.
+    Include platform.h, mecha.h and eeprom.h before this file.
+
+    A session is a connection to one console. Functions return 0 or an error code: a positive errno value for problems
+    on this side, a negative errno value if the MECHACON did not reply, or its error code (RX_ERROR_*) if it refused.
+    Messages and operator prompts go through the handlers given to PmapOpen(), so nothing has to be read from stdout.
+
+    This is a one-session-per-process API, and it is not reentrant: the MECHACON state (ident data, EEPROM map and command
+    list) and the serial port belong to the process, so only one session can be open at a time (PmapOpen() returns EBUSY).
+    Use one process per console, as PlatRunStations() does. Calls must not overlap, e.g. from different threads. */
+
+struct PmapSession;
+
+struct PmapOptions
+{
+    const struct PlatHandlers *handlers; // NULL to use the console.
+    int station;                         // > 0 gives this session its own metrics file.
+    unsigned char DebugLog;              // Write the debug log for this session.
+};
+
+int PmapOpen(const char *device, const struct PmapOptions *options, struct PmapSession **session);
+void PmapClose(struct PmapSession *session);
+
+// Discovery, before opening a session: which of the serial devices have a console attached.
+struct PmapPort
+{
+    char device[PLAT_DEVICE_MAX];
+    int status; // 0 if a MECHACON replied, otherwise as for the other functions.
+    u8 TestMode, MD;
+    char cfd[11];
+    u32 cfc;
+    u16 VersionID;
+};
+
+/*  Probes the devices that match the patterns (see PlatListCOMPorts()) all at the same time, with short timeouts,
+    so that this takes well under a second. *found is set to the number of devices probed (up to max). */
+int PmapDiscover(int count, char *const patterns[], struct PmapPort *ports, int max, int *found);
+
+/*  Link self-test: a burst of exchanges that change nothing, cfd and ce1 (the version ID word) in turn. Replies that are not
+    what the first reply to the same command was count as mismatched, as the values cannot change. Times are in ms. */
+#define PMAP_LINK_BYTES_PER_S   5760 // 57600 baud 8N1: 10 bits per byte, and only one direction at a time.
+#define PMAP_LINK_MAX_EXCHANGES 1000
+
+struct PmapLinkStats
+{
+    char device[PLAT_DEVICE_MAX];
+    int status; // For PmapLinkTestPorts(): 0 if the device was tested.
+    int exchanges, replies, timeouts;
+    int refused, invalid, mismatched; // refused: NG replies; invalid: with characters that are not printable.
+    u32 RttMin, RttMedian, Rtt90, Rtt99, RttMax, RttTotal;
+    u32 sent, received, duration, WireTime; // WireTime: how long the bytes that were sent and received take at 57600 8N1.
+    unsigned char HasLineErrors;             // The driver counts line errors, and those during the burst are in LineErrors.
+    struct PlatCOMPortErrors LineErrors;
+};
+
+int PmapLinkTest(struct PmapSession *session, int exchanges, struct PmapLinkStats *stats);
+int PmapLinkTestPorts(int count, char *const devices[], int exchanges, struct PmapLinkStats *stats); // All at once, without a session.
+
+// Probe and init. Whatever was probed stays valid until something is written to the EEPROM.
+int PmapProbe(struct PmapSession *session, int level); // MECHA_PROBE_*
+
+/*  Connection watchdog, for after the console stopped replying (e.g. it was reset, or its adapter was unplugged).
+    Waits up to timeout ms for the adapter to be back and the MECHACON to reply again, polling at growing intervals.
+    If it is the same console and its EEPROM checksum is OK, whatever was probed before stays valid. */
+int PmapReconnect(struct PmapSession *session, u32 timeout);
+
+struct PmapIdent
+{
+    u8 TestMode, MD;
+    char cfd[11];
+    u32 cfc;
+    u16 VersionID;
+    const char *mecha, *rtc, *RtcStatus, *op, *lens, *TVSystem; // Descriptions, valid for the lifetime of the process.
+    unsigned char cex, ChecksumOK, erased;                      // erased: the defaults must be loaded.
+    unsigned char HasSerial, HasModel;
+    u32 serial;
+    u8 emcs;
+    u16 ModelID;
+    char model[17];
+};
+
+// Probes up to level first. Only MECHA_PROBE_FULL fills in more than the mode, cfd, cfc and version ID.
+int PmapGetIdent(struct PmapSession *session, int level, struct PmapIdent *ident);
+int PmapGetChassisCandidates(struct PmapSession *session, unsigned int *mask); // Bit n set: could be MECHA_CHASSIS_MODEL n.
+
+// EEPROM. Images keep the layout of a full dump (word N at image[N]); only the region's words are used.
+typedef void (*PmapProgress_t)(int done, int total, void *context); // Called before each word.
+
+int PmapEEPROMRead(struct PmapSession *session, unsigned short int word, u16 *data);
+int PmapEEPROMWrite(struct PmapSession *session, unsigned short int word, u16 data);
+int PmapEEPROMDump(struct PmapSession *session, const struct EEPROMRegion *region, u16 *image, PmapProgress_t progress, void *context);
+int PmapEEPROMRestore(struct PmapSession *session, const struct EEPROMRegion *region, const u16 *image, PmapProgress_t progress, void *context);
+
+// Update: plan for a chassis, then commit or cancel the plan.
+#define PMAP_UPDATE_ASK_OP   0x01 // The optical block must be chosen.
+#define PMAP_UPDATE_ASK_LENS 0x02 // The object lens must be chosen, if the optical block is from SONY.
+#define PMAP_UPDATE_ASK_OSD2 0x04 // The OSD2 init bit is set and may be cleared.
+
+struct PmapUpdateOptions
+{
+    int chassis; // MECHA_CHASSIS_MODEL_*
+    unsigned char ClearOSD2InitBit, ReplacedMecha;
+    int lens, op; // MECHA_LENS_*, MECHA_OP_*
+};
+
+struct PmapUpdatePlan
+{
+    unsigned int regions; // UPDATE_REGION_* that will be updated.
+    int commands;
+    u32 duration; // Estimated, in ms.
+};
+
+int PmapUpdateGetQuestions(struct PmapSession *session, int chassis, unsigned int *questions); // PMAP_UPDATE_ASK_*
+/*  While a plan is pending, until it is committed or cancelled, whatever would probe the console again or write to its EEPROM
+    returns EBUSY, as that would make the plan out of date. A new plan replaces the pending one. */
+int PmapUpdatePlan(struct PmapSession *session, const struct PmapUpdateOptions *options, struct PmapUpdatePlan *plan);
+int PmapUpdateCommit(struct PmapSession *session);
+void PmapUpdateCancel(struct PmapSession *session);
+
+// ELECT. The results are also written to elect_results.csv and .jsonl, as from the menu.
+struct PmapElectCallbacks
+{
+    void (*step)(int stage, const char *label, u32 duration, int ok, void *context);
+    void (*value)(const char *name, float value, float min, float max, int ok, void *context);
+    void *context;
+};
+
+struct PmapElectOptions
+{
+    int stage;                                  // ELECT_STAGE_*, or -1 to resume from the checkpoint.
+    unsigned char T10K;                         // DTL-T10000 (YEDS-18), for DEX A-chassis consoles.
+    unsigned char profile;                      // Profile the step timings.
+    unsigned char simulate;                     // Show the commands and estimated duration, without sending anything.
+    const struct PmapElectCallbacks *callbacks; // May be NULL.
+};
+
+int PmapElectGetCheckpoint(struct PmapSession *session, int *stage); // The first stage that has to be (re)done.
+int PmapElectRun(struct PmapSession *session, const struct PmapElectOptions *options);
+/*  Cancels the run in progress: PmapElectRun() returns ECANCELED before sending anything more, and it can be resumed from
+    the checkpoint. The only call that may be made during another, from the prompt or step handlers. */
+void PmapElectAbort(struct PmapSession *session);
+
+/*  MECHA diagnostics. Returns the length of the reply (without the CR/LF), or a negative errno value.
+    While an update is planned, only commands that read are sent (-EBUSY for the others). */
+int PmapMechaCommand(struct PmapSession *session, unsigned short int command, const char *args, unsigned short int timeout, char *reply, unsigned char size);
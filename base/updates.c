@@ -12,10 +12,66 @@
 extern char MechaName[9], RTCData[19];
 extern unsigned char ConMD, ConType, ConTM, ConCEXDEX, ConOP, ConLens, ConRTC, ConRTCStat, ConECR, ConChecksumStat;
 
+/*  Conditions for update data and default commands.
+    If neither bit of a pair is set, the entry applies to both. */
+#define UPDATE_IF_T487        0x0001
+#define UPDATE_IF_T609K       0x0002
+#define UPDATE_IF_SONY        0x0004
+#define UPDATE_IF_SANYO       0x0008
+#define UPDATE_IF_FORCED      0x0010 // Only if the update is forced.
+#define UPDATE_IF_NOT_FORCED  0x0020 // Only if the update is not forced.
+#define UPDATE_IF_RICOH       0x0040
+#define UPDATE_IF_ROHM        0x0080
+#define UPDATE_IF_MD36_38     0x0100
+#define UPDATE_IF_NOT_MD36_38 0x0200
+#define UPDATE_LOW_BYTE       0x0400 // Only the lower byte is checked and replaced.
+
+// Profile flags
+#define UPDATE_PROFILE_FORCE_LENS  0x01 // Force the update if the lens was changed.
+#define UPDATE_PROFILE_FORCE_OP    0x02 // Force the update if the OP was changed.
+#define UPDATE_PROFILE_FORCE_OPT13 0x04 // Force the update if OPT_13 is neither 0x4f4f nor 0x6f4f.
+#define UPDATE_PROFILE_NO_OSD2     0x08 // Never clear the OSD2 init bit.
+
+// RTC type
+#define UPDATE_RTC_RICOH 0 // RS5C348AE2
+#define UPDATE_RTC_ROHM  1 // BU9861FV-WE2
+#define UPDATE_RTC_AUTO  2 // Whichever the MECHACON reports.
+
 struct UpdateData
 {
     u16 word, data;
     unsigned char type;
+    unsigned short int cond;
+    u16 expect; // If non-zero, the value to check for instead of data.
+};
+
+struct UpdateCommand
+{
+    unsigned short int command;
+    const char *args;
+    const char *label;
+    unsigned short int cond;
+};
+
+struct UpdateContext
+{
+    int ReplacedMecha, lens, opt;
+    unsigned char forced, id;
+    unsigned short int UpdateStat;
+    u16 value[0x200];
+    u32 pending[0x200 / 32];
+};
+
+typedef int (*UpdateHook_t)(struct UpdateContext *ctx);
+
+struct UpdateProfile
+{
+    const struct UpdateCommand *defaults; // Issued only if the update is forced.
+    const struct UpdateData *data;
+    unsigned char flags, rtc, ecr; // ecr is only used with the Ricoh RTC. 0x00 is always used with the Rohm RTC.
+    UpdateHook_t prepare;          // Before the decision to force is made. May set ReplacedMecha.
+    UpdateHook_t fixup;            // After the defaults. May queue additional writes.
+    UpdateHook_t post;             // After the RTC, before the post-update commands.
 };
 
 static int AddUpdateItem(u16 word, u16 value, unsigned char index)
@@ -25,1739 +81,699 @@ static int AddUpdateItem(u16 word, u16 value, unsigned char index)
     return MechaCommandAdd(MECHA_CMD_EEPROM_WRITE, args, index, 0, MECHA_TASK_NORMAL_TO, "EEPROM WRITE");
 }
 
-int MechaUpdateChassisCex10000(int ClearOSD2InitBit, int ReplacedMecha, int lens, int opt)
+static void UpdateQueueWrite(struct UpdateContext *ctx, u16 word, u16 value, unsigned short int region)
 {
-    unsigned short int UpdateStat;
-    unsigned char forceUpdate, i, id;
-    const struct UpdateData data[] = {
-        {EEPROM_MAP_CON, MECHA_CHASSIS_A, UPDATE_REGION_SERVO},
-        {0x0026, 0x0e0a, UPDATE_REGION_SERVO},
-        {EEPROM_MAP_ECR, 0x0019, UPDATE_REGION_EEP_ECR},
-        {0x0024, 0x4242, UPDATE_REGION_SERVO},
-        {EEPROM_MAP_FOK, 0x72a0, UPDATE_REGION_SERVO},
-        {0x002e, 0x213a, UPDATE_REGION_SERVO},
-        {0x0032, 0x0a0a, UPDATE_REGION_SERVO},
-        {0x0021, 0x1006, UPDATE_REGION_SERVO},
-        {0x0022, 0x1010, UPDATE_REGION_SERVO},
-        {0x0023, 0x4250, UPDATE_REGION_SERVO},
-        {0x0025, 0x4242, UPDATE_REGION_SERVO},
-        {0x002a, 0xe000, UPDATE_REGION_SERVO},
-        {0x002d, 0x5005, UPDATE_REGION_SERVO},
-        {0x00f1, 0x0f38, UPDATE_REGION_TRAY},
-        {0x00f2, 0x1e47, UPDATE_REGION_TRAY},
-        {0x00f3, 0x5626, UPDATE_REGION_TRAY},
-        {0x00f4, 0x6b27, UPDATE_REGION_TRAY},
-        {0x00f9, 0x9038, UPDATE_REGION_TRAY},
-        {0x00fa, 0x0012, UPDATE_REGION_TRAY},
-        {0x00f5, 0x0029, UPDATE_REGION_TRAY},
-        {0x00f6, 0x1929, UPDATE_REGION_TRAY},
-        {0x00f7, 0x6013, UPDATE_REGION_TRAY},
-        {0x00f8, 0x7029, UPDATE_REGION_TRAY},
-        {0x00fb, 0x0002, UPDATE_REGION_TRAY},
-        {0xFFFF, 0xFFFF, 0xFF}};
-
-    id          = 1;
-    UpdateStat  = 0;
-    forceUpdate = (ReplacedMecha || ConChecksumStat == 0 || lens != ConLens);
-    if (forceUpdate)
-    {
-        UpdateStat |= UPDATE_REGION_DEFAULTS;
-        MechaCommandAdd(MECHA_CMD_CLEAR_CONF, "02", id++, 0, MECHA_TASK_NORMAL_TO, "DEFAULT DISC DETECT");
-        MechaCommandAdd(MECHA_CMD_CLEAR_CONF, "03", id++, 0, MECHA_TASK_NORMAL_TO, "DEFAULT SERVO");
-        MechaCommandAdd(MECHA_CMD_CLEAR_CONF, (ConMD == 36 || ConMD == 38) ? "04" : "05", id++, 0, MECHA_TASK_NORMAL_TO, "DEFAULT TRAY");
-    }
+    ctx->value[word] = value;
+    ctx->pending[word / 32] |= ((u32)1 << (word % 32));
+    ctx->UpdateStat |= region;
+}
 
-    if (lens == MECHA_LENS_T487)
-    {
-        if (forceUpdate || EEPMapRead(EEPROM_MAP_OPT_13) != 0x7777)
-        {
-            AddUpdateItem(EEPROM_MAP_OPT_13, 0x7777, id++);
-            UpdateStat |= UPDATE_REGION_SERVO;
-        }
-        if (forceUpdate || EEPMapRead(EEPROM_MAP_OPT_12) != 0x97c9)
-        {
-            AddUpdateItem(EEPROM_MAP_OPT_12, 0x97c9, id++);
-            UpdateStat |= UPDATE_REGION_SERVO;
-        }
-        if (forceUpdate || EEPMapRead(0x027) != 0x0606)
-        {
-            AddUpdateItem(0x027, 0x0606, id++);
-            UpdateStat |= UPDATE_REGION_SERVO;
-        }
-    }
-    else
-    {
-        if (forceUpdate || EEPMapRead(EEPROM_MAP_OPT_13) != 0x7878)
-        {
-            AddUpdateItem(EEPROM_MAP_OPT_13, 0x7777, id++);
-            UpdateStat |= UPDATE_REGION_SERVO;
-        }
-        if (forceUpdate || EEPMapRead(EEPROM_MAP_OPT_12) != 0x98c9)
-        {
-            AddUpdateItem(EEPROM_MAP_OPT_12, 0x98c9, id++);
-            UpdateStat |= UPDATE_REGION_SERVO;
-        }
-        if (forceUpdate || EEPMapRead(0x027) != 0x0808)
-        {
-            AddUpdateItem(0x027, 0x0606, id++);
-            UpdateStat |= UPDATE_REGION_SERVO;
-        }
-    }
+static int UpdateApplies(const struct UpdateContext *ctx, unsigned short int cond)
+{
+    if ((cond & UPDATE_IF_T487) && ctx->lens != MECHA_LENS_T487)
+        return 0;
+    if ((cond & UPDATE_IF_T609K) && ctx->lens != MECHA_LENS_T609K)
+        return 0;
+    if ((cond & UPDATE_IF_SONY) && ctx->opt != MECHA_OP_SONY)
+        return 0;
+    if ((cond & UPDATE_IF_SANYO) && ctx->opt != MECHA_OP_SANYO)
+        return 0;
+    if ((cond & UPDATE_IF_FORCED) && !ctx->forced)
+        return 0;
+    if ((cond & UPDATE_IF_NOT_FORCED) && ctx->forced)
+        return 0;
+    if ((cond & UPDATE_IF_RICOH) && ConRTC != MECHA_RTC_RICOH)
+        return 0;
+    if ((cond & UPDATE_IF_ROHM) && ConRTC == MECHA_RTC_RICOH)
+        return 0;
+    if ((cond & UPDATE_IF_MD36_38) && !(ConMD == 36 || ConMD == 38))
+        return 0;
+    if ((cond & UPDATE_IF_NOT_MD36_38) && (ConMD == 36 || ConMD == 38))
+        return 0;
 
-    for (i = 0; data[i].type != 0xFF; i++, id++)
-    {
-        if (forceUpdate || EEPMapRead(data[i].word) != data[i].data)
-        {
-            AddUpdateItem(data[i].word, data[i].data, id);
-            UpdateStat |= data[i].type;
-        }
-    }
-    if (forceUpdate || ConECR != 0x19)
-    {
-        MechaCommandAdd(MECHA_CMD_ECR_WRITE, "19", id++, 0, MECHA_TASK_NORMAL_TO, "ECR WRITE");
-        UpdateStat |= UPDATE_REGION_ECR;
-    }
+    return 1;
+}
 
+static void UpdateRicohRTC(struct UpdateContext *ctx)
+{ // RS5C348AE2
 #ifdef UPDATE_RTC_NEW
     if (pstrincmp("3088", RTCData, 4))
     {
         strcpy(RTCData, "3088");
         MechaGetTimeString(&RTCData[4]);
-        MechaCommandAdd(MECHA_CMD_RTC_WRITE, RTCData, id++, 0, MECHA_TASK_NORMAL_TO, "RTC WRITE");
-        UpdateStat |= (UPDATE_REGION_RTC | UPDATE_REGION_RTC_CTL12 | UPDATE_REGION_RTC_TIME);
+        MechaCommandAdd(MECHA_CMD_RTC_WRITE, RTCData, ctx->id++, 0, MECHA_TASK_NORMAL_TO, "RTC WRITE");
+        ctx->UpdateStat |= (UPDATE_REGION_RTC | UPDATE_REGION_RTC_CTL12 | UPDATE_REGION_RTC_TIME);
     }
 #else
     if (!pstrincmp("30C8", RTCData, 4))
     {
         strncpy(RTCData, "3088", 4);
-        MechaCommandAdd(MECHA_CMD_RTC_WRITE, RTCData, id++, 0, MECHA_TASK_NORMAL_TO, "RTC WRITE");
-        UpdateStat |= (UPDATE_REGION_RTC | UPDATE_REGION_RTC_CTL12);
+        MechaCommandAdd(MECHA_CMD_RTC_WRITE, RTCData, ctx->id++, 0, MECHA_TASK_NORMAL_TO, "RTC WRITE");
+        ctx->UpdateStat |= (UPDATE_REGION_RTC | UPDATE_REGION_RTC_CTL12);
     }
     else if (pstrincmp("3088", RTCData, 4))
     {
         strcpy(RTCData, "308801151803258401");
-        MechaCommandAdd(MECHA_CMD_RTC_WRITE, RTCData, id++, 0, MECHA_TASK_NORMAL_TO, "RTC WRITE");
-        UpdateStat |= (UPDATE_REGION_RTC | UPDATE_REGION_RTC_CTL12 | UPDATE_REGION_RTC_TIME);
+        MechaCommandAdd(MECHA_CMD_RTC_WRITE, RTCData, ctx->id++, 0, MECHA_TASK_NORMAL_TO, "RTC WRITE");
+        ctx->UpdateStat |= (UPDATE_REGION_RTC | UPDATE_REGION_RTC_CTL12 | UPDATE_REGION_RTC_TIME);
     }
 #endif
+}
 
-    if (MechaAddPostUpdateCmds(0, id) != 0)
+static void UpdateRohmRTC(struct UpdateContext *ctx)
+{ // BU9861FV-WE2
+    if (pstrincmp("3000", RTCData, 4))
     {
-        MechaCommandListClear();
-        return 0;
+#ifdef UPDATE_RTC_NEW
+        strcpy(RTCData, "3000");
+        MechaGetTimeString(&RTCData[4]);
+#else
+        strcpy(RTCData, "300001431800221001");
+#endif
+        MechaCommandAdd(MECHA_CMD_RTC_WRITE, RTCData, ctx->id++, 0, MECHA_TASK_NORMAL_TO, "RTC WRITE");
+        ctx->UpdateStat |= (UPDATE_REGION_RTC | UPDATE_REGION_RTC_CTL12 | UPDATE_REGION_RTC_TIME);
     }
-
-    return UpdateStat;
 }
 
-int MechaUpdateChassisA(int ClearOSD2InitBit, int ReplacedMecha, int lens, int opt)
+static int MechaUpdateRun(const struct UpdateProfile *profile, int ClearOSD2InitBit, int ReplacedMecha, int lens, int opt)
 {
-    unsigned short int UpdateStat;
-    unsigned char forceUpdate, i, id;
-    const struct UpdateData data[] = {
-        {0x0026, 0x0e0a, UPDATE_REGION_SERVO},
-        {EEPROM_MAP_ECR, 0x0019, UPDATE_REGION_EEP_ECR},
-        {0x0024, 0x3000, UPDATE_REGION_SERVO},
-        {0x0038, 0x0000, UPDATE_REGION_SERVO},
-        {0x00f1, 0x0f38, UPDATE_REGION_TRAY},
-        {0x00f2, 0x1e47, UPDATE_REGION_TRAY},
-        {0x00f3, 0x5626, UPDATE_REGION_TRAY},
-        {0x00f4, 0x6b27, UPDATE_REGION_TRAY},
-        {0x00f9, 0x9038, UPDATE_REGION_TRAY},
-        {0x00f5, 0x0029, UPDATE_REGION_TRAY},
-        {0x00f6, 0x1929, UPDATE_REGION_TRAY},
-        {0x00f7, 0x6013, UPDATE_REGION_TRAY},
-        {0x00f8, 0x7029, UPDATE_REGION_TRAY},
-        {0x00fb, 0x0002, UPDATE_REGION_TRAY},
-        {0xFFFF, 0xFFFF, 0xFF}};
-
-    id          = 1;
-    UpdateStat  = 0;
-    forceUpdate = (ReplacedMecha || ConChecksumStat == 0 || lens != ConLens);
-    if (forceUpdate)
-    {
-        UpdateStat |= UPDATE_REGION_DEFAULTS;
-        MechaCommandAdd(MECHA_CMD_CLEAR_CONF, "02", id++, 0, MECHA_TASK_NORMAL_TO, "DEFAULT DISC DETECT");
-        MechaCommandAdd(MECHA_CMD_CLEAR_CONF, "03", id++, 0, MECHA_TASK_NORMAL_TO, "DEFAULT SERVO");
-        MechaCommandAdd(MECHA_CMD_CLEAR_CONF, "05", id++, 0, MECHA_TASK_NORMAL_TO, "DEFAULT TRAY");
-    }
+    struct UpdateContext ctx;
+    const struct UpdateCommand *cmd;
+    const struct UpdateData *entry;
+    unsigned char rtc, ecr;
+    char args[4];
+    u16 word, current;
+    int result;
+
+    memset(ctx.pending, 0, sizeof(ctx.pending));
+    ctx.ReplacedMecha = ReplacedMecha;
+    ctx.lens          = lens;
+    ctx.opt           = opt;
+    ctx.forced        = 0;
+    ctx.id            = 1;
+    ctx.UpdateStat    = 0;
 
-    if (lens == MECHA_LENS_T487)
+    if (profile->prepare != NULL && (result = profile->prepare(&ctx)) != 0)
+        return result;
+
+    ctx.forced = (ctx.ReplacedMecha || ConChecksumStat == 0 ||
+                  ((profile->flags & UPDATE_PROFILE_FORCE_LENS) && lens != ConLens) ||
+                  ((profile->flags & UPDATE_PROFILE_FORCE_OP) && opt != ConOP) ||
+                  ((profile->flags & UPDATE_PROFILE_FORCE_OPT13) && EEPMapRead(EEPROM_MAP_OPT_13) != 0x4f4f && EEPMapRead(EEPROM_MAP_OPT_13) != 0x6f4f));
+    if (ctx.forced)
     {
-        if (forceUpdate || EEPMapRead(EEPROM_MAP_OPT_13) != 0x4f4f)
-        {
-            AddUpdateItem(EEPROM_MAP_OPT_13, 0x4f4f, id++);
-            UpdateStat |= UPDATE_REGION_SERVO;
-        }
-        if (forceUpdate || EEPMapRead(EEPROM_MAP_OPT_12) != 0x4d8f)
-        {
-            AddUpdateItem(EEPROM_MAP_OPT_12, 0x4d8f, id++);
-            UpdateStat |= UPDATE_REGION_SERVO;
-        }
-        if (forceUpdate || EEPMapRead(0x027) != 0x0606)
+        ctx.UpdateStat |= UPDATE_REGION_DEFAULTS;
+        for (cmd = profile->defaults; cmd->label != NULL; cmd++)
         {
-            AddUpdateItem(0x027, 0x0606, id++);
-            UpdateStat |= UPDATE_REGION_SERVO;
+            if (UpdateApplies(&ctx, cmd->cond))
+                MechaCommandAdd(cmd->command, cmd->args, ctx.id++, 0, MECHA_TASK_NORMAL_TO, cmd->label);
         }
     }
-    else
+
+    if (profile->fixup != NULL && (result = profile->fixup(&ctx)) != 0)
     {
-        if (forceUpdate || EEPMapRead(EEPROM_MAP_OPT_13) != 0x6f6f)
-        {
-            AddUpdateItem(EEPROM_MAP_OPT_13, 0x6f6f, id++);
-            UpdateStat |= UPDATE_REGION_SERVO;
-        }
-        if (forceUpdate || EEPMapRead(EEPROM_MAP_OPT_12) != 0x6d8f)
-        {
-            AddUpdateItem(EEPROM_MAP_OPT_12, 0x6d8f, id++);
-            UpdateStat |= UPDATE_REGION_SERVO;
-        }
-        if (forceUpdate || EEPMapRead(0x027) != 0x0808)
-        {
-            AddUpdateItem(0x027, 0x0606, id++);
-            UpdateStat |= UPDATE_REGION_SERVO;
-        }
+        MechaCommandListClear();
+        return result;
     }
 
-    for (i = 0; data[i].type != 0xFF; i++, id++)
+    // Diff against the EEPROM map in a single pass. The map is not read if the update is forced.
+    for (entry = profile->data; entry->type != 0xFF; entry++)
     {
-        if (forceUpdate || EEPMapRead(data[i].word) != data[i].data)
+        if (!UpdateApplies(&ctx, entry->cond))
+            continue;
+
+        if (entry->cond & UPDATE_LOW_BYTE)
         {
-            AddUpdateItem(data[i].word, data[i].data, id);
-            UpdateStat |= data[i].type;
+            current = EEPMapRead(entry->word);
+            if ((current & 0xFF) != (entry->data & 0xFF))
+                UpdateQueueWrite(&ctx, entry->word, (current & 0xFF00) | (entry->data & 0xFF), entry->type);
         }
-    }
-    if (forceUpdate || ConECR != 0x19)
-    {
-        MechaCommandAdd(MECHA_CMD_ECR_WRITE, "19", id++, 0, MECHA_TASK_NORMAL_TO, "ECR WRITE");
-        UpdateStat |= UPDATE_REGION_ECR;
+        else if (ctx.forced || EEPMapRead(entry->word) != (entry->expect != 0 ? entry->expect : entry->data))
+            UpdateQueueWrite(&ctx, entry->word, entry->data, entry->type);
     }
 
-#ifdef UPDATE_RTC_NEW
-    if (pstrincmp("3088", RTCData, 4))
+    // Each word is written once, in address order.
+    for (word = 0; word < 0x200; word++)
     {
-        strcpy(RTCData, "3088");
-        MechaGetTimeString(&RTCData[4]);
-        MechaCommandAdd(MECHA_CMD_RTC_WRITE, RTCData, id++, 0, MECHA_TASK_NORMAL_TO, "RTC WRITE");
-        UpdateStat |= (UPDATE_REGION_RTC | UPDATE_REGION_RTC_CTL12 | UPDATE_REGION_RTC_TIME);
+        if (ctx.pending[word / 32] & ((u32)1 << (word % 32)))
+            AddUpdateItem(word, ctx.value[word], ctx.id++);
     }
-#else
-    if (!pstrincmp("30C8", RTCData, 4))
+
+    if (profile->rtc == UPDATE_RTC_AUTO)
+        rtc = (ConRTC == MECHA_RTC_RICOH) ? UPDATE_RTC_RICOH : UPDATE_RTC_ROHM;
+    else
+        rtc = profile->rtc;
+
+    ecr = (rtc == UPDATE_RTC_RICOH) ? profile->ecr : 0x00;
+    if (ctx.forced || ConECR != ecr)
     {
-        strncpy(RTCData, "3088", 4);
-        MechaCommandAdd(MECHA_CMD_RTC_WRITE, RTCData, id++, 0, MECHA_TASK_NORMAL_TO, "RTC WRITE");
-        UpdateStat |= (UPDATE_REGION_RTC | UPDATE_REGION_RTC_CTL12);
+        snprintf(args, sizeof(args), "%02x", ecr);
+        MechaCommandAdd(MECHA_CMD_ECR_WRITE, args, ctx.id++, 0, MECHA_TASK_NORMAL_TO, "ECR WRITE");
+        ctx.UpdateStat |= UPDATE_REGION_ECR;
     }
-    else if (pstrincmp("3088", RTCData, 4))
+
+    if (rtc == UPDATE_RTC_RICOH)
+        UpdateRicohRTC(&ctx);
+    else
+        UpdateRohmRTC(&ctx);
+
+    if (profile->post != NULL && (result = profile->post(&ctx)) != 0)
     {
-        strcpy(RTCData, "308801151803258401");
-        MechaCommandAdd(MECHA_CMD_RTC_WRITE, RTCData, id++, 0, MECHA_TASK_NORMAL_TO, "RTC WRITE");
-        UpdateStat |= (UPDATE_REGION_RTC | UPDATE_REGION_RTC_CTL12 | UPDATE_REGION_RTC_TIME);
+        MechaCommandListClear();
+        return result;
     }
-#endif
 
-    if (MechaAddPostUpdateCmds(ClearOSD2InitBit, id) != 0)
+    if (MechaAddPostUpdateCmds((profile->flags & UPDATE_PROFILE_NO_OSD2) ? 0 : ClearOSD2InitBit, ctx.id) != 0)
     {
         MechaCommandListClear();
         return 0;
     }
 
-    return UpdateStat;
+    return ctx.UpdateStat;
 }
 
-int MechaUpdateChassisAB(int ClearOSD2InitBit, int ReplacedMecha, int lens, int opt)
+static unsigned int UpdateGetMechaVersion(void)
 {
-    unsigned short int UpdateStat;
-    unsigned char forceUpdate, i, id;
-    const struct UpdateData data[] = {
-        {EEPROM_MAP_CON, 0x0801, UPDATE_REGION_SERVO},
-        {EEPROM_MAP_ECR, 0x0019, UPDATE_REGION_EEP_ECR},
-        {0x00f1, 0x0f38, UPDATE_REGION_TRAY},
-        {0x00f2, 0x1e47, UPDATE_REGION_TRAY},
-        {0x00f3, 0x5626, UPDATE_REGION_TRAY},
-        {0x00f4, 0x6b27, UPDATE_REGION_TRAY},
-        {0x00f9, 0x9038, UPDATE_REGION_TRAY},
-        {0x00f5, 0x0029, UPDATE_REGION_TRAY},
-        {0x00f6, 0x1929, UPDATE_REGION_TRAY},
-        {0x00f7, 0x6013, UPDATE_REGION_TRAY},
-        {0x00f8, 0x7029, UPDATE_REGION_TRAY},
-        {0x00fb, 0x0002, UPDATE_REGION_TRAY},
-        {0xFFFF, 0xFFFF, 0xFF}};
-
-    id          = 1;
-    UpdateStat  = 0;
-    forceUpdate = (ReplacedMecha || ConChecksumStat == 0 || lens != ConLens || (EEPMapRead(EEPROM_MAP_OPT_13) != 0x4f4f && EEPMapRead(EEPROM_MAP_OPT_13) != 0x6f4f));
-    if (forceUpdate)
-    {
-        UpdateStat |= UPDATE_REGION_DEFAULTS;
-        MechaCommandAdd(MECHA_CMD_CLEAR_CONF, "02", id++, 0, MECHA_TASK_NORMAL_TO, "DEFAULT DISC DETECT");
-        MechaCommandAdd(MECHA_CMD_CLEAR_CONF, "03", id++, 0, MECHA_TASK_NORMAL_TO, "DEFAULT SERVO");
-        MechaCommandAdd(MECHA_CMD_CLEAR_CONF, "05", id++, 0, MECHA_TASK_NORMAL_TO, "DEFAULT TRAY");
+    char versionOnly[5];
 
-        if (EEPMapRead(0x026) == 0x0c06 || EEPMapRead(0x026) == 0x0e06)
-        {
-            AddUpdateItem(0x026, 0x0e06, id++);
-            UpdateStat |= UPDATE_REGION_SERVO;
-        }
-        else if (EEPMapRead(0x0026) != 0x9a4d)
-        {
-            // Not AB-chassis
-            MechaCommandListClear();
-            return -EINVAL;
-        }
-        // Do nothing for 0x9a4d
-    }
-    else
-    {
-        if (EEPMapRead(0x026) == 0x0c06)
-        {
-            AddUpdateItem(0x026, 0x0e06, id++);
-            UpdateStat |= UPDATE_REGION_SERVO;
-        }
-        else if (EEPMapRead(0x026) != 0x0e06 && EEPMapRead(0x0026) != 0x9a4d)
-        {
-            // Not AB-chassis
-            MechaCommandListClear();
-            return -EINVAL;
-        }
-        // Do nothing for 0x0e06 and 0x9a4d
-    }
-    if (lens == MECHA_LENS_T487)
-    {
-        if (forceUpdate || EEPMapRead(EEPROM_MAP_OPT_12) != 0x4d8f)
-        {
-            AddUpdateItem(EEPROM_MAP_OPT_12, 0x4d8f, id++);
-            UpdateStat |= UPDATE_REGION_SERVO;
-        }
-        if (forceUpdate || EEPMapRead(0x027) != 0x0606)
-        {
-            AddUpdateItem(0x027, 0x0606, id++);
-            UpdateStat |= UPDATE_REGION_SERVO;
-        }
-    }
-    else
-    {
-        // Strangely not for the T487. So no new value for T487?
-        if (forceUpdate || EEPMapRead(EEPROM_MAP_OPT_13) != 0x6f6f)
-        {
-            AddUpdateItem(EEPROM_MAP_OPT_13, 0x6f6f, id++);
-            UpdateStat |= UPDATE_REGION_SERVO;
-        }
-        if (forceUpdate || EEPMapRead(EEPROM_MAP_OPT_12) != 0x6d8f)
-        {
-            AddUpdateItem(EEPROM_MAP_OPT_12, 0x6d8f, id++);
-            UpdateStat |= UPDATE_REGION_SERVO;
-        }
-        if (forceUpdate || EEPMapRead(0x027) != 0x0808)
-        {
-            AddUpdateItem(0x027, 0x0606, id++);
-            UpdateStat |= UPDATE_REGION_SERVO;
-        }
-    }
+    strncpy(versionOnly, &MechaName[2], 4);
+    versionOnly[4] = '\0';
+    return (unsigned int)strtoul(versionOnly, NULL, 16);
+}
 
-    for (i = 0; data[i].type != 0xFF; i++, id++)
-    {
-        if (forceUpdate || EEPMapRead(data[i].word) != data[i].data)
-        {
-            AddUpdateItem(data[i].word, data[i].data, id);
-            UpdateStat |= data[i].type;
-        }
-    }
-    if (forceUpdate || ConECR != 0x19)
-    {
-        MechaCommandAdd(MECHA_CMD_ECR_WRITE, "19", id++, 0, MECHA_TASK_NORMAL_TO, "ECR WRITE");
-        UpdateStat |= UPDATE_REGION_ECR;
-    }
+static int UpdateFixupAB(struct UpdateContext *ctx)
+{
+    u16 value;
 
-#ifdef UPDATE_RTC_NEW
-    if (pstrincmp("3088", RTCData, 4))
-    {
-        strcpy(RTCData, "3088");
-        MechaGetTimeString(&RTCData[4]);
-        MechaCommandAdd(MECHA_CMD_RTC_WRITE, RTCData, id++, 0, MECHA_TASK_NORMAL_TO, "RTC WRITE");
-        UpdateStat |= (UPDATE_REGION_RTC | UPDATE_REGION_RTC_CTL12 | UPDATE_REGION_RTC_TIME);
-    }
-#else
-    if (!pstrincmp("30C8", RTCData, 4))
-    {
-        strncpy(RTCData, "3088", 4);
-        MechaCommandAdd(MECHA_CMD_RTC_WRITE, RTCData, id++, 0, MECHA_TASK_NORMAL_TO, "RTC WRITE");
-        UpdateStat |= (UPDATE_REGION_RTC | UPDATE_REGION_RTC_CTL12);
-    }
-    else if (pstrincmp("3088", RTCData, 4))
-    {
-        strcpy(RTCData, "308801151803258401");
-        MechaCommandAdd(MECHA_CMD_RTC_WRITE, RTCData, id++, 0, MECHA_TASK_NORMAL_TO, "RTC WRITE");
-        UpdateStat |= (UPDATE_REGION_RTC | UPDATE_REGION_RTC_CTL12 | UPDATE_REGION_RTC_TIME);
+    value = EEPMapRead(0x026);
+    if (value == 0x0c06 || (ctx->forced && value == 0x0e06))
+        UpdateQueueWrite(ctx, 0x026, 0x0e06, UPDATE_REGION_SERVO);
+    else if (value != 0x0e06 && value != 0x9a4d)
+    { // Not AB-chassis
+        return -EINVAL;
     }
-#endif
+    // Do nothing for 0x9a4d (and 0x0e06, if not forced)
 
-    if (MechaAddPostUpdateCmds(ClearOSD2InitBit, id) != 0)
-    {
-        MechaCommandListClear();
-        return 0;
-    }
+    return 0;
+}
+
+static int UpdateFixupBC(struct UpdateContext *ctx)
+{
+    u16 value;
 
-    return UpdateStat;
+    value = EEPMapRead(0x026);
+    if (value == 0x0c0a || value == 0x0c06 || (ctx->forced && value == 0x0e06))
+        UpdateQueueWrite(ctx, 0x026, 0x0e06, UPDATE_REGION_SERVO);
+    // Do nothing for 0x9a4d (and 0x0e06, if not forced). Do nothing if not any of these.
+
+    return 0;
 }
 
-int MechaUpdateChassisB(int ClearOSD2InitBit, int ReplacedMecha, int lens, int opt)
+static int UpdatePrepareD(struct UpdateContext *ctx)
 {
-    unsigned short int UpdateStat;
-    unsigned char forceUpdate, i, id;
-    const struct UpdateData data[] = {
-        {EEPROM_MAP_CON, MECHA_CHASSIS_B, UPDATE_REGION_SERVO},
-        {EEPROM_MAP_ECR, 0x0015, UPDATE_REGION_EEP_ECR},
-        {0x00c0, 0x003e, UPDATE_REGION_TILT},
-        {0x00c1, 0x1430, UPDATE_REGION_TILT},
-        {0x00c2, 0x1167, UPDATE_REGION_TILT},
-        {0x00c3, 0x012c, UPDATE_REGION_TILT},
-        {0x00c4, 0x2805, UPDATE_REGION_TILT},
-        {0xFFFF, 0xFFFF, 0xFF}};
-
-    id          = 1;
-    UpdateStat  = 0;
-    forceUpdate = (ReplacedMecha || ConChecksumStat == 0 || lens != ConLens || (EEPMapRead(EEPROM_MAP_OPT_13) != 0x4f4f && EEPMapRead(EEPROM_MAP_OPT_13) != 0x6f4f));
-    if (forceUpdate)
-    {
-        UpdateStat |= UPDATE_REGION_DEFAULTS;
-        MechaCommandAdd(MECHA_CMD_CLEAR_CONF, "02", id++, 0, MECHA_TASK_NORMAL_TO, "DEFAULT DISC DETECT");
-        MechaCommandAdd(MECHA_CMD_CLEAR_CONF, "03", id++, 0, MECHA_TASK_NORMAL_TO, "DEFAULT SERVO");
-        MechaCommandAdd(MECHA_CMD_CLEAR_CONF, "04", id++, 0, MECHA_TASK_NORMAL_TO, "DEFAULT TILT");
-        MechaCommandAdd(MECHA_CMD_CLEAR_CONF, "05", id++, 0, MECHA_TASK_NORMAL_TO, "DEFAULT TRAY");
+    unsigned int version;
 
-        if (EEPMapRead(0x026) == 0x0c0a || EEPMapRead(0x026) == 0x0c06 || EEPMapRead(0x026) == 0x0e06)
-        {
-            AddUpdateItem(0x026, 0x0e06, id++);
-            UpdateStat |= UPDATE_REGION_SERVO;
-        }
-        // Do nothing for 0x9a4d (also does nothing if not 0x9a4d).
+    version = UpdateGetMechaVersion();
+    if (version < 0x0206)
+    { // Not a D-chassis MECHACON
+        return -EINVAL;
     }
-    else
+
+    switch (EEPMapRead(0x026))
     {
-        if (EEPMapRead(0x026) == 0x0c0a || EEPMapRead(0x026) == 0x0c06)
-        {
-            AddUpdateItem(0x026, 0x0e06, id++);
-            UpdateStat |= UPDATE_REGION_SERVO;
-        }
-        // Do nothing for 0x0e06 and 0x9a4d (also does nothing if not any of these).
+        case 0x0c06:
+        case 0x0e06:
+            if (version != 0x0206)
+                ctx->ReplacedMecha = 1;
+            break;
+        case 0x9a4d:
+            break;
+        default:
+            ctx->ReplacedMecha = 1;
+            break;
     }
-    if (lens == MECHA_LENS_T487)
+
+    return 0;
+}
+
+static int UpdateFixupD(struct UpdateContext *ctx)
+{
+    u16 value;
+
+    if (ctx->forced)
     {
-        if (forceUpdate || EEPMapRead(EEPROM_MAP_OPT_12) != 0x4d8f)
-        {
-            AddUpdateItem(EEPROM_MAP_OPT_12, 0x4d8f, id++);
-            UpdateStat |= UPDATE_REGION_SERVO;
-        }
-        if (forceUpdate || EEPMapRead(0x027) != 0x0606)
-        {
-            AddUpdateItem(0x027, 0x0606, id++);
-            UpdateStat |= UPDATE_REGION_SERVO;
-        }
+        if (UpdateGetMechaVersion() == 0x0206)
+            UpdateQueueWrite(ctx, 0x026, 0x0e06, UPDATE_REGION_SERVO);
     }
     else
     {
-        // Strangely not for the T487. So no new value for T487?
-        if (forceUpdate || EEPMapRead(EEPROM_MAP_OPT_13) != 0x6f6f)
-        {
-            AddUpdateItem(EEPROM_MAP_OPT_13, 0x6f6f, id++);
-            UpdateStat |= UPDATE_REGION_SERVO;
-        }
-        if (forceUpdate || EEPMapRead(EEPROM_MAP_OPT_12) != 0x6d8f)
-        {
-            AddUpdateItem(EEPROM_MAP_OPT_12, 0x6d8f, id++);
-            UpdateStat |= UPDATE_REGION_SERVO;
-        }
-        if (forceUpdate || EEPMapRead(0x027) != 0x0808)
+        value = EEPMapRead(0x026);
+        if (value == 0x0c06)
+            UpdateQueueWrite(ctx, 0x026, 0x0e06, UPDATE_REGION_SERVO);
+        else if ((value != 0x0e06) && (value != 0x9a4d))
         {
-            AddUpdateItem(0x027, 0x0606, id++);
-            UpdateStat |= UPDATE_REGION_SERVO;
+            // Do nothing for 0x0e06 and 0x9a4d. Do nothing if not any of these, other than displaying a warning ("unknown data at 0x26 on D-chassis").
+            PlatShowEMessage("unknown data at 0x26 on D-chassis\n");
         }
     }
 
-    for (i = 0; data[i].type != 0xFF; i++, id++)
-    {
-        if (forceUpdate || EEPMapRead(data[i].word) != data[i].data)
-        {
-            AddUpdateItem(data[i].word, data[i].data, id);
-            UpdateStat |= data[i].type;
-        }
+    return 0;
+}
+
+static int UpdatePrepareF(struct UpdateContext *ctx)
+{
+    /*  As of MAR 2003, there was no official support for a SANYO Optical Block with T609K lens.
+        However, the original code that handles the T609K has checks for the SANYO OP,
+        and sometimes uses different values from the SONY OP. */
+    if (ctx->lens == MECHA_LENS_T609K && ctx->opt == MECHA_OP_SANYO)
+    { // Not supported.
+        return -1;
     }
-    if (forceUpdate || ConECR != 0x15)
-    {
-        MechaCommandAdd(MECHA_CMD_ECR_WRITE, "15", id++, 0, MECHA_TASK_NORMAL_TO, "ECR WRITE");
-        UpdateStat |= UPDATE_REGION_ECR;
+    // The tool checks to ensure that only either a SANYO or SONY OP was selected.
+    if (ctx->opt != MECHA_OP_SONY && ctx->opt != MECHA_OP_SANYO)
+    { // Not supported
+        return -1;
     }
 
-#ifdef UPDATE_RTC_NEW
-    if (pstrincmp("3088", RTCData, 4))
-    {
-        strcpy(RTCData, "3088");
-        MechaGetTimeString(&RTCData[4]);
-        MechaCommandAdd(MECHA_CMD_RTC_WRITE, RTCData, id++, 0, MECHA_TASK_NORMAL_TO, "RTC WRITE");
-        UpdateStat |= (UPDATE_REGION_RTC | UPDATE_REGION_RTC_CTL12 | UPDATE_REGION_RTC_TIME);
-    }
-#else
-    if (!pstrincmp("30C8", RTCData, 4))
-    {
-        strncpy(RTCData, "3088", 4);
-        MechaCommandAdd(MECHA_CMD_RTC_WRITE, RTCData, id++, 0, MECHA_TASK_NORMAL_TO, "RTC WRITE");
-        UpdateStat |= (UPDATE_REGION_RTC | UPDATE_REGION_RTC_CTL12);
+    return 0;
+}
+
+static int UpdatePrepareG(struct UpdateContext *ctx)
+{
+    // The tool checks to ensure that only either a SANYO or SONY OP was selected.
+    if (ctx->opt != MECHA_OP_SONY && ctx->opt != MECHA_OP_SANYO)
+    { // Not supported
+        return -1;
     }
-    else if (pstrincmp("3088", RTCData, 4))
-    {
-        strcpy(RTCData, "308801151803258401");
-        MechaCommandAdd(MECHA_CMD_RTC_WRITE, RTCData, id++, 0, MECHA_TASK_NORMAL_TO, "RTC WRITE");
-        UpdateStat |= (UPDATE_REGION_RTC | UPDATE_REGION_RTC_CTL12 | UPDATE_REGION_RTC_TIME);
+    // The tool checks and supports only the first and second versions of the G-chassis.
+    if (ConType != MECHA_TYPE_G && ConType != MECHA_TYPE_G2)
+    { // Not supported.
+        return -1;
     }
-#endif
 
-    if (MechaAddPostUpdateCmds(ClearOSD2InitBit, id) != 0)
-    {
-        MechaCommandListClear();
-        return 0;
-    }
+    if (EEPMapRead(0x00e) != 0xFFFF)
+        ctx->ReplacedMecha = 1;
 
-    return UpdateStat;
+    return 0;
 }
 
-int MechaUpdateChassisC(int ClearOSD2InitBit, int ReplacedMecha, int lens, int opt)
+// The data here seems to appear at the end of the EEPROM (+0x320).
+static const char *PCEA1240H[] = {
+    "00b1ea8bc0c8198435",
+    "0103dccd7dd383ff90",
+    "02a6848324ddf69aeb",
+    "0303dccd7dd383ff90",
+    "04617d23a351054e8c",
+    "0503dccd7dd383ff90",
+    "062ea7ea3314ad99d4",
+    "075da60dccd71b3d78",
+    "08cb2751b48540f096",
+    "09b6daef699d964b9c",
+    "0a956d23a4e123571c",
+    "0bce8ed32f1cc6554b",
+    "0ccdfb5aefd39b3ad8",
+    "0db4899cb772970027",
+    "0ebadf03dccd7dd383",
+    "0fe6e874df39d0d517",
+    "1088ccb01b751b05a5",
+    "11d621b070d9a5768b",
+    "1224b6090c6547f105",
+    "137cd2b18287ff3da3",
+    "14fced984b964ff83f",
+    "15327cfa386b13c769",
+    "169a24b37564c23965",
+    "172d432c30153d01b2",
+    "187d3464661f675020",
+    "19c8b413bdc93098fe",
+    "1ae2e723073e3a51d2",
+    "1bff90b77afdff00e3",
+    NULL};
+
+/*  Something here checks for 0x19, 0x1A, 0x1B and 0x1C. If it's any of those, then the codes for the CEX H-chassis are used instead.
+    No idea what it actually checks for because the UI doesn't seem to set it (always 0xFFFFFFFF).
+    The data here seems to appear at the very end of the EEPROM (+0x320) */
+static const char *PCEA1240DexH[] = {
+    "0003dccd7dd383ff90",
+    "0103dccd7dd383ff90",
+    "02ffffffffffffffff",
+    "03ffffffffffffffff",
+    "04ffffffffffffffff",
+    "05ffffffffffffffff",
+    "06ffffffffffffffff",
+    "07ffffffffffffffff",
+    "08ffffffffffffffff",
+    "09ffffffffffffffff",
+    "0affffffffffffffff",
+    "0bffffffffffffffff",
+    "0cffffffffffffffff",
+    "0dffffffffffffffff",
+    "0effffffffffffffff",
+    "0fffffffffffffffff",
+    "10ffffffffffffffff",
+    "11ffffffffffffffff",
+    "12ffffffffffffffff",
+    "13ffffffffffffffff",
+    "14ffffffffffffffff",
+    "15ffffffffffffffff",
+    "16ffffffffffffffff",
+    "17ffffffffffffffff",
+    "18ffffffffffffffff",
+    "19ffffffffffffffff",
+    "1affffffffffffffff",
+    "1bffffffffffffffff",
+    NULL};
+
+static void UpdateAddPCEA1240(struct UpdateContext *ctx, const char **lines)
 {
-    unsigned short int UpdateStat;
-    unsigned char forceUpdate, i, id;
-    const struct UpdateData data[] = {
-        {EEPROM_MAP_CON, MECHA_CHASSIS_BCD, UPDATE_REGION_SERVO},
-        {EEPROM_MAP_ECR, 0x0015, UPDATE_REGION_EEP_ECR},
-        {0xFFFF, 0xFFFF, 0xFF}};
-
-    id          = 1;
-    UpdateStat  = 0;
-    forceUpdate = (ReplacedMecha || ConChecksumStat == 0 || lens != ConLens || (EEPMapRead(EEPROM_MAP_OPT_13) != 0x4f4f && EEPMapRead(EEPROM_MAP_OPT_13) != 0x6f4f));
-    if (forceUpdate)
-    {
-        UpdateStat |= UPDATE_REGION_DEFAULTS;
-        MechaCommandAdd(MECHA_CMD_CLEAR_CONF, "02", id++, 0, MECHA_TASK_NORMAL_TO, "DEFAULT DISC DETECT");
-        MechaCommandAdd(MECHA_CMD_CLEAR_CONF, "03", id++, 0, MECHA_TASK_NORMAL_TO, "DEFAULT SERVO");
-        MechaCommandAdd(MECHA_CMD_CLEAR_CONF, "05", id++, 0, MECHA_TASK_NORMAL_TO, "DEFAULT TRAY");
+    for (; *lines != NULL; lines++)
+        MechaCommandAdd(MECHA_CMD_CFA, *lines, ctx->id++, 0, MECHA_TASK_NORMAL_TO, "PCEA1240");
+}
 
-        if (EEPMapRead(0x026) == 0x0c0a || EEPMapRead(0x026) == 0x0c06 || EEPMapRead(0x026) == 0x0e06)
-        {
-            AddUpdateItem(0x026, 0x0e06, id++);
-            UpdateStat |= UPDATE_REGION_SERVO;
-        }
-        // Do nothing for 0x9a4d (also does nothing if not 0x9a4d).
-    }
-    else
-    {
-        if (EEPMapRead(0x026) == 0x0c0a || EEPMapRead(0x026) == 0x0c06)
-        {
-            AddUpdateItem(0x026, 0x0e06, id++);
-            UpdateStat |= UPDATE_REGION_SERVO;
-        }
-        // Do nothing for 0x0e06 and 0x9a4d (also does nothing if not any of these).
-    }
-    if (lens == MECHA_LENS_T487)
-    {
-        if (forceUpdate || EEPMapRead(EEPROM_MAP_OPT_12) != 0x4d8f)
-        {
-            AddUpdateItem(EEPROM_MAP_OPT_12, 0x4d8f, id++);
-            UpdateStat |= UPDATE_REGION_SERVO;
-        }
-        if (forceUpdate || EEPMapRead(0x027) != 0x0606)
-        {
-            AddUpdateItem(0x027, 0x0606, id++);
-            UpdateStat |= UPDATE_REGION_SERVO;
-        }
-    }
-    else
-    {
-        // Strangely not for the T487. So no new value for T487?
-        if (forceUpdate || EEPMapRead(EEPROM_MAP_OPT_13) != 0x6f6f)
-        {
-            AddUpdateItem(EEPROM_MAP_OPT_13, 0x6f6f, id++);
-            UpdateStat |= UPDATE_REGION_SERVO;
-        }
-        if (forceUpdate || EEPMapRead(EEPROM_MAP_OPT_12) != 0x6d8f)
-        {
-            AddUpdateItem(EEPROM_MAP_OPT_12, 0x6d8f, id++);
-            UpdateStat |= UPDATE_REGION_SERVO;
-        }
-        if (forceUpdate || EEPMapRead(0x027) != 0x0808)
-        {
-            AddUpdateItem(0x027, 0x0606, id++);
-            UpdateStat |= UPDATE_REGION_SERVO;
-        }
-    }
-
-    for (i = 0; data[i].type != 0xFF; i++, id++)
-    {
-        if (forceUpdate || EEPMapRead(data[i].word) != data[i].data)
-        {
-            AddUpdateItem(data[i].word, data[i].data, id);
-            UpdateStat |= data[i].type;
-        }
-    }
-    if (forceUpdate || ConECR != 0x15)
-    {
-        MechaCommandAdd(MECHA_CMD_ECR_WRITE, "15", id++, 0, MECHA_TASK_NORMAL_TO, "ECR WRITE");
-        UpdateStat |= UPDATE_REGION_ECR;
-    }
-
-#ifdef UPDATE_RTC_NEW
-    if (pstrincmp("3088", RTCData, 4))
-    {
-        strcpy(RTCData, "3088");
-        MechaGetTimeString(&RTCData[4]);
-        MechaCommandAdd(MECHA_CMD_RTC_WRITE, RTCData, id++, 0, MECHA_TASK_NORMAL_TO, "RTC WRITE");
-        UpdateStat |= (UPDATE_REGION_RTC | UPDATE_REGION_RTC_CTL12 | UPDATE_REGION_RTC_TIME);
-    }
-#else
-    if (!pstrincmp("30C8", RTCData, 4))
-    {
-        strncpy(RTCData, "3088", 4);
-        MechaCommandAdd(MECHA_CMD_RTC_WRITE, RTCData, id++, 0, MECHA_TASK_NORMAL_TO, "RTC WRITE");
-        UpdateStat |= (UPDATE_REGION_RTC | UPDATE_REGION_RTC_CTL12);
-    }
-    else if (pstrincmp("3088", RTCData, 4))
-    {
-        strcpy(RTCData, "308801151803258401");
-        MechaCommandAdd(MECHA_CMD_RTC_WRITE, RTCData, id++, 0, MECHA_TASK_NORMAL_TO, "RTC WRITE");
-        UpdateStat |= (UPDATE_REGION_RTC | UPDATE_REGION_RTC_CTL12 | UPDATE_REGION_RTC_TIME);
-    }
-#endif
-
-    if (MechaAddPostUpdateCmds(ClearOSD2InitBit, id) != 0)
-    {
-        MechaCommandListClear();
-        return 0;
-    }
-
-    return UpdateStat;
-}
-
-int MechaUpdateChassisD(int ClearOSD2InitBit, int ReplacedMecha, int lens, int opt)
-{
-    unsigned short int UpdateStat;
-    unsigned char forceUpdate, i, id;
-    unsigned int version;
-    char versionOnly[5];
-    u16 value;
-    const struct UpdateData data[] = {
-        {EEPROM_MAP_CON, MECHA_CHASSIS_BCD, UPDATE_REGION_SERVO},
-        {EEPROM_MAP_ECR, 0x0013, UPDATE_REGION_EEP_ECR},
-        {0xFFFF, 0xFFFF, 0xFF}};
-
-    id         = 1;
-    UpdateStat = 0;
-    strncpy(versionOnly, &MechaName[2], 4);
-    versionOnly[4] = '\0';
-    version        = (unsigned int)strtoul(versionOnly, NULL, 16);
-    if (version < 0x0206)
-    { // Not a D-chassis MECHACON
-        return EINVAL;
-    }
-
-    switch (EEPMapRead(0x026))
-    {
-        case 0x0c06:
-        case 0x0e06:
-            if (version != 0x0206)
-                ReplacedMecha = 1;
-            break;
-        case 0x9a4d:
-            if (version < 0x0206)
-            {
-                PlatShowEMessage("Warning, MECHACON is changed to a lower version.\n");
-                ReplacedMecha = 1;
-            }
-            break;
-        default:
-            ReplacedMecha = 1;
-            break;
-    }
-
-    forceUpdate = (ReplacedMecha || ConChecksumStat == 0 || lens != ConLens);
-    if (forceUpdate)
-    {
-        UpdateStat |= UPDATE_REGION_DEFAULTS;
-        MechaCommandAdd(MECHA_CMD_CLEAR_CONF, "02", id++, 0, MECHA_TASK_NORMAL_TO, "DEFAULT DISC DETECT");
-        MechaCommandAdd(MECHA_CMD_CLEAR_CONF, "03", id++, 0, MECHA_TASK_NORMAL_TO, "DEFAULT SERVO");
-        MechaCommandAdd(MECHA_CMD_CLEAR_CONF, "05", id++, 0, MECHA_TASK_NORMAL_TO, "DEFAULT TRAY");
-    }
-
-    for (i = 0; data[i].type != 0xFF; i++, id++)
-    {
-        if (forceUpdate || EEPMapRead(data[i].word) != data[i].data)
-        {
-            AddUpdateItem(data[i].word, data[i].data, id);
-            UpdateStat |= data[i].type;
-        }
-    }
-
-    if (forceUpdate)
-    {
-        if (version == 0x0206)
-        {
-            AddUpdateItem(0x026, 0x0e06, id++);
-            UpdateStat |= UPDATE_REGION_SERVO;
-        }
-    }
-    else
-    {
-        value = EEPMapRead(0x026);
-        if (value == 0x0c06)
-        {
-            AddUpdateItem(0x026, 0x0e06, id++);
-            UpdateStat |= UPDATE_REGION_SERVO;
-        }
-        else if ((value != 0x0e06) && (value != 0x9a4d))
-        {
-            // Do nothing for 0x0e06 and 0x9a4d. Do nothing if not any of these, other than displaying a warning ("unknown data at 0x26 on D-chassis").
-            PlatShowEMessage("unknown data at 0x26 on D-chassis\n");
-        }
-    }
-
-    if (lens == MECHA_LENS_T487)
-    {
-        if (forceUpdate || EEPMapRead(EEPROM_MAP_OPT_13) != 0x6f5f)
-        {
-            AddUpdateItem(EEPROM_MAP_OPT_13, 0x6f5f, id++);
-            UpdateStat |= UPDATE_REGION_SERVO;
-        }
-
-        if (!forceUpdate)
-        {
-            if (EEPMapRead(EEPROM_MAP_OPT_12) != 0x4d8f)
-            {
-                AddUpdateItem(EEPROM_MAP_OPT_12, 0x4d8f, id++);
-                UpdateStat |= UPDATE_REGION_SERVO;
-            }
-
-            if (EEPMapRead(0x02d) != 0x5005)
-            {
-                AddUpdateItem(0x02d, 0x5005, id++);
-                UpdateStat |= UPDATE_REGION_SERVO;
-            }
-
-            if (EEPMapRead(0x03a) != 0x8080)
-            {
-                AddUpdateItem(0x03a, 0x8080, id++);
-                UpdateStat |= UPDATE_REGION_SERVO;
-            }
-        }
-    }
-    else
-    {
-        if (forceUpdate || EEPMapRead(EEPROM_MAP_OPT_13) != 0x6f6f)
-        {
-            AddUpdateItem(EEPROM_MAP_OPT_13, 0x6f6f, id++);
-            UpdateStat |= UPDATE_REGION_SERVO;
-        }
-
-        if (forceUpdate || EEPMapRead(EEPROM_MAP_OPT_12) != 0x6b8b)
-        {
-            AddUpdateItem(EEPROM_MAP_OPT_12, 0x6b8b, id++);
-            UpdateStat |= UPDATE_REGION_SERVO;
-        }
-        if (forceUpdate || EEPMapRead(0x02d) != 0x1405)
-        {
-            AddUpdateItem(0x02d, 0x1405, id++);
-            UpdateStat |= UPDATE_REGION_SERVO;
-        }
-        if (forceUpdate || EEPMapRead(0x03a) != 0x8060)
-        {
-            AddUpdateItem(0x03a, 0x8060, id++);
-            UpdateStat |= UPDATE_REGION_SERVO;
-        }
-    }
-
-    if (forceUpdate || ConECR != 0x13)
-    {
-        MechaCommandAdd(MECHA_CMD_ECR_WRITE, "13", id++, 0, MECHA_TASK_NORMAL_TO, "ECR WRITE");
-        UpdateStat |= UPDATE_REGION_ECR;
-    }
-
-#ifdef UPDATE_RTC_NEW
-    if (pstrincmp("3088", RTCData, 4))
-    {
-        strcpy(RTCData, "3088");
-        MechaGetTimeString(&RTCData[4]);
-        MechaCommandAdd(MECHA_CMD_RTC_WRITE, RTCData, id++, 0, MECHA_TASK_NORMAL_TO, "RTC WRITE");
-        UpdateStat |= (UPDATE_REGION_RTC | UPDATE_REGION_RTC_CTL12 | UPDATE_REGION_RTC_TIME);
-    }
-#else
-    if (!pstrincmp("30C8", RTCData, 4))
-    {
-        strncpy(RTCData, "3088", 4);
-        MechaCommandAdd(MECHA_CMD_RTC_WRITE, RTCData, id++, 0, MECHA_TASK_NORMAL_TO, "RTC WRITE");
-        UpdateStat |= (UPDATE_REGION_RTC | UPDATE_REGION_RTC_CTL12);
-    }
-    else if (pstrincmp("3088", RTCData, 4))
-    {
-        strcpy(RTCData, "308801151803258401");
-        MechaCommandAdd(MECHA_CMD_RTC_WRITE, RTCData, id++, 0, MECHA_TASK_NORMAL_TO, "RTC WRITE");
-        UpdateStat |= (UPDATE_REGION_RTC | UPDATE_REGION_RTC_CTL12 | UPDATE_REGION_RTC_TIME);
-    }
-#endif
-
-    if (MechaAddPostUpdateCmds(ClearOSD2InitBit, id) != 0)
-    {
-        MechaCommandListClear();
-        return 0;
-    }
-
-    return UpdateStat;
-}
-
-int MechaUpdateChassisF(int ClearOSD2InitBit, int ReplacedMecha, int lens, int opt)
-{
-    unsigned short int UpdateStat;
-    unsigned char forceUpdate, i, id;
-    const struct UpdateData data[] = {
-        {0x002a, 0xf050, UPDATE_REGION_SERVO},
-        {0x00f9, 0xb038, UPDATE_REGION_TRAY},
-        {0x00fa, 0x0068, UPDATE_REGION_TRAY},
-        {0x0033, 0xfd03, UPDATE_REGION_SERVO},
-        {0x003a, 0x8060, UPDATE_REGION_SERVO},
-        {0x003d, 0x2213, UPDATE_REGION_SERVO},
-        {0x00fb, 0x0007, UPDATE_REGION_TRAY},
-        {0xFFFF, 0xFFFF, 0xFF}};
-
-    /*  Instead of making individual checks, just check once here.
-        As of MAR 2003, there was no official support for a SANYO Optical Block with T609K lens.
-        However, the original code that handles the T609K has checks for the SANYO OP,
-        and sometimes uses different values from the SONY OP.
-        Where applicable, the code for both OPs are merged. */
-    if (lens == MECHA_LENS_T609K && opt == MECHA_OP_SANYO)
-    { // Not supported.
-        return -1;
-    }
-    // The tool checks to ensure that only either a SANYO or SONY OP was selected.
-    if (opt != MECHA_OP_SONY && opt != MECHA_OP_SANYO)
-    { // Not supported
-        return -1;
-    }
-
-    UpdateStat  = 0;
-    id          = 1;
-    forceUpdate = (ReplacedMecha || ConChecksumStat == 0 || lens != ConLens || opt != ConOP);
-    if (forceUpdate)
-    {
-        UpdateStat |= UPDATE_REGION_DEFAULTS;
-        MechaCommandAdd(MECHA_CMD_CLEAR_CONF, "02", id++, 0, MECHA_TASK_NORMAL_TO, "DEFAULT DISC DETECT");
-        MechaCommandAdd(MECHA_CMD_CLEAR_CONF, "03", id++, 0, MECHA_TASK_NORMAL_TO, "DEFAULT SERVO");
-        MechaCommandAdd(MECHA_CMD_CLEAR_CONF, "05", id++, 0, MECHA_TASK_NORMAL_TO, "DEFAULT TRAY");
-        if (opt == MECHA_OP_SANYO)
-            MechaCommandAdd(MECHA_CMD_SETUP_SANYO, NULL, id++, 0, MECHA_TASK_NORMAL_TO, "297 SANYO DEFAULTS");
-    }
-
-    if (lens == MECHA_LENS_T487)
-    {
-        if (opt == MECHA_OP_SANYO)
-        {
-            if (forceUpdate || EEPMapRead(EEPROM_MAP_OPT_13) != 0x6f6f)
-            {
-                AddUpdateItem(EEPROM_MAP_OPT_13, 0x6f6f, id++);
-                UpdateStat |= UPDATE_REGION_SERVO;
-            }
-
-            if (forceUpdate || EEPMapRead(EEPROM_MAP_OPT_12) != 0x6d8f)
-            {
-                AddUpdateItem(EEPROM_MAP_OPT_12, 0x6d8f, id++);
-                UpdateStat |= UPDATE_REGION_SERVO;
-            }
-        }
-        else
-        { // SONY OP
-            if (forceUpdate || EEPMapRead(EEPROM_MAP_OPT_13) != 0x6f4f)
-            {
-                AddUpdateItem(EEPROM_MAP_OPT_13, 0x6f4f, id++);
-                UpdateStat |= UPDATE_REGION_SERVO;
-            }
-
-            if (forceUpdate || EEPMapRead(EEPROM_MAP_OPT_12) != 0x4d8f)
-            {
-                AddUpdateItem(EEPROM_MAP_OPT_12, 0x4d8f, id++);
-                UpdateStat |= UPDATE_REGION_SERVO;
-            }
-        }
-
-        // For both OPs with T487
-        if (forceUpdate || EEPMapRead(0x027) != 0x4d4d)
-        {
-            AddUpdateItem(0x027, 0x4d4d, id++);
-            UpdateStat |= UPDATE_REGION_SERVO;
-        }
-        if (forceUpdate || EEPMapRead(0x02d) != 0x5005)
-        {
-            AddUpdateItem(0x02d, 0x5005, id++);
-            UpdateStat |= UPDATE_REGION_SERVO;
-        }
-        if (forceUpdate || EEPMapRead(0x02c) != 0x2424)
-        {
-            AddUpdateItem(0x02c, 0x2424, id++);
-            UpdateStat |= UPDATE_REGION_SERVO;
-        }
-        if (forceUpdate || EEPMapRead(0x044) != 0x0404)
-        {
-            AddUpdateItem(0x044, 0x0404, id++);
-            UpdateStat |= UPDATE_REGION_SERVO;
-        }
-    }
-    else
-    { // T609K lens
-        if (opt == MECHA_OP_SONY)
-        {
-            if (forceUpdate || EEPMapRead(EEPROM_MAP_OPT_12) != 0x6b8b)
-            {
-                AddUpdateItem(EEPROM_MAP_OPT_12, 0x6b8b, id++);
-                UpdateStat |= UPDATE_REGION_SERVO;
-            }
-
-            if (forceUpdate || EEPMapRead(0x02d) != 0x1405)
-            {
-                AddUpdateItem(0x02d, 0x1405, id++);
-                UpdateStat |= UPDATE_REGION_SERVO;
-            }
-        }
-        else
-        { // SANYO OP
-            if (forceUpdate || EEPMapRead(EEPROM_MAP_OPT_12) != 0x6d8f)
-            {
-                AddUpdateItem(EEPROM_MAP_OPT_12, 0x6d8f, id++);
-                UpdateStat |= UPDATE_REGION_SERVO;
-            }
-
-            if (forceUpdate || EEPMapRead(0x02d) != 0x5005)
-            {
-                AddUpdateItem(0x02d, 0x5005, id++);
-                UpdateStat |= UPDATE_REGION_SERVO;
-            }
-        }
-
-        // For both OPs with T609K
-        if (forceUpdate || EEPMapRead(EEPROM_MAP_OPT_13) != 0x4f6f)
-        {
-            AddUpdateItem(EEPROM_MAP_OPT_13, 0x4f6f, id++);
-            UpdateStat |= UPDATE_REGION_SERVO;
-        }
-        if (forceUpdate || EEPMapRead(0x027) != 0x4d9a)
-        {
-            AddUpdateItem(0x027, 0x4d9a, id++);
-            UpdateStat |= UPDATE_REGION_SERVO;
-        }
-        if (forceUpdate || EEPMapRead(0x02c) != 0x2324)
-        {
-            AddUpdateItem(0x02c, 0x2324, id++);
-            UpdateStat |= UPDATE_REGION_SERVO;
-        }
-        if (forceUpdate || EEPMapRead(0x044) != 0x0417)
-        {
-            AddUpdateItem(0x044, 0x0417, id++);
-            UpdateStat |= UPDATE_REGION_SERVO;
-        }
-    }
-    if (!forceUpdate)
-    { // Only if not forced (otherwise, no update is made).
-        if (opt == MECHA_OP_SONY)
-        {
-            if (EEPMapRead(0x008) != 0x4300)
-            {
-                AddUpdateItem(0x008, 0x4300, id++);
-                UpdateStat |= UPDATE_REGION_DISCDET;
-            }
-        }
-        else
-        {
-            if (EEPMapRead(0x008) != 0x8800)
-            {
-                AddUpdateItem(0x008, 0x8800, id++);
-                UpdateStat |= UPDATE_REGION_DISCDET;
-            }
-        }
-    }
-
-    for (i = 0; data[i].type != 0xFF; i++, id++)
-    {
-        if (forceUpdate || EEPMapRead(data[i].word) != data[i].data)
-        {
-            AddUpdateItem(data[i].word, data[i].data, id);
-            UpdateStat |= data[i].type;
-        }
-    }
-
-    if (ConRTC == MECHA_RTC_RICOH)
-    { // RS5C348AE2
-        if (forceUpdate || EEPMapRead(0x029) != 0xf113)
-        {
-            AddUpdateItem(0x029, 0xf113, id++);
-            UpdateStat |= UPDATE_REGION_EEP_ECR;
-        }
-
-        if (forceUpdate || ConECR != 0x13)
-        {
-            MechaCommandAdd(MECHA_CMD_ECR_WRITE, "13", id++, 0, MECHA_TASK_NORMAL_TO, "ECR WRITE");
-            UpdateStat |= UPDATE_REGION_ECR;
-        }
-
-#ifdef UPDATE_RTC_NEW
-        if (pstrincmp("3088", RTCData, 4))
-        {
-            strcpy(RTCData, "3088");
-            MechaGetTimeString(&RTCData[4]);
-            MechaCommandAdd(MECHA_CMD_RTC_WRITE, RTCData, id++, 0, MECHA_TASK_NORMAL_TO, "RTC WRITE");
-            UpdateStat |= (UPDATE_REGION_RTC | UPDATE_REGION_RTC_CTL12 | UPDATE_REGION_RTC_TIME);
-        }
-#else
-        if (!pstrincmp("30C8", RTCData, 4))
-        {
-            strncpy(RTCData, "3088", 4);
-            MechaCommandAdd(MECHA_CMD_RTC_WRITE, RTCData, id++, 0, MECHA_TASK_NORMAL_TO, "RTC WRITE");
-            UpdateStat |= (UPDATE_REGION_RTC | UPDATE_REGION_RTC_CTL12);
-        }
-        else if (pstrincmp("3088", RTCData, 4))
-        {
-            strcpy(RTCData, "308801151803258401");
-            MechaCommandAdd(MECHA_CMD_RTC_WRITE, RTCData, id++, 0, MECHA_TASK_NORMAL_TO, "RTC WRITE");
-            UpdateStat |= (UPDATE_REGION_RTC | UPDATE_REGION_RTC_CTL12 | UPDATE_REGION_RTC_TIME);
-        }
-#endif
-    }
-    else
-    { // BU9861FV-WE2
-        if (forceUpdate || EEPMapRead(0x029) != 0xf100)
-        {
-            AddUpdateItem(0x029, 0xf100, id++);
-            UpdateStat |= UPDATE_REGION_EEP_ECR;
-        }
-
-        if (forceUpdate || ConECR != 0x00)
-        {
-            MechaCommandAdd(MECHA_CMD_ECR_WRITE, "00", id++, 0, MECHA_TASK_NORMAL_TO, "ECR WRITE");
-            UpdateStat |= UPDATE_REGION_ECR;
-        }
-
-        if (pstrincmp("3000", RTCData, 4))
-        {
-#ifdef UPDATE_RTC_NEW
-            strcpy(RTCData, "3000");
-            MechaGetTimeString(&RTCData[4]);
-#else
-            strcpy(RTCData, "300001431800221001");
-#endif
-            MechaCommandAdd(MECHA_CMD_RTC_WRITE, RTCData, id++, 0, MECHA_TASK_NORMAL_TO, "RTC WRITE");
-            UpdateStat |= (UPDATE_REGION_RTC | UPDATE_REGION_RTC_CTL12 | UPDATE_REGION_RTC_TIME);
-        }
-    }
-    if (MechaAddPostUpdateCmds(ClearOSD2InitBit, id) != 0)
-    {
-        MechaCommandListClear();
-        return 0;
-    }
-
-    return UpdateStat;
-}
-
-int MechaUpdateChassisG(int ClearOSD2InitBit, int ReplacedMecha, int lens, int opt)
-{ // In EEPROM tool 2003/03/13, the newer G-chassis had no updates. In the (later) combined tool, both versions of the G-chassis share the same updates.
-    unsigned short int UpdateStat;
-    unsigned char forceUpdate, i, id;
-    const struct UpdateData data[] = {
-        {0x0038, 0x0808, UPDATE_REGION_SERVO},
-        {0x003e, 0x4032, UPDATE_REGION_SERVO},
-        {0x0006, 0x6a33, UPDATE_REGION_DISCDET},
-        {0x0040, 0x1039, UPDATE_REGION_SERVO},
-        {0x000e, 0xFFFF, UPDATE_REGION_SERVO},
-        {0xFFFF, 0xFFFF, 0xFF}};
-
-    // Instead of making individual checks, just check once here.
-    // The tool checks to ensure that only either a SANYO or SONY OP was selected.
-    if (opt != MECHA_OP_SONY && opt != MECHA_OP_SANYO)
-    { // Not supported
-        return -1;
-    }
-    // The tool checks and supports only the first and second versions of the G-chassis.
-    if (ConType != MECHA_TYPE_G && ConType != MECHA_TYPE_G2)
-    { // Not supported.
-        return -1;
-    }
-
-    if (EEPMapRead(0x00e) != 0xFFFF)
-        ReplacedMecha = 1;
-
-    UpdateStat  = 0;
-    id          = 1;
-    forceUpdate = (ReplacedMecha || ConChecksumStat == 0 || opt != ConOP);
-    if (forceUpdate)
-    {
-        UpdateStat |= UPDATE_REGION_DEFAULTS;
-        MechaCommandAdd(MECHA_CMD_EEPROM_WRITE, "000effff", id++, 0, MECHA_TASK_NORMAL_TO, "EEPROM WRITE 0x00E -> 0xFFFF");
-        MechaCommandAdd(MECHA_CMD_CLEAR_CONF, "02", id++, 0, MECHA_TASK_NORMAL_TO, "DEFAULT DISC DETECT");
-        MechaCommandAdd(MECHA_CMD_CLEAR_CONF, "03", id++, 0, MECHA_TASK_NORMAL_TO, "DEFAULT SERVO");
-        MechaCommandAdd(MECHA_CMD_CLEAR_CONF, "05", id++, 0, MECHA_TASK_NORMAL_TO, "DEFAULT TRAY");
-        if (opt == MECHA_OP_SANYO)
-            MechaCommandAdd(MECHA_CMD_SETUP_SANYO, NULL, id++, 0, MECHA_TASK_NORMAL_TO, "SANYO DEFAULTS");
-
-        AddUpdateItem(0x024, 0x3008, id++);
-
-        if (opt == MECHA_OP_SANYO)
-        {
-            AddUpdateItem(EEPROM_MAP_OPT_12, 0x6482, id++); // Only for SANYO OP
-            AddUpdateItem(0x031, 0x25c8, id++);
-            AddUpdateItem(0x04b, 0x1a1a, id++); // Only for SANYO OP
-        }
-        else
-        {
-            AddUpdateItem(0x031, 0x1cc8, id++);
-        }
-        UpdateStat |= UPDATE_REGION_SERVO;
-    }
-    else
-    {
-        if ((EEPMapRead(0x024) & 0xFF) != 0x08)
-        {
-            AddUpdateItem(0x024, (EEPMapRead(0x024) & 0xFF00) | 0x08, id++);
-            UpdateStat |= UPDATE_REGION_SERVO;
-        }
-
-        if (opt == MECHA_OP_SANYO)
-        {
-            if (EEPMapRead(EEPROM_MAP_OPT_12) != 0x6482)
-            { // Only for SANYO OP
-                AddUpdateItem(EEPROM_MAP_OPT_12, 0x6482, id++);
-                UpdateStat |= UPDATE_REGION_SERVO;
-            }
-
-            if (EEPMapRead(0x008) != 0x8800)
-            { // Only when update is not forced.
-                AddUpdateItem(0x008, 0x8800, id++);
-                UpdateStat |= UPDATE_REGION_DISCDET;
-            }
-
-            if (EEPMapRead(0x031) != 0x25c8)
-            {
-                AddUpdateItem(0x031, 0x25c8, id++);
-                UpdateStat |= UPDATE_REGION_SERVO;
-            }
-
-            if (EEPMapRead(0x04b) != 0x1a1a)
-            { // Only for SANYO OP
-                AddUpdateItem(0x04b, 0x1a1a, id++);
-                UpdateStat |= UPDATE_REGION_SERVO;
-            }
-        }
-        else
-        { // SONY OP
-            if (EEPMapRead(0x008) != 0x4300)
-            { // Only when update is not forced.
-                AddUpdateItem(0x008, 0x4300, id++);
-                UpdateStat |= UPDATE_REGION_DISCDET;
-            }
-
-            if (EEPMapRead(0x031) != 0x1cc8)
-            {
-                AddUpdateItem(0x031, 0x1cc8, id++);
-                UpdateStat |= UPDATE_REGION_SERVO;
-            }
-        }
-    }
-
-    for (i = 0; data[i].type != 0xFF; i++, id++)
-    {
-        if (forceUpdate || EEPMapRead(data[i].word) != data[i].data)
-        {
-            AddUpdateItem(data[i].word, data[i].data, id);
-            UpdateStat |= data[i].type;
-        }
-    }
-
-    // BU9861FV-WE2
-    if (forceUpdate || ConECR != 0x00)
-    {
-        MechaCommandAdd(MECHA_CMD_ECR_WRITE, "00", id++, 0, MECHA_TASK_NORMAL_TO, "ECR WRITE");
-        UpdateStat |= UPDATE_REGION_ECR;
-    }
-
-    if (pstrincmp("3000", RTCData, 4))
-    {
-#ifdef UPDATE_RTC_NEW
-        strcpy(RTCData, "3000");
-        MechaGetTimeString(&RTCData[4]);
-#else
-        strcpy(RTCData, "300001431800221001");
-#endif
-        MechaCommandAdd(MECHA_CMD_RTC_WRITE, RTCData, id++, 0, MECHA_TASK_NORMAL_TO, "RTC WRITE");
-        UpdateStat |= (UPDATE_REGION_RTC | UPDATE_REGION_RTC_CTL12 | UPDATE_REGION_RTC_TIME);
-    }
-    if (MechaAddPostUpdateCmds(ClearOSD2InitBit, id) != 0)
-    {
-        MechaCommandListClear();
-        return 0;
-    }
-
-    return UpdateStat;
-}
-
-int MechaUpdateChassisDexA(int ClearOSD2InitBit, int ReplacedMecha, int lens, int opt)
-{
-    unsigned short int UpdateStat;
-    unsigned char forceUpdate, i, id;
-    const struct UpdateData data[] = {
-        {0x0026, 0x0e0a, UPDATE_REGION_SERVO},
-        {EEPROM_MAP_ECR, 0x0019, UPDATE_REGION_EEP_ECR},
-        {EEPROM_MAP_FOK, 0xb2a0, UPDATE_REGION_SERVO},
-        {0x002e, 0x213a, UPDATE_REGION_SERVO},
-        {0x0032, 0x0a0a, UPDATE_REGION_SERVO},
-        {0x002d, 0x5005, UPDATE_REGION_SERVO},
-        {0x00f1, 0x0f38, UPDATE_REGION_TRAY},
-        {0x00f2, 0x1e47, UPDATE_REGION_TRAY},
-        {0x00f3, 0x5626, UPDATE_REGION_TRAY},
-        {0x00f4, 0x6b27, UPDATE_REGION_TRAY},
-        {0x00f9, 0x9038, UPDATE_REGION_TRAY},
-        {0x00fa, 0x0012, UPDATE_REGION_TRAY},
-        {0x00f5, 0x0029, UPDATE_REGION_TRAY},
-        {0x00f6, 0x1929, UPDATE_REGION_TRAY},
-        {0x00f7, 0x6013, UPDATE_REGION_TRAY},
-        {0x00f8, 0x7029, UPDATE_REGION_TRAY},
-        {0x0140, 0x0000, UPDATE_REGION_EEGS},
-        {0x0147, 0x0000, UPDATE_REGION_EEGS},
-        {0x00fb, 0x0002, UPDATE_REGION_TRAY},
-        {0xFFFF, 0xFFFF, 0xFF}};
-
-    id          = 1;
-    UpdateStat  = 0;
-    forceUpdate = (ReplacedMecha || ConChecksumStat == 0 || lens != ConLens);
-    if (forceUpdate)
-    {
-        UpdateStat |= UPDATE_REGION_DEFAULTS;
-        MechaCommandAdd(MECHA_CMD_CLEAR_CONF, "02", id++, 0, MECHA_TASK_NORMAL_TO, "DEFAULT DISC DETECT");
-        MechaCommandAdd(MECHA_CMD_CLEAR_CONF, "03", id++, 0, MECHA_TASK_NORMAL_TO, "DEFAULT SERVO");
-        MechaCommandAdd(MECHA_CMD_CLEAR_CONF, (ConMD == 36 || ConMD == 38) ? "04" : "05", id++, 0, MECHA_TASK_NORMAL_TO, "DEFAULT TRAY");
-    }
-
-    for (i = 0; data[i].type != 0xFF; i++, id++)
-    {
-        if (forceUpdate || EEPMapRead(data[i].word) != data[i].data)
-        {
-            AddUpdateItem(data[i].word, data[i].data, id);
-            UpdateStat |= data[i].type;
-        }
-    }
-    if (forceUpdate || ConECR != 0x19)
-    {
-        MechaCommandAdd(MECHA_CMD_ECR_WRITE, "19", id++, 0, MECHA_TASK_NORMAL_TO, "ECR WRITE");
-        UpdateStat |= UPDATE_REGION_ECR;
-    }
-
-#ifdef UPDATE_RTC_NEW
-    if (pstrincmp("3088", RTCData, 4))
-    {
-        strcpy(RTCData, "3088");
-        MechaGetTimeString(&RTCData[4]);
-        MechaCommandAdd(MECHA_CMD_RTC_WRITE, RTCData, id++, 0, MECHA_TASK_NORMAL_TO, "RTC WRITE");
-        UpdateStat |= (UPDATE_REGION_RTC | UPDATE_REGION_RTC_CTL12 | UPDATE_REGION_RTC_TIME);
-    }
-#else
-    if (!pstrincmp("30C8", RTCData, 4))
-    {
-        strncpy(RTCData, "3088", 4);
-        MechaCommandAdd(MECHA_CMD_RTC_WRITE, RTCData, id++, 0, MECHA_TASK_NORMAL_TO, "RTC WRITE");
-        UpdateStat |= (UPDATE_REGION_RTC | UPDATE_REGION_RTC_CTL12);
-    }
-    else if (pstrincmp("3088", RTCData, 4))
-    {
-        strcpy(RTCData, "308801151803258401");
-        MechaCommandAdd(MECHA_CMD_RTC_WRITE, RTCData, id++, 0, MECHA_TASK_NORMAL_TO, "RTC WRITE");
-        UpdateStat |= (UPDATE_REGION_RTC | UPDATE_REGION_RTC_CTL12 | UPDATE_REGION_RTC_TIME);
-    }
-#endif
-
-    if (MechaAddPostUpdateCmds(0, id) != 0)
-    {
-        MechaCommandListClear();
-        return 0;
-    }
-
-    return UpdateStat;
-}
-
-int MechaUpdateChassisDexA2(int ClearOSD2InitBit, int ReplacedMecha, int lens, int opt)
-{
-    unsigned short int UpdateStat;
-    unsigned char forceUpdate, i, id;
-    const struct UpdateData data[] = {
-        {EEPROM_MAP_ECR, 0x0019, UPDATE_REGION_EEP_ECR},
-        {0x00f1, 0x0f38, UPDATE_REGION_TRAY},
-        {0x00f2, 0x1e47, UPDATE_REGION_TRAY},
-        {0x00f3, 0x5626, UPDATE_REGION_TRAY},
-        {0x00f4, 0x6b27, UPDATE_REGION_TRAY},
-        {0x00f9, 0x9038, UPDATE_REGION_TRAY},
-        {0x00f5, 0x0029, UPDATE_REGION_TRAY},
-        {0x00f6, 0x1929, UPDATE_REGION_TRAY},
-        {0x00f7, 0x6013, UPDATE_REGION_TRAY},
-        {0x00f8, 0x7029, UPDATE_REGION_TRAY},
-        {0xFFFF, 0xFFFF, 0xFF}};
-
-    id          = 1;
-    UpdateStat  = 0;
-    forceUpdate = (ReplacedMecha || ConChecksumStat == 0 || lens != ConLens);
-    if (forceUpdate)
-    {
-        UpdateStat |= UPDATE_REGION_DEFAULTS;
-        MechaCommandAdd(MECHA_CMD_CLEAR_CONF, "02", id++, 0, MECHA_TASK_NORMAL_TO, "DEFAULT DISC DETECT");
-        MechaCommandAdd(MECHA_CMD_CLEAR_CONF, "03", id++, 0, MECHA_TASK_NORMAL_TO, "DEFAULT SERVO");
-        MechaCommandAdd(MECHA_CMD_CLEAR_CONF, (ConMD == 36 || ConMD == 38) ? "04" : "05", id++, 0, MECHA_TASK_NORMAL_TO, "DEFAULT TRAY");
-    }
-
-    for (i = 0; data[i].type != 0xFF; i++, id++)
-    {
-        if (forceUpdate || EEPMapRead(data[i].word) != data[i].data)
-        {
-            AddUpdateItem(data[i].word, data[i].data, id);
-            UpdateStat |= data[i].type;
-        }
-    }
-    if (forceUpdate || ConECR != 0x19)
-    {
-        MechaCommandAdd(MECHA_CMD_ECR_WRITE, "19", id++, 0, MECHA_TASK_NORMAL_TO, "ECR WRITE");
-        UpdateStat |= UPDATE_REGION_ECR;
-    }
-
-#ifdef UPDATE_RTC_NEW
-    if (pstrincmp("3088", RTCData, 4))
-    {
-        strcpy(RTCData, "3088");
-        MechaGetTimeString(&RTCData[4]);
-        MechaCommandAdd(MECHA_CMD_RTC_WRITE, RTCData, id++, 0, MECHA_TASK_NORMAL_TO, "RTC WRITE");
-        UpdateStat |= (UPDATE_REGION_RTC | UPDATE_REGION_RTC_CTL12 | UPDATE_REGION_RTC_TIME);
-    }
-#else
-    if (!pstrincmp("30C8", RTCData, 4))
-    {
-        strncpy(RTCData, "3088", 4);
-        MechaCommandAdd(MECHA_CMD_RTC_WRITE, RTCData, id++, 0, MECHA_TASK_NORMAL_TO, "RTC WRITE");
-        UpdateStat |= (UPDATE_REGION_RTC | UPDATE_REGION_RTC_CTL12);
-    }
-    else if (pstrincmp("3088", RTCData, 4))
-    {
-        strcpy(RTCData, "308801151803258401");
-        MechaCommandAdd(MECHA_CMD_RTC_WRITE, RTCData, id++, 0, MECHA_TASK_NORMAL_TO, "RTC WRITE");
-        UpdateStat |= (UPDATE_REGION_RTC | UPDATE_REGION_RTC_CTL12 | UPDATE_REGION_RTC_TIME);
-    }
-#endif
-
-    if (MechaAddPostUpdateCmds(0, id) != 0)
-    {
-        MechaCommandListClear();
-        return 0;
-    }
-
-    return UpdateStat;
-}
-
-int MechaUpdateChassisDexA3(int ClearOSD2InitBit, int ReplacedMecha, int lens, int opt)
-{
-    unsigned short int UpdateStat;
-    unsigned char forceUpdate, i, id;
-    const struct UpdateData data[] = {
-        {EEPROM_MAP_ECR, 0x0019, UPDATE_REGION_EEP_ECR},
-        {EEPROM_MAP_FOK, 0xb2a0, UPDATE_REGION_SERVO},
-        {0x002e, 0x213a, UPDATE_REGION_SERVO},
-        {0x0032, 0x0a0a, UPDATE_REGION_SERVO},
-        {0x002d, 0x5005, UPDATE_REGION_SERVO},
-        {0x00f1, 0x0f38, UPDATE_REGION_TRAY},
-        {0x00f2, 0x1e47, UPDATE_REGION_TRAY},
-        {0x00f3, 0x5626, UPDATE_REGION_TRAY},
-        {0x00f4, 0x6b27, UPDATE_REGION_TRAY},
-        {0x00f9, 0x9038, UPDATE_REGION_TRAY},
-        {0x00fa, 0x0012, UPDATE_REGION_TRAY},
-        {0x00f5, 0x0029, UPDATE_REGION_TRAY},
-        {0x00f6, 0x1929, UPDATE_REGION_TRAY},
-        {0x00f7, 0x6013, UPDATE_REGION_TRAY},
-        {0x00f8, 0x7029, UPDATE_REGION_TRAY},
-        {0xFFFF, 0xFFFF, 0xFF}};
-
-    id          = 1;
-    UpdateStat  = 0;
-    forceUpdate = (ReplacedMecha || ConChecksumStat == 0 || lens != ConLens);
-    if (forceUpdate)
-    {
-        UpdateStat |= UPDATE_REGION_DEFAULTS;
-        MechaCommandAdd(MECHA_CMD_CLEAR_CONF, "02", id++, 0, MECHA_TASK_NORMAL_TO, "DEFAULT DISC DETECT");
-        MechaCommandAdd(MECHA_CMD_CLEAR_CONF, "03", id++, 0, MECHA_TASK_NORMAL_TO, "DEFAULT SERVO");
-        MechaCommandAdd(MECHA_CMD_CLEAR_CONF, (ConMD == 36 || ConMD == 38) ? "04" : "05", id++, 0, MECHA_TASK_NORMAL_TO, "DEFAULT TRAY");
-    }
-
-    for (i = 0; data[i].type != 0xFF; i++, id++)
-    {
-        if (forceUpdate || EEPMapRead(data[i].word) != data[i].data)
-        {
-            AddUpdateItem(data[i].word, data[i].data, id);
-            UpdateStat |= data[i].type;
-        }
-    }
-    if (forceUpdate || ConECR != 0x19)
-    {
-        MechaCommandAdd(MECHA_CMD_ECR_WRITE, "19", id++, 0, MECHA_TASK_NORMAL_TO, "ECR WRITE");
-        UpdateStat |= UPDATE_REGION_ECR;
-    }
-
-#ifdef UPDATE_RTC_NEW
-    if (pstrincmp("3088", RTCData, 4))
-    {
-        strcpy(RTCData, "3088");
-        MechaGetTimeString(&RTCData[4]);
-        MechaCommandAdd(MECHA_CMD_RTC_WRITE, RTCData, id++, 0, MECHA_TASK_NORMAL_TO, "RTC WRITE");
-        UpdateStat |= (UPDATE_REGION_RTC | UPDATE_REGION_RTC_CTL12 | UPDATE_REGION_RTC_TIME);
-    }
-#else
-    if (!pstrincmp("30C8", RTCData, 4))
-    {
-        strncpy(RTCData, "3088", 4);
-        MechaCommandAdd(MECHA_CMD_RTC_WRITE, RTCData, id++, 0, MECHA_TASK_NORMAL_TO, "RTC WRITE");
-        UpdateStat |= (UPDATE_REGION_RTC | UPDATE_REGION_RTC_CTL12);
-    }
-    else if (pstrincmp("3088", RTCData, 4))
-    {
-        strcpy(RTCData, "308801151803258401");
-        MechaCommandAdd(MECHA_CMD_RTC_WRITE, RTCData, id++, 0, MECHA_TASK_NORMAL_TO, "RTC WRITE");
-        UpdateStat |= (UPDATE_REGION_RTC | UPDATE_REGION_RTC_CTL12 | UPDATE_REGION_RTC_TIME);
-    }
-#endif
-
-    if (MechaAddPostUpdateCmds(0, id) != 0)
-    {
-        MechaCommandListClear();
-        return 0;
-    }
-
-    return UpdateStat;
-}
-
-int MechaUpdateChassisDexB(int ClearOSD2InitBit, int ReplacedMecha, int lens, int opt)
-{
-    unsigned short int UpdateStat;
-    unsigned char forceUpdate, i, id;
-    const struct UpdateData data[] = {
-        {EEPROM_MAP_CON, MECHA_CHASSIS_DEX_B, UPDATE_REGION_SERVO},
-        {0x0026, 0x0e06, UPDATE_REGION_SERVO},
-        {EEPROM_MAP_ECR, 0x0015, UPDATE_REGION_EEP_ECR},
-        {0x00c0, 0x003e, UPDATE_REGION_TILT},
-        {0x00c1, 0x1430, UPDATE_REGION_TILT},
-        {0x00c2, 0x1167, UPDATE_REGION_TILT},
-        {0x00c3, 0x012c, UPDATE_REGION_TILT},
-        {0x00c4, 0x2805, UPDATE_REGION_TILT},
-        {0x0140, 0x0001, UPDATE_REGION_EEGS},
-        {0x0147, 0x0100, UPDATE_REGION_EEGS},
-        {0xFFFF, 0xFFFF, 0xFF}};
-
-    id          = 1;
-    UpdateStat  = 0;
-    forceUpdate = (ReplacedMecha || ConChecksumStat == 0 || lens != ConLens);
-    if (forceUpdate)
-    {
-        UpdateStat |= UPDATE_REGION_DEFAULTS;
-        MechaCommandAdd(MECHA_CMD_CLEAR_CONF, "02", id++, 0, MECHA_TASK_NORMAL_TO, "DEFAULT DISC DETECT");
-        MechaCommandAdd(MECHA_CMD_CLEAR_CONF, "03", id++, 0, MECHA_TASK_NORMAL_TO, "DEFAULT SERVO");
-        MechaCommandAdd(MECHA_CMD_CLEAR_CONF, "04", id++, 0, MECHA_TASK_NORMAL_TO, "DEFAULT TILT");
-        MechaCommandAdd(MECHA_CMD_CLEAR_CONF, "05", id++, 0, MECHA_TASK_NORMAL_TO, "DEFAULT TRAY");
-    }
-
-    for (i = 0; data[i].type != 0xFF; i++, id++)
-    {
-        if (forceUpdate || EEPMapRead(data[i].word) != data[i].data)
-        {
-            AddUpdateItem(data[i].word, data[i].data, id);
-            UpdateStat |= data[i].type;
-        }
-    }
-    if (forceUpdate || ConECR != 0x15)
-    {
-        MechaCommandAdd(MECHA_CMD_ECR_WRITE, "15", id++, 0, MECHA_TASK_NORMAL_TO, "ECR WRITE");
-        UpdateStat |= UPDATE_REGION_ECR;
-    }
-
-#ifdef UPDATE_RTC_NEW
-    if (pstrincmp("3088", RTCData, 4))
-    {
-        strcpy(RTCData, "3088");
-        MechaGetTimeString(&RTCData[4]);
-        MechaCommandAdd(MECHA_CMD_RTC_WRITE, RTCData, id++, 0, MECHA_TASK_NORMAL_TO, "RTC WRITE");
-        UpdateStat |= (UPDATE_REGION_RTC | UPDATE_REGION_RTC_CTL12 | UPDATE_REGION_RTC_TIME);
-    }
-#else
-    if (!pstrincmp("30C8", RTCData, 4))
-    {
-        strncpy(RTCData, "3088", 4);
-        MechaCommandAdd(MECHA_CMD_RTC_WRITE, RTCData, id++, 0, MECHA_TASK_NORMAL_TO, "RTC WRITE");
-        UpdateStat |= (UPDATE_REGION_RTC | UPDATE_REGION_RTC_CTL12);
-    }
-    else if (pstrincmp("3088", RTCData, 4))
-    {
-        strcpy(RTCData, "308801151803258401");
-        MechaCommandAdd(MECHA_CMD_RTC_WRITE, RTCData, id++, 0, MECHA_TASK_NORMAL_TO, "RTC WRITE");
-        UpdateStat |= (UPDATE_REGION_RTC | UPDATE_REGION_RTC_CTL12 | UPDATE_REGION_RTC_TIME);
-    }
-#endif
-
-    if (MechaAddPostUpdateCmds(ClearOSD2InitBit, id) != 0)
-    {
-        MechaCommandListClear();
-        return 0;
-    }
-
-    return UpdateStat;
-}
-
-int MechaUpdateChassisDexD(int ClearOSD2InitBit, int ReplacedMecha, int lens, int opt)
-{
-    unsigned short int UpdateStat;
-    unsigned char forceUpdate, i, id;
-    const struct UpdateData data[] = {
-        {0x0013, 0x6f5f, UPDATE_REGION_SERVO},
-        {EEPROM_MAP_ECR, 0x0013, UPDATE_REGION_EEP_ECR},
-        {0x0140, 0x0001, UPDATE_REGION_EEGS},
-        {0x0147, 0x0100, UPDATE_REGION_EEGS},
-        {0xFFFF, 0xFFFF, 0xFF}};
-
-    id          = 1;
-    UpdateStat  = 0;
-    forceUpdate = (ReplacedMecha || ConChecksumStat == 0 || lens != ConLens);
-    if (forceUpdate)
-    {
-        UpdateStat |= UPDATE_REGION_DEFAULTS;
-        MechaCommandAdd(MECHA_CMD_CLEAR_CONF, "02", id++, 0, MECHA_TASK_NORMAL_TO, "DEFAULT DISC DETECT");
-        MechaCommandAdd(MECHA_CMD_CLEAR_CONF, "03", id++, 0, MECHA_TASK_NORMAL_TO, "DEFAULT SERVO");
-        MechaCommandAdd(MECHA_CMD_CLEAR_CONF, "05", id++, 0, MECHA_TASK_NORMAL_TO, "DEFAULT TRAY");
-    }
-
-    for (i = 0; data[i].type != 0xFF; i++, id++)
-    {
-        if (forceUpdate || EEPMapRead(data[i].word) != data[i].data)
-        {
-            AddUpdateItem(data[i].word, data[i].data, id);
-            UpdateStat |= data[i].type;
-        }
-    }
-
-    if (forceUpdate || ConECR != 0x13)
-    {
-        MechaCommandAdd(MECHA_CMD_ECR_WRITE, "13", id++, 0, MECHA_TASK_NORMAL_TO, "ECR WRITE");
-        UpdateStat |= UPDATE_REGION_ECR;
-    }
-
-#ifdef UPDATE_RTC_NEW
-    if (pstrincmp("3088", RTCData, 4))
-    {
-        strcpy(RTCData, "3088");
-        MechaGetTimeString(&RTCData[4]);
-        MechaCommandAdd(MECHA_CMD_RTC_WRITE, RTCData, id++, 0, MECHA_TASK_NORMAL_TO, "RTC WRITE");
-        UpdateStat |= (UPDATE_REGION_RTC | UPDATE_REGION_RTC_CTL12 | UPDATE_REGION_RTC_TIME);
-    }
-#else
-    if (!pstrincmp("30C8", RTCData, 4))
-    {
-        strncpy(RTCData, "3088", 4);
-        MechaCommandAdd(MECHA_CMD_RTC_WRITE, RTCData, id++, 0, MECHA_TASK_NORMAL_TO, "RTC WRITE");
-        UpdateStat |= (UPDATE_REGION_RTC | UPDATE_REGION_RTC_CTL12);
-    }
-    else if (pstrincmp("3088", RTCData, 4))
-    {
-        strcpy(RTCData, "308801151803258401");
-        MechaCommandAdd(MECHA_CMD_RTC_WRITE, RTCData, id++, 0, MECHA_TASK_NORMAL_TO, "RTC WRITE");
-        UpdateStat |= (UPDATE_REGION_RTC | UPDATE_REGION_RTC_CTL12 | UPDATE_REGION_RTC_TIME);
-    }
-#endif
-
-    if (MechaAddPostUpdateCmds(ClearOSD2InitBit, id) != 0)
-    {
-        MechaCommandListClear();
-        return 0;
-    }
-
-    return UpdateStat;
-}
-
-// Note: EEPROM regions may not be labelled correctly because the data was extracted from the March 2003 ELECT tool (which does not give this information).
-int MechaUpdateChassisH(int ClearOSD2InitBit, int ReplacedMecha, int lens, int opt)
+static int UpdatePostH(struct UpdateContext *ctx)
 {
-    unsigned short int UpdateStat;
-    unsigned char forceUpdate, i, id;
-    const struct UpdateData data[] = {
-        {0x0019, 0xa640, UPDATE_REGION_SERVO},
-        {0x003c, 0x703c, UPDATE_REGION_SERVO},
-        {0x006f, 0x8f8f, UPDATE_REGION_SERVO},
-        {0x007e, 0x8c8a, UPDATE_REGION_SERVO},
-        {0xFFFF, 0xFFFF, 0xFF}};
-
-    id          = 1;
-    UpdateStat  = 0;
-    forceUpdate = (ReplacedMecha || ConChecksumStat == 0 || lens != ConLens);
-    if (forceUpdate)
-    {
-        UpdateStat |= UPDATE_REGION_DEFAULTS;
-        MechaCommandAdd(MECHA_CMD_CLEAR_CONF, "02", id++, 0, MECHA_TASK_NORMAL_TO, "DEFAULT FIXED DATA");
-        MechaCommandAdd(MECHA_CMD_CLEAR_CONF, "03", id++, 0, MECHA_TASK_NORMAL_TO, "DEFAULT VAL DATA");
-        MechaCommandAdd(MECHA_CMD_CLEAR_CONF, "04", id++, 0, MECHA_TASK_NORMAL_TO, "DEFAULT TRAY");
-        if (opt == MECHA_OP_SANYO)
-            MechaCommandAdd(MECHA_CMD_SETUP_SANYO, NULL, id++, 0, MECHA_TASK_NORMAL_TO, "SANYO DEFAULTS");
-    }
-
-    for (i = 0; data[i].type != 0xFF; i++, id++)
-    {
-        if (forceUpdate || EEPMapRead(data[i].word) != data[i].data)
-        {
-            AddUpdateItem(data[i].word, data[i].data, id);
-            UpdateStat |= data[i].type;
-        }
-    }
-    // BU9861FV-WE2
-    if (forceUpdate || ConECR != 0x00)
-    {
-        MechaCommandAdd(MECHA_CMD_ECR_WRITE, "00", id++, 0, MECHA_TASK_NORMAL_TO, "ECR WRITE");
-        UpdateStat |= UPDATE_REGION_ECR;
-    }
-
-    if (pstrincmp("3000", RTCData, 4))
-    {
-#ifdef UPDATE_RTC_NEW
-        strcpy(RTCData, "3000");
-        MechaGetTimeString(&RTCData[4]);
-#else
-        strcpy(RTCData, "300001431800221001");
-#endif
-        MechaCommandAdd(MECHA_CMD_RTC_WRITE, RTCData, id++, 0, MECHA_TASK_NORMAL_TO, "RTC WRITE");
-        UpdateStat |= (UPDATE_REGION_RTC | UPDATE_REGION_RTC_CTL12 | UPDATE_REGION_RTC_TIME);
-    }
     MechaCommandAdd(MECHA_TASK_UI_CMD_WAIT, NULL, MECHA_TASK_ID_UI, 0, 100, "WAIT 100ms");
     if (!pstrincmp(MechaName, "000405", 6))
-    { // The data here seems to appear at the end of the EEPROM (+0x320).
-        MechaCommandAdd(MECHA_CMD_CFA, "00b1ea8bc0c8198435", id++, 0, MECHA_TASK_NORMAL_TO, "PCEA1240");
-        MechaCommandAdd(MECHA_CMD_CFA, "0103dccd7dd383ff90", id++, 0, MECHA_TASK_NORMAL_TO, "PCEA1240");
-        MechaCommandAdd(MECHA_CMD_CFA, "02a6848324ddf69aeb", id++, 0, MECHA_TASK_NORMAL_TO, "PCEA1240");
-        MechaCommandAdd(MECHA_CMD_CFA, "0303dccd7dd383ff90", id++, 0, MECHA_TASK_NORMAL_TO, "PCEA1240");
-        MechaCommandAdd(MECHA_CMD_CFA, "04617d23a351054e8c", id++, 0, MECHA_TASK_NORMAL_TO, "PCEA1240");
-        MechaCommandAdd(MECHA_CMD_CFA, "0503dccd7dd383ff90", id++, 0, MECHA_TASK_NORMAL_TO, "PCEA1240");
-        MechaCommandAdd(MECHA_CMD_CFA, "062ea7ea3314ad99d4", id++, 0, MECHA_TASK_NORMAL_TO, "PCEA1240");
-        MechaCommandAdd(MECHA_CMD_CFA, "075da60dccd71b3d78", id++, 0, MECHA_TASK_NORMAL_TO, "PCEA1240");
-        MechaCommandAdd(MECHA_CMD_CFA, "08cb2751b48540f096", id++, 0, MECHA_TASK_NORMAL_TO, "PCEA1240");
-        MechaCommandAdd(MECHA_CMD_CFA, "09b6daef699d964b9c", id++, 0, MECHA_TASK_NORMAL_TO, "PCEA1240");
-        MechaCommandAdd(MECHA_CMD_CFA, "0a956d23a4e123571c", id++, 0, MECHA_TASK_NORMAL_TO, "PCEA1240");
-        MechaCommandAdd(MECHA_CMD_CFA, "0bce8ed32f1cc6554b", id++, 0, MECHA_TASK_NORMAL_TO, "PCEA1240");
-        MechaCommandAdd(MECHA_CMD_CFA, "0ccdfb5aefd39b3ad8", id++, 0, MECHA_TASK_NORMAL_TO, "PCEA1240");
-        MechaCommandAdd(MECHA_CMD_CFA, "0db4899cb772970027", id++, 0, MECHA_TASK_NORMAL_TO, "PCEA1240");
-        MechaCommandAdd(MECHA_CMD_CFA, "0ebadf03dccd7dd383", id++, 0, MECHA_TASK_NORMAL_TO, "PCEA1240");
-        MechaCommandAdd(MECHA_CMD_CFA, "0fe6e874df39d0d517", id++, 0, MECHA_TASK_NORMAL_TO, "PCEA1240");
-        MechaCommandAdd(MECHA_CMD_CFA, "1088ccb01b751b05a5", id++, 0, MECHA_TASK_NORMAL_TO, "PCEA1240");
-        MechaCommandAdd(MECHA_CMD_CFA, "11d621b070d9a5768b", id++, 0, MECHA_TASK_NORMAL_TO, "PCEA1240");
-        MechaCommandAdd(MECHA_CMD_CFA, "1224b6090c6547f105", id++, 0, MECHA_TASK_NORMAL_TO, "PCEA1240");
-        MechaCommandAdd(MECHA_CMD_CFA, "137cd2b18287ff3da3", id++, 0, MECHA_TASK_NORMAL_TO, "PCEA1240");
-        MechaCommandAdd(MECHA_CMD_CFA, "14fced984b964ff83f", id++, 0, MECHA_TASK_NORMAL_TO, "PCEA1240");
-        MechaCommandAdd(MECHA_CMD_CFA, "15327cfa386b13c769", id++, 0, MECHA_TASK_NORMAL_TO, "PCEA1240");
-        MechaCommandAdd(MECHA_CMD_CFA, "169a24b37564c23965", id++, 0, MECHA_TASK_NORMAL_TO, "PCEA1240");
-        MechaCommandAdd(MECHA_CMD_CFA, "172d432c30153d01b2", id++, 0, MECHA_TASK_NORMAL_TO, "PCEA1240");
-        MechaCommandAdd(MECHA_CMD_CFA, "187d3464661f675020", id++, 0, MECHA_TASK_NORMAL_TO, "PCEA1240");
-        MechaCommandAdd(MECHA_CMD_CFA, "19c8b413bdc93098fe", id++, 0, MECHA_TASK_NORMAL_TO, "PCEA1240");
-        MechaCommandAdd(MECHA_CMD_CFA, "1ae2e723073e3a51d2", id++, 0, MECHA_TASK_NORMAL_TO, "PCEA1240");
-        MechaCommandAdd(MECHA_CMD_CFA, "1bff90b77afdff00e3", id++, 0, MECHA_TASK_NORMAL_TO, "PCEA1240");
-    }
-    if (MechaAddPostUpdateCmds(ClearOSD2InitBit, id) != 0)
-    {
-        MechaCommandListClear();
-        return 0;
-    }
+        UpdateAddPCEA1240(ctx, PCEA1240H);
 
-    return UpdateStat;
+    return 0;
 }
 
-int MechaUpdateChassisDexH(int ClearOSD2InitBit, int ReplacedMecha, int lens, int opt)
+static int UpdatePostDexH(struct UpdateContext *ctx)
 {
-    unsigned short int UpdateStat;
-    unsigned char forceUpdate, i, id;
-    const struct UpdateData data[] = {
-        {0x0019, 0xa640, UPDATE_REGION_SERVO},
-        {0x003c, 0x703c, UPDATE_REGION_SERVO},
-        {0x006f, 0x8f8f, UPDATE_REGION_SERVO},
-        {0x007e, 0x8c8a, UPDATE_REGION_SERVO},
-        {0xFFFF, 0xFFFF, 0xFF}};
-
-    id          = 1;
-    UpdateStat  = 0;
-    forceUpdate = (ReplacedMecha || ConChecksumStat == 0 || lens != ConLens);
-    if (forceUpdate)
-    {
-        UpdateStat |= UPDATE_REGION_DEFAULTS;
-        MechaCommandAdd(MECHA_CMD_CLEAR_CONF, "02", id++, 0, MECHA_TASK_NORMAL_TO, "DEFAULT FIXED DATA");
-        MechaCommandAdd(MECHA_CMD_CLEAR_CONF, "03", id++, 0, MECHA_TASK_NORMAL_TO, "DEFAULT VAL DATA");
-        MechaCommandAdd(MECHA_CMD_CLEAR_CONF, "04", id++, 0, MECHA_TASK_NORMAL_TO, "DEFAULT TRAY");
-        if (opt == MECHA_OP_SANYO)
-            MechaCommandAdd(MECHA_CMD_SETUP_SANYO, NULL, id++, 0, MECHA_TASK_NORMAL_TO, "SANYO DEFAULTS");
-    }
+    if (!pstrincmp(MechaName, "000505", 6))
+        UpdateAddPCEA1240(ctx, PCEA1240DexH);
 
-    for (i = 0; data[i].type != 0xFF; i++, id++)
-    {
-        if (forceUpdate || EEPMapRead(data[i].word) != data[i].data)
-        {
-            AddUpdateItem(data[i].word, data[i].data, id);
-            UpdateStat |= data[i].type;
-        }
-    }
-    // BU9861FV-WE2
-    if (forceUpdate || ConECR != 0x00)
-    {
-        MechaCommandAdd(MECHA_CMD_ECR_WRITE, "00", id++, 0, MECHA_TASK_NORMAL_TO, "ECR WRITE");
-        UpdateStat |= UPDATE_REGION_ECR;
-    }
+    return 0;
+}
 
-    if (pstrincmp("3000", RTCData, 4))
-    {
-#ifdef UPDATE_RTC_NEW
-        strcpy(RTCData, "3000");
-        MechaGetTimeString(&RTCData[4]);
-#else
-        strcpy(RTCData, "300001431800221001");
-#endif
-        MechaCommandAdd(MECHA_CMD_RTC_WRITE, RTCData, id++, 0, MECHA_TASK_NORMAL_TO, "RTC WRITE");
-        UpdateStat |= (UPDATE_REGION_RTC | UPDATE_REGION_RTC_CTL12 | UPDATE_REGION_RTC_TIME);
-    }
-    if (!pstrincmp(MechaName, "000505", 6))
-    { // Something here checks for 0x19, 0x1A, 0x1B and 0x1C. If it's any of those, then the codes for the CEX H-chassis are used instead.
-        // No idea what it actually checks for because the UI doesn't seem to set it (always 0xFFFFFFFF).
-        // The data here seems to appear at the very end of the EEPROM (+0x320)
-        MechaCommandAdd(MECHA_CMD_CFA, "0003dccd7dd383ff90", id++, 0, MECHA_TASK_NORMAL_TO, "PCEA1240");
-        MechaCommandAdd(MECHA_CMD_CFA, "0103dccd7dd383ff90", id++, 0, MECHA_TASK_NORMAL_TO, "PCEA1240");
-        MechaCommandAdd(MECHA_CMD_CFA, "02ffffffffffffffff", id++, 0, MECHA_TASK_NORMAL_TO, "PCEA1240");
-        MechaCommandAdd(MECHA_CMD_CFA, "03ffffffffffffffff", id++, 0, MECHA_TASK_NORMAL_TO, "PCEA1240");
-        MechaCommandAdd(MECHA_CMD_CFA, "04ffffffffffffffff", id++, 0, MECHA_TASK_NORMAL_TO, "PCEA1240");
-        MechaCommandAdd(MECHA_CMD_CFA, "05ffffffffffffffff", id++, 0, MECHA_TASK_NORMAL_TO, "PCEA1240");
-        MechaCommandAdd(MECHA_CMD_CFA, "06ffffffffffffffff", id++, 0, MECHA_TASK_NORMAL_TO, "PCEA1240");
-        MechaCommandAdd(MECHA_CMD_CFA, "07ffffffffffffffff", id++, 0, MECHA_TASK_NORMAL_TO, "PCEA1240");
-        MechaCommandAdd(MECHA_CMD_CFA, "08ffffffffffffffff", id++, 0, MECHA_TASK_NORMAL_TO, "PCEA1240");
-        MechaCommandAdd(MECHA_CMD_CFA, "09ffffffffffffffff", id++, 0, MECHA_TASK_NORMAL_TO, "PCEA1240");
-        MechaCommandAdd(MECHA_CMD_CFA, "0affffffffffffffff", id++, 0, MECHA_TASK_NORMAL_TO, "PCEA1240");
-        MechaCommandAdd(MECHA_CMD_CFA, "0bffffffffffffffff", id++, 0, MECHA_TASK_NORMAL_TO, "PCEA1240");
-        MechaCommandAdd(MECHA_CMD_CFA, "0cffffffffffffffff", id++, 0, MECHA_TASK_NORMAL_TO, "PCEA1240");
-        MechaCommandAdd(MECHA_CMD_CFA, "0dffffffffffffffff", id++, 0, MECHA_TASK_NORMAL_TO, "PCEA1240");
-        MechaCommandAdd(MECHA_CMD_CFA, "0effffffffffffffff", id++, 0, MECHA_TASK_NORMAL_TO, "PCEA1240");
-        MechaCommandAdd(MECHA_CMD_CFA, "0fffffffffffffffff", id++, 0, MECHA_TASK_NORMAL_TO, "PCEA1240");
-        MechaCommandAdd(MECHA_CMD_CFA, "10ffffffffffffffff", id++, 0, MECHA_TASK_NORMAL_TO, "PCEA1240");
-        MechaCommandAdd(MECHA_CMD_CFA, "11ffffffffffffffff", id++, 0, MECHA_TASK_NORMAL_TO, "PCEA1240");
-        MechaCommandAdd(MECHA_CMD_CFA, "12ffffffffffffffff", id++, 0, MECHA_TASK_NORMAL_TO, "PCEA1240");
-        MechaCommandAdd(MECHA_CMD_CFA, "13ffffffffffffffff", id++, 0, MECHA_TASK_NORMAL_TO, "PCEA1240");
-        MechaCommandAdd(MECHA_CMD_CFA, "14ffffffffffffffff", id++, 0, MECHA_TASK_NORMAL_TO, "PCEA1240");
-        MechaCommandAdd(MECHA_CMD_CFA, "15ffffffffffffffff", id++, 0, MECHA_TASK_NORMAL_TO, "PCEA1240");
-        MechaCommandAdd(MECHA_CMD_CFA, "16ffffffffffffffff", id++, 0, MECHA_TASK_NORMAL_TO, "PCEA1240");
-        MechaCommandAdd(MECHA_CMD_CFA, "17ffffffffffffffff", id++, 0, MECHA_TASK_NORMAL_TO, "PCEA1240");
-        MechaCommandAdd(MECHA_CMD_CFA, "18ffffffffffffffff", id++, 0, MECHA_TASK_NORMAL_TO, "PCEA1240");
-        MechaCommandAdd(MECHA_CMD_CFA, "19ffffffffffffffff", id++, 0, MECHA_TASK_NORMAL_TO, "PCEA1240");
-        MechaCommandAdd(MECHA_CMD_CFA, "1affffffffffffffff", id++, 0, MECHA_TASK_NORMAL_TO, "PCEA1240");
-        MechaCommandAdd(MECHA_CMD_CFA, "1bffffffffffffffff", id++, 0, MECHA_TASK_NORMAL_TO, "PCEA1240");
-    }
-    if (MechaAddPostUpdateCmds(ClearOSD2InitBit, id) != 0)
-    {
-        MechaCommandListClear();
-        return 0;
-    }
+// Defaults
+static const struct UpdateCommand DefaultsStd[] = {
+    {MECHA_CMD_CLEAR_CONF, "02", "DEFAULT DISC DETECT"},
+    {MECHA_CMD_CLEAR_CONF, "03", "DEFAULT SERVO"},
+    {MECHA_CMD_CLEAR_CONF, "05", "DEFAULT TRAY"},
+    {0, NULL, NULL}};
+
+static const struct UpdateCommand DefaultsA[] = {
+    {MECHA_CMD_CLEAR_CONF, "02", "DEFAULT DISC DETECT"},
+    {MECHA_CMD_CLEAR_CONF, "03", "DEFAULT SERVO"},
+    {MECHA_CMD_CLEAR_CONF, "04", "DEFAULT TRAY", UPDATE_IF_MD36_38},
+    {MECHA_CMD_CLEAR_CONF, "05", "DEFAULT TRAY", UPDATE_IF_NOT_MD36_38},
+    {0, NULL, NULL}};
+
+static const struct UpdateCommand DefaultsB[] = {
+    {MECHA_CMD_CLEAR_CONF, "02", "DEFAULT DISC DETECT"},
+    {MECHA_CMD_CLEAR_CONF, "03", "DEFAULT SERVO"},
+    {MECHA_CMD_CLEAR_CONF, "04", "DEFAULT TILT"},
+    {MECHA_CMD_CLEAR_CONF, "05", "DEFAULT TRAY"},
+    {0, NULL, NULL}};
+
+static const struct UpdateCommand DefaultsF[] = {
+    {MECHA_CMD_CLEAR_CONF, "02", "DEFAULT DISC DETECT"},
+    {MECHA_CMD_CLEAR_CONF, "03", "DEFAULT SERVO"},
+    {MECHA_CMD_CLEAR_CONF, "05", "DEFAULT TRAY"},
+    {MECHA_CMD_SETUP_SANYO, NULL, "297 SANYO DEFAULTS", UPDATE_IF_SANYO},
+    {0, NULL, NULL}};
+
+static const struct UpdateCommand DefaultsG[] = {
+    {MECHA_CMD_EEPROM_WRITE, "000effff", "EEPROM WRITE 0x00E -> 0xFFFF"},
+    {MECHA_CMD_CLEAR_CONF, "02", "DEFAULT DISC DETECT"},
+    {MECHA_CMD_CLEAR_CONF, "03", "DEFAULT SERVO"},
+    {MECHA_CMD_CLEAR_CONF, "05", "DEFAULT TRAY"},
+    {MECHA_CMD_SETUP_SANYO, NULL, "SANYO DEFAULTS", UPDATE_IF_SANYO},
+    {0, NULL, NULL}};
+
+static const struct UpdateCommand DefaultsH[] = {
+    {MECHA_CMD_CLEAR_CONF, "02", "DEFAULT FIXED DATA"},
+    {MECHA_CMD_CLEAR_CONF, "03", "DEFAULT VAL DATA"},
+    {MECHA_CMD_CLEAR_CONF, "04", "DEFAULT TRAY"},
+    {MECHA_CMD_SETUP_SANYO, NULL, "SANYO DEFAULTS", UPDATE_IF_SANYO},
+    {0, NULL, NULL}};
+
+// Update data
+static const struct UpdateData DataCex10000[] = {
+    {EEPROM_MAP_OPT_13, 0x7777, UPDATE_REGION_SERVO, UPDATE_IF_T487},
+    {EEPROM_MAP_OPT_12, 0x97c9, UPDATE_REGION_SERVO, UPDATE_IF_T487},
+    {0x0027, 0x0606, UPDATE_REGION_SERVO, UPDATE_IF_T487},
+    {EEPROM_MAP_OPT_13, 0x7777, UPDATE_REGION_SERVO, UPDATE_IF_T609K, 0x7878},
+    {EEPROM_MAP_OPT_12, 0x98c9, UPDATE_REGION_SERVO, UPDATE_IF_T609K},
+    {0x0027, 0x0606, UPDATE_REGION_SERVO, UPDATE_IF_T609K, 0x0808},
+    {EEPROM_MAP_CON, MECHA_CHASSIS_A, UPDATE_REGION_SERVO},
+    {0x0026, 0x0e0a, UPDATE_REGION_SERVO},
+    {EEPROM_MAP_ECR, 0x0019, UPDATE_REGION_EEP_ECR},
+    {0x0024, 0x4242, UPDATE_REGION_SERVO},
+    {EEPROM_MAP_FOK, 0x72a0, UPDATE_REGION_SERVO},
+    {0x002e, 0x213a, UPDATE_REGION_SERVO},
+    {0x0032, 0x0a0a, UPDATE_REGION_SERVO},
+    {0x0021, 0x1006, UPDATE_REGION_SERVO},
+    {0x0022, 0x1010, UPDATE_REGION_SERVO},
+    {0x0023, 0x4250, UPDATE_REGION_SERVO},
+    {0x0025, 0x4242, UPDATE_REGION_SERVO},
+    {0x002a, 0xe000, UPDATE_REGION_SERVO},
+    {0x002d, 0x5005, UPDATE_REGION_SERVO},
+    {0x00f1, 0x0f38, UPDATE_REGION_TRAY},
+    {0x00f2, 0x1e47, UPDATE_REGION_TRAY},
+    {0x00f3, 0x5626, UPDATE_REGION_TRAY},
+    {0x00f4, 0x6b27, UPDATE_REGION_TRAY},
+    {0x00f9, 0x9038, UPDATE_REGION_TRAY},
+    {0x00fa, 0x0012, UPDATE_REGION_TRAY},
+    {0x00f5, 0x0029, UPDATE_REGION_TRAY},
+    {0x00f6, 0x1929, UPDATE_REGION_TRAY},
+    {0x00f7, 0x6013, UPDATE_REGION_TRAY},
+    {0x00f8, 0x7029, UPDATE_REGION_TRAY},
+    {0x00fb, 0x0002, UPDATE_REGION_TRAY},
+    {0xFFFF, 0xFFFF, 0xFF}};
+
+static const struct UpdateData DataA[] = {
+    {EEPROM_MAP_OPT_13, 0x4f4f, UPDATE_REGION_SERVO, UPDATE_IF_T487},
+    {EEPROM_MAP_OPT_12, 0x4d8f, UPDATE_REGION_SERVO, UPDATE_IF_T487},
+    {0x0027, 0x0606, UPDATE_REGION_SERVO, UPDATE_IF_T487},
+    {EEPROM_MAP_OPT_13, 0x6f6f, UPDATE_REGION_SERVO, UPDATE_IF_T609K},
+    {EEPROM_MAP_OPT_12, 0x6d8f, UPDATE_REGION_SERVO, UPDATE_IF_T609K},
+    {0x0027, 0x0606, UPDATE_REGION_SERVO, UPDATE_IF_T609K, 0x0808},
+    {0x0026, 0x0e0a, UPDATE_REGION_SERVO},
+    {EEPROM_MAP_ECR, 0x0019, UPDATE_REGION_EEP_ECR},
+    {0x0024, 0x3000, UPDATE_REGION_SERVO},
+    {0x0038, 0x0000, UPDATE_REGION_SERVO},
+    {0x00f1, 0x0f38, UPDATE_REGION_TRAY},
+    {0x00f2, 0x1e47, UPDATE_REGION_TRAY},
+    {0x00f3, 0x5626, UPDATE_REGION_TRAY},
+    {0x00f4, 0x6b27, UPDATE_REGION_TRAY},
+    {0x00f9, 0x9038, UPDATE_REGION_TRAY},
+    {0x00f5, 0x0029, UPDATE_REGION_TRAY},
+    {0x00f6, 0x1929, UPDATE_REGION_TRAY},
+    {0x00f7, 0x6013, UPDATE_REGION_TRAY},
+    {0x00f8, 0x7029, UPDATE_REGION_TRAY},
+    {0x00fb, 0x0002, UPDATE_REGION_TRAY},
+    {0xFFFF, 0xFFFF, 0xFF}};
+
+// OPT_13 is not updated for the T487 on the AB, B and C-chassis.
+static const struct UpdateData DataAB[] = {
+    {EEPROM_MAP_OPT_12, 0x4d8f, UPDATE_REGION_SERVO, UPDATE_IF_T487},
+    {0x0027, 0x0606, UPDATE_REGION_SERVO, UPDATE_IF_T487},
+    {EEPROM_MAP_OPT_13, 0x6f6f, UPDATE_REGION_SERVO, UPDATE_IF_T609K},
+    {EEPROM_MAP_OPT_12, 0x6d8f, UPDATE_REGION_SERVO, UPDATE_IF_T609K},
+    {0x0027, 0x0606, UPDATE_REGION_SERVO, UPDATE_IF_T609K, 0x0808},
+    {EEPROM_MAP_CON, 0x0801, UPDATE_REGION_SERVO},
+    {EEPROM_MAP_ECR, 0x0019, UPDATE_REGION_EEP_ECR},
+    {0x00f1, 0x0f38, UPDATE_REGION_TRAY},
+    {0x00f2, 0x1e47, UPDATE_REGION_TRAY},
+    {0x00f3, 0x5626, UPDATE_REGION_TRAY},
+    {0x00f4, 0x6b27, UPDATE_REGION_TRAY},
+    {0x00f9, 0x9038, UPDATE_REGION_TRAY},
+    {0x00f5, 0x0029, UPDATE_REGION_TRAY},
+    {0x00f6, 0x1929, UPDATE_REGION_TRAY},
+    {0x00f7, 0x6013, UPDATE_REGION_TRAY},
+    {0x00f8, 0x7029, UPDATE_REGION_TRAY},
+    {0x00fb, 0x0002, UPDATE_REGION_TRAY},
+    {0xFFFF, 0xFFFF, 0xFF}};
+
+static const struct UpdateData DataB[] = {
+    {EEPROM_MAP_OPT_12, 0x4d8f, UPDATE_REGION_SERVO, UPDATE_IF_T487},
+    {0x0027, 0x0606, UPDATE_REGION_SERVO, UPDATE_IF_T487},
+    {EEPROM_MAP_OPT_13, 0x6f6f, UPDATE_REGION_SERVO, UPDATE_IF_T609K},
+    {EEPROM_MAP_OPT_12, 0x6d8f, UPDATE_REGION_SERVO, UPDATE_IF_T609K},
+    {0x0027, 0x0606, UPDATE_REGION_SERVO, UPDATE_IF_T609K, 0x0808},
+    {EEPROM_MAP_CON, MECHA_CHASSIS_B, UPDATE_REGION_SERVO},
+    {EEPROM_MAP_ECR, 0x0015, UPDATE_REGION_EEP_ECR},
+    {0x00c0, 0x003e, UPDATE_REGION_TILT},
+    {0x00c1, 0x1430, UPDATE_REGION_TILT},
+    {0x00c2, 0x1167, UPDATE_REGION_TILT},
+    {0x00c3, 0x012c, UPDATE_REGION_TILT},
+    {0x00c4, 0x2805, UPDATE_REGION_TILT},
+    {0xFFFF, 0xFFFF, 0xFF}};
+
+static const struct UpdateData DataC[] = {
+    {EEPROM_MAP_OPT_12, 0x4d8f, UPDATE_REGION_SERVO, UPDATE_IF_T487},
+    {0x0027, 0x0606, UPDATE_REGION_SERVO, UPDATE_IF_T487},
+    {EEPROM_MAP_OPT_13, 0x6f6f, UPDATE_REGION_SERVO, UPDATE_IF_T609K},
+    {EEPROM_MAP_OPT_12, 0x6d8f, UPDATE_REGION_SERVO, UPDATE_IF_T609K},
+    {0x0027, 0x0606, UPDATE_REGION_SERVO, UPDATE_IF_T609K, 0x0808},
+    {EEPROM_MAP_CON, MECHA_CHASSIS_BCD, UPDATE_REGION_SERVO},
+    {EEPROM_MAP_ECR, 0x0015, UPDATE_REGION_EEP_ECR},
+    {0xFFFF, 0xFFFF, 0xFF}};
+
+static const struct UpdateData DataD[] = {
+    {EEPROM_MAP_OPT_13, 0x6f5f, UPDATE_REGION_SERVO, UPDATE_IF_T487},
+    {EEPROM_MAP_OPT_12, 0x4d8f, UPDATE_REGION_SERVO, UPDATE_IF_T487 | UPDATE_IF_NOT_FORCED},
+    {0x002d, 0x5005, UPDATE_REGION_SERVO, UPDATE_IF_T487 | UPDATE_IF_NOT_FORCED},
+    {0x003a, 0x8080, UPDATE_REGION_SERVO, UPDATE_IF_T487 | UPDATE_IF_NOT_FORCED},
+    {EEPROM_MAP_OPT_13, 0x6f6f, UPDATE_REGION_SERVO, UPDATE_IF_T609K},
+    {EEPROM_MAP_OPT_12, 0x6b8b, UPDATE_REGION_SERVO, UPDATE_IF_T609K},
+    {0x002d, 0x1405, UPDATE_REGION_SERVO, UPDATE_IF_T609K},
+    {0x003a, 0x8060, UPDATE_REGION_SERVO, UPDATE_IF_T609K},
+    {EEPROM_MAP_CON, MECHA_CHASSIS_BCD, UPDATE_REGION_SERVO},
+    {EEPROM_MAP_ECR, 0x0013, UPDATE_REGION_EEP_ECR},
+    {0xFFFF, 0xFFFF, 0xFF}};
+
+// The T609K lens is not supported with the SANYO OP (see UpdatePrepareF).
+static const struct UpdateData DataF[] = {
+    {EEPROM_MAP_OPT_13, 0x6f6f, UPDATE_REGION_SERVO, UPDATE_IF_T487 | UPDATE_IF_SANYO},
+    {EEPROM_MAP_OPT_12, 0x6d8f, UPDATE_REGION_SERVO, UPDATE_IF_T487 | UPDATE_IF_SANYO},
+    {EEPROM_MAP_OPT_13, 0x6f4f, UPDATE_REGION_SERVO, UPDATE_IF_T487 | UPDATE_IF_SONY},
+    {EEPROM_MAP_OPT_12, 0x4d8f, UPDATE_REGION_SERVO, UPDATE_IF_T487 | UPDATE_IF_SONY},
+    {0x0027, 0x4d4d, UPDATE_REGION_SERVO, UPDATE_IF_T487},
+    {0x002d, 0x5005, UPDATE_REGION_SERVO, UPDATE_IF_T487},
+    {0x002c, 0x2424, UPDATE_REGION_SERVO, UPDATE_IF_T487},
+    {0x0044, 0x0404, UPDATE_REGION_SERVO, UPDATE_IF_T487},
+    {EEPROM_MAP_OPT_12, 0x6b8b, UPDATE_REGION_SERVO, UPDATE_IF_T609K},
+    {0x002d, 0x1405, UPDATE_REGION_SERVO, UPDATE_IF_T609K},
+    {EEPROM_MAP_OPT_13, 0x4f6f, UPDATE_REGION_SERVO, UPDATE_IF_T609K},
+    {0x0027, 0x4d9a, UPDATE_REGION_SERVO, UPDATE_IF_T609K},
+    {0x002c, 0x2324, UPDATE_REGION_SERVO, UPDATE_IF_T609K},
+    {0x0044, 0x0417, UPDATE_REGION_SERVO, UPDATE_IF_T609K},
+    {0x0008, 0x4300, UPDATE_REGION_DISCDET, UPDATE_IF_SONY | UPDATE_IF_NOT_FORCED},
+    {0x0008, 0x8800, UPDATE_REGION_DISCDET, UPDATE_IF_SANYO | UPDATE_IF_NOT_FORCED},
+    {0x002a, 0xf050, UPDATE_REGION_SERVO},
+    {0x00f9, 0xb038, UPDATE_REGION_TRAY},
+    {0x00fa, 0x0068, UPDATE_REGION_TRAY},
+    {0x0033, 0xfd03, UPDATE_REGION_SERVO},
+    {0x003a, 0x8060, UPDATE_REGION_SERVO},
+    {0x003d, 0x2213, UPDATE_REGION_SERVO},
+    {0x00fb, 0x0007, UPDATE_REGION_TRAY},
+    {EEPROM_MAP_ECR, 0xf113, UPDATE_REGION_EEP_ECR, UPDATE_IF_RICOH},
+    {EEPROM_MAP_ECR, 0xf100, UPDATE_REGION_EEP_ECR, UPDATE_IF_ROHM},
+    {0xFFFF, 0xFFFF, 0xFF}};
+
+// In EEPROM tool 2003/03/13, the newer G-chassis had no updates. In the (later) combined tool, both versions of the G-chassis share the same updates.
+static const struct UpdateData DataG[] = {
+    {0x0024, 0x3008, UPDATE_REGION_SERVO, UPDATE_IF_FORCED},
+    {0x0024, 0x0008, UPDATE_REGION_SERVO, UPDATE_IF_NOT_FORCED | UPDATE_LOW_BYTE},
+    {EEPROM_MAP_OPT_12, 0x6482, UPDATE_REGION_SERVO, UPDATE_IF_SANYO},
+    {0x0008, 0x8800, UPDATE_REGION_DISCDET, UPDATE_IF_SANYO | UPDATE_IF_NOT_FORCED},
+    {0x0031, 0x25c8, UPDATE_REGION_SERVO, UPDATE_IF_SANYO},
+    {0x004b, 0x1a1a, UPDATE_REGION_SERVO, UPDATE_IF_SANYO},
+    {0x0008, 0x4300, UPDATE_REGION_DISCDET, UPDATE_IF_SONY | UPDATE_IF_NOT_FORCED},
+    {0x0031, 0x1cc8, UPDATE_REGION_SERVO, UPDATE_IF_SONY},
+    {0x0038, 0x0808, UPDATE_REGION_SERVO},
+    {0x003e, 0x4032, UPDATE_REGION_SERVO},
+    {0x0006, 0x6a33, UPDATE_REGION_DISCDET},
+    {0x0040, 0x1039, UPDATE_REGION_SERVO},
+    {0x000e, 0xFFFF, UPDATE_REGION_SERVO},
+    {0xFFFF, 0xFFFF, 0xFF}};
+
+// Shared by the H and DEX H-chassis.
+static const struct UpdateData DataH[] = {
+    {0x0019, 0xa640, UPDATE_REGION_SERVO},
+    {0x003c, 0x703c, UPDATE_REGION_SERVO},
+    {0x006f, 0x8f8f, UPDATE_REGION_SERVO},
+    {0x007e, 0x8c8a, UPDATE_REGION_SERVO},
+    {0xFFFF, 0xFFFF, 0xFF}};
+
+static const struct UpdateData DataDexA[] = {
+    {0x0026, 0x0e0a, UPDATE_REGION_SERVO},
+    {EEPROM_MAP_ECR, 0x0019, UPDATE_REGION_EEP_ECR},
+    {EEPROM_MAP_FOK, 0xb2a0, UPDATE_REGION_SERVO},
+    {0x002e, 0x213a, UPDATE_REGION_SERVO},
+    {0x0032, 0x0a0a, UPDATE_REGION_SERVO},
+    {0x002d, 0x5005, UPDATE_REGION_SERVO},
+    {0x00f1, 0x0f38, UPDATE_REGION_TRAY},
+    {0x00f2, 0x1e47, UPDATE_REGION_TRAY},
+    {0x00f3, 0x5626, UPDATE_REGION_TRAY},
+    {0x00f4, 0x6b27, UPDATE_REGION_TRAY},
+    {0x00f9, 0x9038, UPDATE_REGION_TRAY},
+    {0x00fa, 0x0012, UPDATE_REGION_TRAY},
+    {0x00f5, 0x0029, UPDATE_REGION_TRAY},
+    {0x00f6, 0x1929, UPDATE_REGION_TRAY},
+    {0x00f7, 0x6013, UPDATE_REGION_TRAY},
+    {0x00f8, 0x7029, UPDATE_REGION_TRAY},
+    {0x0140, 0x0000, UPDATE_REGION_EEGS},
+    {0x0147, 0x0000, UPDATE_REGION_EEGS},
+    {0x00fb, 0x0002, UPDATE_REGION_TRAY},
+    {0xFFFF, 0xFFFF, 0xFF}};
+
+static const struct UpdateData DataDexA2[] = {
+    {EEPROM_MAP_ECR, 0x0019, UPDATE_REGION_EEP_ECR},
+    {0x00f1, 0x0f38, UPDATE_REGION_TRAY},
+    {0x00f2, 0x1e47, UPDATE_REGION_TRAY},
+    {0x00f3, 0x5626, UPDATE_REGION_TRAY},
+    {0x00f4, 0x6b27, UPDATE_REGION_TRAY},
+    {0x00f9, 0x9038, UPDATE_REGION_TRAY},
+    {0x00f5, 0x0029, UPDATE_REGION_TRAY},
+    {0x00f6, 0x1929, UPDATE_REGION_TRAY},
+    {0x00f7, 0x6013, UPDATE_REGION_TRAY},
+    {0x00f8, 0x7029, UPDATE_REGION_TRAY},
+    {0xFFFF, 0xFFFF, 0xFF}};
+
+static const struct UpdateData DataDexA3[] = {
+    {EEPROM_MAP_ECR, 0x0019, UPDATE_REGION_EEP_ECR},
+    {EEPROM_MAP_FOK, 0xb2a0, UPDATE_REGION_SERVO},
+    {0x002e, 0x213a, UPDATE_REGION_SERVO},
+    {0x0032, 0x0a0a, UPDATE_REGION_SERVO},
+    {0x002d, 0x5005, UPDATE_REGION_SERVO},
+    {0x00f1, 0x0f38, UPDATE_REGION_TRAY},
+    {0x00f2, 0x1e47, UPDATE_REGION_TRAY},
+    {0x00f3, 0x5626, UPDATE_REGION_TRAY},
+    {0x00f4, 0x6b27, UPDATE_REGION_TRAY},
+    {0x00f9, 0x9038, UPDATE_REGION_TRAY},
+    {0x00fa, 0x0012, UPDATE_REGION_TRAY},
+    {0x00f5, 0x0029, UPDATE_REGION_TRAY},
+    {0x00f6, 0x1929, UPDATE_REGION_TRAY},
+    {0x00f7, 0x6013, UPDATE_REGION_TRAY},
+    {0x00f8, 0x7029, UPDATE_REGION_TRAY},
+    {0xFFFF, 0xFFFF, 0xFF}};
+
+static const struct UpdateData DataDexB[] = {
+    {EEPROM_MAP_CON, MECHA_CHASSIS_DEX_B, UPDATE_REGION_SERVO},
+    {0x0026, 0x0e06, UPDATE_REGION_SERVO},
+    {EEPROM_MAP_ECR, 0x0015, UPDATE_REGION_EEP_ECR},
+    {0x00c0, 0x003e, UPDATE_REGION_TILT},
+    {0x00c1, 0x1430, UPDATE_REGION_TILT},
+    {0x00c2, 0x1167, UPDATE_REGION_TILT},
+    {0x00c3, 0x012c, UPDATE_REGION_TILT},
+    {0x00c4, 0x2805, UPDATE_REGION_TILT},
+    {0x0140, 0x0001, UPDATE_REGION_EEGS},
+    {0x0147, 0x0100, UPDATE_REGION_EEGS},
+    {0xFFFF, 0xFFFF, 0xFF}};
+
+static const struct UpdateData DataDexD[] = {
+    {EEPROM_MAP_OPT_13, 0x6f5f, UPDATE_REGION_SERVO},
+    {EEPROM_MAP_ECR, 0x0013, UPDATE_REGION_EEP_ECR},
+    {0x0140, 0x0001, UPDATE_REGION_EEGS},
+    {0x0147, 0x0100, UPDATE_REGION_EEGS},
+    {0xFFFF, 0xFFFF, 0xFF}};
+
+// Indexed by MECHA_CHASSIS_MODEL
+static const struct UpdateProfile UpdateProfiles[MECHA_CHASSIS_MODEL_COUNT] = {
+    {DefaultsA, DataCex10000, UPDATE_PROFILE_FORCE_LENS | UPDATE_PROFILE_NO_OSD2, UPDATE_RTC_RICOH, 0x19, NULL, NULL, NULL},
+    {DefaultsStd, DataA, UPDATE_PROFILE_FORCE_LENS, UPDATE_RTC_RICOH, 0x19, NULL, NULL, NULL},
+    {DefaultsStd, DataAB, UPDATE_PROFILE_FORCE_LENS | UPDATE_PROFILE_FORCE_OPT13, UPDATE_RTC_RICOH, 0x19, NULL, &UpdateFixupAB, NULL},
+    {DefaultsB, DataB, UPDATE_PROFILE_FORCE_LENS | UPDATE_PROFILE_FORCE_OPT13, UPDATE_RTC_RICOH, 0x15, NULL, &UpdateFixupBC, NULL},
+    {DefaultsStd, DataC, UPDATE_PROFILE_FORCE_LENS | UPDATE_PROFILE_FORCE_OPT13, UPDATE_RTC_RICOH, 0x15, NULL, &UpdateFixupBC, NULL},
+    {DefaultsStd, DataD, UPDATE_PROFILE_FORCE_LENS, UPDATE_RTC_RICOH, 0x13, &UpdatePrepareD, &UpdateFixupD, NULL},
+    {DefaultsF, DataF, UPDATE_PROFILE_FORCE_LENS | UPDATE_PROFILE_FORCE_OP, UPDATE_RTC_AUTO, 0x13, &UpdatePrepareF, NULL, NULL},
+    {DefaultsG, DataG, UPDATE_PROFILE_FORCE_OP, UPDATE_RTC_ROHM, 0x00, &UpdatePrepareG, NULL, NULL},
+    {DefaultsH, DataH, UPDATE_PROFILE_FORCE_LENS, UPDATE_RTC_ROHM, 0x00, NULL, NULL, &UpdatePostH},
+    {DefaultsA, DataDexA, UPDATE_PROFILE_FORCE_LENS | UPDATE_PROFILE_NO_OSD2, UPDATE_RTC_RICOH, 0x19, NULL, NULL, NULL},
+    {DefaultsA, DataDexA2, UPDATE_PROFILE_FORCE_LENS | UPDATE_PROFILE_NO_OSD2, UPDATE_RTC_RICOH, 0x19, NULL, NULL, NULL},
+    {DefaultsA, DataDexA3, UPDATE_PROFILE_FORCE_LENS | UPDATE_PROFILE_NO_OSD2, UPDATE_RTC_RICOH, 0x19, NULL, NULL, NULL},
+    {DefaultsB, DataDexB, UPDATE_PROFILE_FORCE_LENS, UPDATE_RTC_RICOH, 0x15, NULL, NULL, NULL},
+    {DefaultsStd, DataDexD, UPDATE_PROFILE_FORCE_LENS, UPDATE_RTC_RICOH, 0x13, NULL, NULL, NULL},
+    {DefaultsH, DataH, UPDATE_PROFILE_FORCE_LENS, UPDATE_RTC_ROHM, 0x00, NULL, NULL, &UpdatePostDexH}};
+
+int MechaUpdateChassis(int chassis, int ClearOSD2InitBit, int ReplacedMecha, int lens, int opt)
+{
+    if (chassis < 0 || chassis >= MECHA_CHASSIS_MODEL_COUNT)
+        return -EINVAL;
 
-    return UpdateStat;
+    return MechaUpdateRun(&UpdateProfiles[chassis], ClearOSD2InitBit, ReplacedMecha, lens, opt);
 }
@@ -19,20 +19,5 @@
 #define UPDATE_REGION_RTC_TIME  0x0200
 #define UPDATE_REGION_DEFAULTS  0x0800
 
-// Update functions
-int MechaUpdateChassisCex10000(int ClearOSD2InitBit, int ReplacedMecha, int lens, int opt);
-int MechaUpdateChassisA(int ClearOSD2InitBit, int ReplacedMecha, int lens, int opt);
-int MechaUpdateChassisAB(int ClearOSD2InitBit, int ReplacedMecha, int lens, int opt);
-int MechaUpdateChassisB(int ClearOSD2InitBit, int ReplacedMecha, int lens, int opt);
-int MechaUpdateChassisC(int ClearOSD2InitBit, int ReplacedMecha, int lens, int opt);
-int MechaUpdateChassisD(int ClearOSD2InitBit, int ReplacedMecha, int lens, int opt);
-int MechaUpdateChassisF(int ClearOSD2InitBit, int ReplacedMecha, int lens, int opt);
-int MechaUpdateChassisG(int ClearOSD2InitBit, int ReplacedMecha, int lens, int opt);
-int MechaUpdateChassisDexA(int ClearOSD2InitBit, int ReplacedMecha, int lens, int opt);
-int MechaUpdateChassisDexA2(int ClearOSD2InitBit, int ReplacedMecha, int lens, int opt);
-int MechaUpdateChassisDexA3(int ClearOSD2InitBit, int ReplacedMecha, int lens, int opt);
-int MechaUpdateChassisDexB(int ClearOSD2InitBit, int ReplacedMecha, int lens, int opt);
-int MechaUpdateChassisDexD(int ClearOSD2InitBit, int ReplacedMecha, int lens, int opt);
-
-int MechaUpdateChassisH(int ClearOSD2InitBit, int ReplacedMecha, int lens, int opt);
-int MechaUpdateChassisDexH(int ClearOSD2InitBit, int ReplacedMecha, int lens, int opt);
+// Update function. Returns the updated regions (UPDATE_REGION_*), or a negative value on error.
+int MechaUpdateChassis(int chassis, int ClearOSD2InitBit, int ReplacedMecha, int lens, int opt);